@@ -0,0 +1,157 @@
+#include "ApiProfiler.hpp"
+
+#include <algorithm>
+#include <cstdio>
+#include <vector>
+
+namespace ApiProfiler {
+
+static const char* NoOperation = "(без операции)";
+
+// Места вызова регистрируются при первом проходе (статические объекты в API_CALL)
+static std::atomic<CallSite*> s_sites { nullptr };
+static thread_local const char* s_operation = nullptr;
+
+CallSite::CallSite (const char* function, const char* file, Int32 line) :
+    function (function),
+    file (file),
+    line (line)
+{
+    CallSite* head = s_sites.load (std::memory_order_relaxed);
+    do {
+        next = head;
+    } while (!s_sites.compare_exchange_weak (head, this, std::memory_order_release, std::memory_order_relaxed));
+}
+
+const char* CurrentOperation ()
+{
+    return s_operation != nullptr ? s_operation : NoOperation;
+}
+
+// ---------------- Учёт вызова ----------------
+void Record (CallSite& site, UInt64 elapsedNs)
+{
+    const char* operation = CurrentOperation ();
+
+    // Имена операций — строковые литералы, сравниваем указатели.
+    // Вызовы API идут из главного потока, поэтому свободную запись занимаем без блокировки
+    OperationCounter* counter = &site.counters[MaxOperationsPerSite - 1];
+    for (UInt32 i = 0; i < MaxOperationsPerSite; ++i) {
+        OperationCounter& candidate = site.counters[i];
+        const char* current = candidate.operation;
+        if (current == operation) {
+            counter = &candidate;
+            break;
+        }
+        if (current == nullptr) {
+            candidate.operation = operation;
+            counter = &candidate;
+            break;
+        }
+    }
+
+    counter->calls.fetch_add (1, std::memory_order_relaxed);
+    counter->totalNs.fetch_add (elapsedNs, std::memory_order_relaxed);
+}
+
+OperationScope::OperationScope (const char* operation) :
+    previous (s_operation)
+{
+    s_operation = operation;
+}
+
+OperationScope::~OperationScope ()
+{
+    s_operation = previous;
+}
+
+bool IsCompiledIn ()
+{
+#ifdef TOLAYOUT_API_PROFILE
+    return true;
+#else
+    return false;
+#endif
+}
+
+// ---------------- Отчёт ----------------
+struct ReportRow {
+    const CallSite* site;
+    const char*     operation;
+    UInt64          calls;
+    UInt64          totalNs;
+};
+
+static const char* BaseName (const char* path)
+{
+    const char* name = path;
+    for (const char* p = path; *p != '\0'; ++p) {
+        if (*p == '/' || *p == '\\')
+            name = p + 1;
+    }
+    return name;
+}
+
+void PrintReport ()
+{
+    if (!IsCompiledIn ()) {
+        ACAPI_WriteReport ("[ApiProfiler] Профилировщик не включён в сборку (TOLAYOUT_API_PROFILE).", false);
+        return;
+    }
+
+    std::vector<ReportRow> rows;
+    for (const CallSite* site = s_sites.load (std::memory_order_acquire); site != nullptr; site = site->next) {
+        for (UInt32 i = 0; i < MaxOperationsPerSite; ++i) {
+            const OperationCounter& counter = site->counters[i];
+            const UInt64 calls = counter.calls.load (std::memory_order_relaxed);
+            if (counter.operation == nullptr || calls == 0)
+                continue;
+            rows.push_back ({ site, counter.operation, calls, counter.totalNs.load (std::memory_order_relaxed) });
+        }
+    }
+
+    std::sort (rows.begin (), rows.end (), [] (const ReportRow& a, const ReportRow& b) { return a.totalNs > b.totalNs; });
+
+    // Итоги по операциям
+    std::vector<ReportRow> totals;
+    for (const ReportRow& row : rows) {
+        auto it = std::find_if (totals.begin (), totals.end (), [&] (const ReportRow& t) { return t.operation == row.operation; });
+        if (it == totals.end ())
+            totals.push_back ({ nullptr, row.operation, row.calls, row.totalNs });
+        else {
+            it->calls += row.calls;
+            it->totalNs += row.totalNs;
+        }
+    }
+    std::sort (totals.begin (), totals.end (), [] (const ReportRow& a, const ReportRow& b) { return a.totalNs > b.totalNs; });
+
+    char line[512];
+    ACAPI_WriteReport ("[ApiProfiler] ---- Операции ----", false);
+    for (const ReportRow& t : totals) {
+        std::snprintf (line, sizeof (line), "%10.2f ms %8llu calls  %s",
+            static_cast<double> (t.totalNs) / 1.0e6, static_cast<unsigned long long> (t.calls), t.operation);
+        ACAPI_WriteReport ("%s", false, line);
+    }
+
+    ACAPI_WriteReport ("[ApiProfiler] ---- Места вызова (по суммарному времени) ----", false);
+    for (const ReportRow& row : rows) {
+        std::snprintf (line, sizeof (line), "%10.2f ms %8llu calls %8.1f us/call  %s  [%s]  %s:%d",
+            static_cast<double> (row.totalNs) / 1.0e6,
+            static_cast<unsigned long long> (row.calls),
+            static_cast<double> (row.totalNs) / 1.0e3 / static_cast<double> (row.calls),
+            row.site->function, row.operation, BaseName (row.site->file), static_cast<int> (row.site->line));
+        ACAPI_WriteReport ("%s", false, line);
+    }
+}
+
+void Reset ()
+{
+    for (CallSite* site = s_sites.load (std::memory_order_acquire); site != nullptr; site = site->next) {
+        for (UInt32 i = 0; i < MaxOperationsPerSite; ++i) {
+            site->counters[i].calls.store (0, std::memory_order_relaxed);
+            site->counters[i].totalNs.store (0, std::memory_order_relaxed);
+        }
+    }
+}
+
+} // namespace ApiProfiler
@@ -0,0 +1,124 @@
+#ifndef APIPROFILER_HPP
+#define APIPROFILER_HPP
+
+#include "APIEnvir.h"
+#include "ACAPinc.h"
+#include "GSRoot.hpp"
+
+#include <atomic>
+#include <chrono>
+
+// Профилировщик вызовов Archicad API. Включается при сборке (-DTOLAYOUT_API_PROFILE,
+// опция CMake TOLAYOUT_API_PROFILE); без неё API_CALL раскрывается в прямой вызов.
+//
+//   API_OPERATION ("placement");                          // операция до конца области
+//   if (API_CALL (ACAPI_Element_Get, &element) != NoError) // учёт по месту вызова
+//
+// Для каждого места вызова копятся число вызовов и суммарное время отдельно по
+// объемлющей операции; PrintReport выводит рейтинг в окно отчёта сессии.
+// Через тот же макрос вызовы записываются и воспроизводятся (ApiRecorder.hpp).
+namespace ApiProfiler {
+
+    // Операций на одно место вызова; остальные попадают в последнюю запись
+    const UInt32 MaxOperationsPerSite = 8;
+
+    struct OperationCounter {
+        const char*           operation = nullptr;
+        std::atomic<UInt64>   calls { 0 };
+        std::atomic<UInt64>   totalNs { 0 };
+    };
+
+    struct CallSite {
+        const char*         function;
+        const char*         file;
+        Int32               line;
+        CallSite*           next = nullptr;
+        OperationCounter    counters[MaxOperationsPerSite];
+
+        CallSite (const char* function, const char* file, Int32 line);
+    };
+
+    // Текущая операция потока ("(без операции)", если не задана)
+    const char* CurrentOperation ();
+
+    void Record (CallSite& site, UInt64 elapsedNs);
+
+    class CallTimer {
+    public:
+        explicit CallTimer (CallSite& site) : site (site), start (std::chrono::steady_clock::now ()) {}
+        ~CallTimer ()
+        {
+            Record (site, static_cast<UInt64> (std::chrono::duration_cast<std::chrono::nanoseconds> (std::chrono::steady_clock::now () - start).count ()));
+        }
+
+        CallTimer (const CallTimer&) = delete;
+        CallTimer& operator= (const CallTimer&) = delete;
+
+    private:
+        CallSite&                               site;
+        std::chrono::steady_clock::time_point   start;
+    };
+
+    class OperationScope {
+    public:
+        explicit OperationScope (const char* operation);
+        ~OperationScope ();
+
+        OperationScope (const OperationScope&) = delete;
+        OperationScope& operator= (const OperationScope&) = delete;
+
+    private:
+        const char* previous;
+    };
+
+    // Собран ли профилировщик в этой сборке
+    bool IsCompiledIn ();
+
+    // Рейтинг мест вызова по суммарному времени + итоги по операциям (ACAPI_WriteReport)
+    void PrintReport ();
+    void Reset ();
+
+} // namespace ApiProfiler
+
+#if defined (TOLAYOUT_API_REPLAY)
+    // Воспроизведение записи (ApiRecorder): Archicad не вызывается
+    #include "ApiRecorder.hpp"
+    #define API_CALL(fn, ...) \
+        ([&] () { \
+            static ApiRecorder::ReplaySite apiReplaySite_ (#fn); \
+            return ApiRecorder::Replay (apiReplaySite_, __VA_ARGS__); \
+        } ())
+    #define API_OPERATION(name) ((void) 0)
+#elif defined (TOLAYOUT_API_STANDIN)
+    // Синтетический проект (Tools/SyntheticProject): вызовы идут в ApiStandIn::<функция>
+    #include "ApiStandIn.hpp"
+    #define API_CALL(fn, ...) ApiStandIn::fn (__VA_ARGS__)
+    #define API_OPERATION(name) ((void) 0)
+#elif defined (TOLAYOUT_API_PROFILE)
+    #ifdef TOLAYOUT_API_RECORD
+        #include "ApiRecorder.hpp"
+        #define API_CALL_INVOKE_(fn, ...) \
+            if (!ApiRecorder::IsRecording ()) \
+                return fn (__VA_ARGS__); \
+            const std::uint64_t apiInputHash_ = ApiRecorder::HashInputs (__VA_ARGS__); \
+            const std::chrono::steady_clock::time_point apiRecordStart_ = std::chrono::steady_clock::now (); \
+            const GSErrCode apiResult_ = fn (__VA_ARGS__); \
+            ApiRecorder::Record (#fn, apiInputHash_, apiResult_, static_cast<UInt64> (std::chrono::duration_cast<std::chrono::microseconds> ( \
+                std::chrono::steady_clock::now () - apiRecordStart_).count ()), __VA_ARGS__); \
+            return apiResult_;
+    #else
+        #define API_CALL_INVOKE_(fn, ...) return fn (__VA_ARGS__);
+    #endif
+    #define API_CALL(fn, ...) \
+        ([&] () -> GSErrCode { \
+            static ApiProfiler::CallSite apiCallSite_ (#fn, __FILE__, __LINE__); \
+            ApiProfiler::CallTimer apiCallTimer_ (apiCallSite_); \
+            API_CALL_INVOKE_ (fn, __VA_ARGS__) \
+        } ())
+    #define API_OPERATION(name) ApiProfiler::OperationScope apiOperationScope_ (name)
+#else
+    #define API_CALL(fn, ...) fn (__VA_ARGS__)
+    #define API_OPERATION(name) ((void) 0)
+#endif
+
+#endif // APIPROFILER_HPP
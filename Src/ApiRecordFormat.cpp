@@ -0,0 +1,195 @@
+#include "ApiRecordFormat.hpp"
+
+#include <cstring>
+#include <utility>
+
+namespace ApiRecordFormat {
+
+// ---------------- Запись ----------------
+Writer::~Writer ()
+{
+    Close ();
+}
+
+bool Writer::Open (const char* utf8Path)
+{
+    Close ();
+    file = std::fopen (utf8Path, "wb");
+    return WriteHeader ();
+}
+
+#ifdef _WIN32
+bool Writer::Open (const wchar_t* path)
+{
+    Close ();
+    file = _wfopen (path, L"wb");
+    return WriteHeader ();
+}
+#endif
+
+bool Writer::WriteHeader ()
+{
+    if (file == nullptr)
+        return false;
+    ids.clear ();
+    callCount = 0;
+    Put (Magic, sizeof (Magic));
+    Put (&Version, sizeof (Version));
+    return true;
+}
+
+void Writer::Close ()
+{
+    if (file != nullptr) {
+        std::fclose (file);
+        file = nullptr;
+    }
+}
+
+void Writer::Put (const void* data, std::size_t size)
+{
+    if (size > 0)
+        std::fwrite (data, 1, size, file);
+}
+
+std::uint16_t Writer::FunctionId (const char* name)
+{
+    auto it = ids.find (name);
+    if (it != ids.end ())
+        return it->second;
+
+    const std::uint16_t id = static_cast<std::uint16_t> (ids.size ());
+    ids.emplace (name, id);
+
+    const std::uint8_t kind = static_cast<std::uint8_t> (RecordKind::Name);
+    const std::uint16_t length = static_cast<std::uint16_t> (std::strlen (name));
+    Put (&kind, sizeof (kind));
+    Put (&id, sizeof (id));
+    Put (&length, sizeof (length));
+    Put (name, length);
+    return id;
+}
+
+void Writer::WriteCall (const CallRecord& call)
+{
+    const std::uint8_t kind = static_cast<std::uint8_t> (RecordKind::Call);
+    const std::uint8_t argCount = static_cast<std::uint8_t> (call.args.size ());
+    Put (&kind, sizeof (kind));
+    Put (&call.function, sizeof (call.function));
+    Put (&call.inputHash, sizeof (call.inputHash));
+    Put (&call.result, sizeof (call.result));
+    Put (&call.elapsedUs, sizeof (call.elapsedUs));
+    Put (&argCount, sizeof (argCount));
+
+    for (const ArgBlob& arg : call.args) {
+        const std::uint8_t argKind = static_cast<std::uint8_t> (arg.kind);
+        Put (&argKind, sizeof (argKind));
+        if (arg.kind == ArgKind::Skipped)
+            continue;
+        if (arg.kind == ArgKind::Array) {
+            Put (&arg.count, sizeof (arg.count));
+            Put (&arg.itemSize, sizeof (arg.itemSize));
+        } else {
+            const std::uint32_t size = static_cast<std::uint32_t> (arg.data.size ());
+            Put (&size, sizeof (size));
+        }
+        Put (arg.data.data (), arg.data.size ());
+    }
+    ++callCount;
+}
+
+// ---------------- Чтение ----------------
+namespace {
+
+class Input {
+public:
+    explicit Input (std::FILE* file) : file (file) {}
+
+    template <typename T>
+    bool Get (T& value) { return Get (&value, sizeof (T)); }
+
+    bool Get (void* data, std::size_t size)
+    {
+        return size == 0 || std::fread (data, 1, size, file) == size;
+    }
+
+private:
+    std::FILE* file;
+};
+
+bool Fail (std::string* error, const char* message)
+{
+    if (error != nullptr)
+        *error = message;
+    return false;
+}
+
+} // namespace
+
+bool Read (const char* utf8Path, Recording& out, std::string* error)
+{
+    out.functions.clear ();
+    out.calls.clear ();
+
+    std::FILE* file = std::fopen (utf8Path, "rb");
+    if (file == nullptr)
+        return Fail (error, "cannot open file");
+
+    struct Closer { std::FILE* f; ~Closer () { std::fclose (f); } } closer { file };
+    Input in (file);
+
+    char magic[4] = {};
+    std::uint32_t version = 0;
+    if (!in.Get (magic, sizeof (magic)) || std::memcmp (magic, Magic, sizeof (Magic)) != 0 || !in.Get (version))
+        return Fail (error, "not an API recording");
+    if (version != Version)
+        return Fail (error, "unsupported recording version (re-record with this build)");
+
+    std::uint8_t kind = 0;
+    while (in.Get (kind)) {
+        if (kind == static_cast<std::uint8_t> (RecordKind::Name)) {
+            std::uint16_t id = 0;
+            std::uint16_t length = 0;
+            if (!in.Get (id) || !in.Get (length))
+                return Fail (error, "truncated name record");
+            std::string name (length, '\0');
+            if (!in.Get (&name[0], length))
+                return Fail (error, "truncated name record");
+            if (out.functions.size () <= id)
+                out.functions.resize (static_cast<std::size_t> (id) + 1);
+            out.functions[id] = name;
+        } else if (kind == static_cast<std::uint8_t> (RecordKind::Call)) {
+            CallRecord call;
+            std::uint8_t argCount = 0;
+            if (!in.Get (call.function) || !in.Get (call.inputHash) || !in.Get (call.result) || !in.Get (call.elapsedUs) || !in.Get (argCount))
+                return Fail (error, "truncated call record");
+            call.args.resize (argCount);
+            for (ArgBlob& arg : call.args) {
+                std::uint8_t argKind = 0;
+                if (!in.Get (argKind))
+                    return Fail (error, "truncated argument");
+                arg.kind = static_cast<ArgKind> (argKind);
+                if (arg.kind == ArgKind::Skipped)
+                    continue;
+
+                std::uint32_t size = 0;
+                if (arg.kind == ArgKind::Array) {
+                    if (!in.Get (arg.count) || !in.Get (arg.itemSize))
+                        return Fail (error, "truncated argument");
+                    size = arg.count * arg.itemSize;
+                } else if (!in.Get (size)) {
+                    return Fail (error, "truncated argument");
+                }
+                arg.data.resize (size);
+                if (!in.Get (arg.data.data (), size))
+                    return Fail (error, "truncated argument");
+            }
+            out.calls.push_back (std::move (call));
+        } else {
+            return Fail (error, "unknown record kind");
+        }
+    }
+    return true;
+}
+
+} // namespace ApiRecordFormat
@@ -0,0 +1,90 @@
+#ifndef APIRECORDFORMAT_HPP
+#define APIRECORDFORMAT_HPP
+
+#include <cstdint>
+#include <cstdio>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+// Двоичный формат записи вызовов Archicad API (ApiRecorder). Без зависимостей от DevKit,
+// чтобы файл читался утилитами на любой машине (Tools/ApiReplay).
+//
+//   Заголовок:  "TLRC" + uint32 версия
+//   Name:       uint8 1, uint16 id, uint16 длина, UTF-8 имя функции   (при первом вызове функции)
+//   Call:       uint8 2, uint16 id, uint64 хэш входа, int32 код ошибки, uint32 мкс, uint8 число аргументов, аргументы
+//   Аргумент:   uint8 вид; для Bytes/String — uint32 размер + данные;
+//               для Array — uint32 число элементов, uint32 размер элемента + данные
+//
+// Все числа — little-endian, как в памяти на x86/ARM.
+namespace ApiRecordFormat {
+
+    const char          Magic[4] = { 'T', 'L', 'R', 'C' };
+    const std::uint32_t Version = 2;     // 2: хэш входных аргументов в записи Call
+
+    enum class RecordKind : std::uint8_t { Name = 1, Call = 2 };
+
+    enum class ArgKind : std::uint8_t {
+        Skipped = 0,    // входной/константный аргумент, nullptr или тип без кодека
+        Bytes   = 1,    // тривиально копируемая структура
+        Array   = 2,    // GS::Array тривиально копируемых элементов
+        String  = 3     // GS::UniString в UTF-8
+    };
+
+    struct ArgBlob {
+        ArgKind                     kind = ArgKind::Skipped;
+        std::uint32_t               count = 0;      // только для Array
+        std::uint32_t               itemSize = 0;   // только для Array
+        std::vector<unsigned char>  data;
+    };
+
+    struct CallRecord {
+        std::uint16_t           function = 0;
+        std::uint64_t           inputHash = 0;  // входные аргументы до вызова (ApiRecorder::HashInputs)
+        std::int32_t            result = 0;
+        std::uint32_t           elapsedUs = 0;
+        std::vector<ArgBlob>    args;
+    };
+
+    // Запись в файл; имена функций получают id при первой встрече
+    class Writer {
+    public:
+        Writer () = default;
+        ~Writer ();
+
+        Writer (const Writer&) = delete;
+        Writer& operator= (const Writer&) = delete;
+
+        bool Open (const char* utf8Path);
+#ifdef _WIN32
+        bool Open (const wchar_t* path);
+#endif
+        void Close ();
+        bool IsOpen () const { return file != nullptr; }
+
+        // Возвращает id функции, при необходимости пишет запись Name
+        std::uint16_t FunctionId (const char* name);
+        void WriteCall (const CallRecord& call);
+
+        std::uint64_t GetCallCount () const { return callCount; }
+
+    private:
+        bool WriteHeader ();
+        void Put (const void* data, std::size_t size);
+
+        std::FILE*                                          file = nullptr;
+        std::unordered_map<std::string, std::uint16_t>     ids;
+        std::uint64_t                                       callCount = 0;
+    };
+
+    struct Recording {
+        std::vector<std::string>    functions;      // по id
+        std::vector<CallRecord>     calls;          // в порядке записи
+    };
+
+    // Чтение файла целиком. false — файл не найден или повреждён (прочитанное остаётся в out)
+    bool Read (const char* utf8Path, Recording& out, std::string* error = nullptr);
+
+} // namespace ApiRecordFormat
+
+#endif // APIRECORDFORMAT_HPP
@@ -0,0 +1,137 @@
+#include "ApiRecorder.hpp"
+#include "Logger.hpp"
+
+#include <atomic>
+#include <mutex>
+#include <unordered_map>
+
+namespace ApiRecorder {
+
+// ---------------- Запись ----------------
+static std::mutex                   s_writerMutex;
+static ApiRecordFormat::Writer      s_writer;
+static std::atomic<bool>            s_recording { false };
+
+bool IsCompiledIn ()
+{
+#ifdef TOLAYOUT_API_RECORD
+    return true;
+#else
+    return false;
+#endif
+}
+
+bool Start (const GS::UniString& filePath)
+{
+    std::lock_guard<std::mutex> lock (s_writerMutex);
+#ifdef GS_WIN
+    const bool opened = s_writer.Open (reinterpret_cast<const wchar_t*> (filePath.ToUStr ().Get ()));
+#else
+    const bool opened = s_writer.Open (filePath.ToCStr (CC_UTF8).Get ());
+#endif
+    s_recording.store (opened, std::memory_order_relaxed);
+    return opened;
+}
+
+void Stop ()
+{
+    std::lock_guard<std::mutex> lock (s_writerMutex);
+    s_recording.store (false, std::memory_order_relaxed);
+    s_writer.Close ();
+}
+
+bool IsRecording ()
+{
+    return s_recording.load (std::memory_order_relaxed);
+}
+
+UInt64 GetRecordedCallCount ()
+{
+    std::lock_guard<std::mutex> lock (s_writerMutex);
+    return s_writer.GetCallCount ();
+}
+
+void Detail::WriteCall (const char* function, ApiRecordFormat::CallRecord& call)
+{
+    std::lock_guard<std::mutex> lock (s_writerMutex);
+    if (!s_writer.IsOpen ())
+        return;
+    call.function = s_writer.FunctionId (function);
+    s_writer.WriteCall (call);
+}
+
+// ---------------- Воспроизведение ----------------
+struct InputQueue {
+    std::vector<const ApiRecordFormat::CallRecord*>    calls;
+    std::size_t                                         cursor = 0;
+};
+
+// Вызовы функции, разложенные по хэшу входных аргументов
+struct FunctionCalls {
+    std::unordered_map<std::uint64_t, InputQueue>      byInput;
+};
+
+static ApiRecordFormat::Recording                       s_replay;
+static std::unordered_map<std::string, FunctionCalls>   s_functions;
+static UInt32                                           s_generation = 0;
+static ReplayStats                                      s_replayStats;
+
+bool LoadReplay (const char* utf8Path, std::string* error)
+{
+    s_functions.clear ();
+    ++s_generation;
+    s_replayStats = ReplayStats ();
+
+    const bool ok = ApiRecordFormat::Read (utf8Path, s_replay, error);
+    for (const ApiRecordFormat::CallRecord& call : s_replay.calls) {
+        if (call.function < s_replay.functions.size ())
+            s_functions[s_replay.functions[call.function]].byInput[call.inputHash].calls.push_back (&call);
+    }
+    return ok;
+}
+
+void RewindReplay ()
+{
+    for (auto& function : s_functions) {
+        for (auto& input : function.second.byInput)
+            input.second.cursor = 0;
+    }
+}
+
+ReplayStats GetReplayStats ()
+{
+    return s_replayStats;
+}
+
+// Вызовы с одинаковым входом идут по кругу: повторные прогоны сценария видят те же данные.
+// Порядок вызовов разных функций и с разными аргументами на ответ не влияет
+const ApiRecordFormat::CallRecord* Detail::NextReplayCall (ReplaySite& site, std::uint64_t inputHash)
+{
+    if (site.generation != s_generation) {
+        auto it = s_functions.find (site.function);
+        site.queue = (it != s_functions.end ()) ? &it->second : nullptr;
+        site.generation = s_generation;
+    }
+
+    FunctionCalls* function = static_cast<FunctionCalls*> (site.queue);
+    if (function == nullptr) {
+        ++s_replayStats.misses;
+        return nullptr;
+    }
+
+    auto it = function->byInput.find (inputHash);
+    if (it == function->byInput.end () || it->second.calls.empty ()) {
+        ++s_replayStats.mismatches;
+        LOG_ERROR ("[ApiReplay] %s: в записи нет вызова с такими входными аргументами (хэш %016llx)",
+            site.function, static_cast<unsigned long long> (inputHash));
+        return nullptr;
+    }
+
+    InputQueue& queue = it->second;
+    ++s_replayStats.calls;
+    const ApiRecordFormat::CallRecord* call = queue.calls[queue.cursor % queue.calls.size ()];
+    ++queue.cursor;
+    return call;
+}
+
+} // namespace ApiRecorder
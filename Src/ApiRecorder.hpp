@@ -0,0 +1,403 @@
+#ifndef APIRECORDER_HPP
+#define APIRECORDER_HPP
+
+#include "APIEnvir.h"
+#include "ACAPinc.h"
+#include "GSRoot.hpp"
+#include "ApiRecordFormat.hpp"
+
+#include <cstring>
+#include <string>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+// Запись вызовов Archicad API для воспроизведения вне Archicad (Tools/ApiReplay).
+//
+// Сборка с TOLAYOUT_API_RECORD: каждый API_CALL во время записи (Start/Stop) пишет имя функции,
+// код ошибки, время и значения изменяемых аргументов после вызова — неконстантных указателей
+// и неконстантных ссылок. Сборка с TOLAYOUT_API_REPLAY: API_CALL не вызывает Archicad, а берёт
+// записанный вызов той же функции с тем же хэшем входных аргументов (HashInputs) и копирует
+// сохранённые значения в аргументы. Вызова с таким входом в записи нет — ошибка, а не чужие данные.
+//
+// Записываются тривиально копируемые структуры, GS::Array из них и GS::UniString.
+// Остальные типы (мемо элементов, определения атрибутов, массивы свойств) пропускаются —
+// при воспроизведении они остаются такими, какими их передал вызывающий код.
+namespace ApiRecorder {
+
+    // ---- Запись ----
+    bool IsCompiledIn ();
+    bool Start (const GS::UniString& filePath);
+    void Stop ();
+    bool IsRecording ();
+    UInt64 GetRecordedCallCount ();
+
+    // ---- Воспроизведение ----
+    bool LoadReplay (const char* utf8Path, std::string* error = nullptr);
+    void RewindReplay ();      // каждая функция снова начинает с первого записанного вызова
+
+    struct ReplayStats {
+        UInt64  calls = 0;
+        UInt64  misses = 0;     // функция не встречается в записи
+        UInt64  mismatches = 0; // функция есть, но не с такими входными аргументами
+    };
+    ReplayStats GetReplayStats ();
+
+    // Место вызова в режиме воспроизведения: очередь вызовов функции ищется один раз
+    struct ReplaySite {
+        const char* function;
+        void*       queue = nullptr;
+        UInt32      generation = 0;
+
+        explicit ReplaySite (const char* function) : function (function) {}
+    };
+
+    namespace Detail {
+
+        using ApiRecordFormat::ArgBlob;
+        using ApiRecordFormat::ArgKind;
+
+        // Строка ToCStr живёт до конца выражения — копируем в том же выражении
+        inline void AppendUtf8 (std::vector<unsigned char>& data, const char* utf8)
+        {
+            data.insert (data.end (), utf8, utf8 + std::strlen (utf8));
+        }
+
+        // Кодек по умолчанию: байты структуры как есть
+        template <typename T>
+        struct RawCodec {
+            static constexpr bool Recordable = std::is_trivially_copyable<T>::value;
+
+            static void Save (const T& value, ArgBlob& blob)
+            {
+                blob.kind = ArgKind::Bytes;
+                blob.data.resize (sizeof (T));
+                std::memcpy (blob.data.data (), &value, sizeof (T));
+            }
+
+            static bool Load (const ArgBlob& blob, T& value)
+            {
+                if (blob.kind != ArgKind::Bytes || blob.data.size () < sizeof (T))
+                    return false;
+                std::memcpy (&value, blob.data.data (), sizeof (T));
+                return true;
+            }
+        };
+
+        template <typename T>
+        struct Codec : RawCodec<T> {};
+
+        // Хэндлы и указатели внутри структур в записи недействительны — не записываем
+        template <> struct Codec<API_ElementMemo>     { static constexpr bool Recordable = false; };
+        template <> struct Codec<API_AttributeDefExt> { static constexpr bool Recordable = false; };
+
+        template <>
+        struct Codec<API_SelectionInfo> : RawCodec<API_SelectionInfo> {
+            static bool Load (const ArgBlob& blob, API_SelectionInfo& value)
+            {
+                if (!RawCodec<API_SelectionInfo>::Load (blob, value))
+                    return false;
+                value.marquee.coords = nullptr;
+                return true;
+            }
+        };
+
+        template <>
+        struct Codec<API_LayoutInfo> : RawCodec<API_LayoutInfo> {
+            static bool Load (const ArgBlob& blob, API_LayoutInfo& value)
+            {
+                if (!RawCodec<API_LayoutInfo>::Load (blob, value))
+                    return false;
+                value.customData = nullptr;
+                return true;
+            }
+        };
+
+        // Имя атрибута живёт по указателю вызывающего кода: пишем его строкой после структуры
+        template <>
+        struct Codec<API_Attribute> {
+            static constexpr bool Recordable = true;
+
+            static void Save (const API_Attribute& value, ArgBlob& blob)
+            {
+                RawCodec<API_Attribute>::Save (value, blob);
+                if (value.header.uniStringNamePtr != nullptr)
+                    AppendUtf8 (blob.data, value.header.uniStringNamePtr->ToCStr (CC_UTF8).Get ());
+            }
+
+            static bool Load (const ArgBlob& blob, API_Attribute& value)
+            {
+                GS::UniString* namePtr = value.header.uniStringNamePtr;
+                if (!RawCodec<API_Attribute>::Load (blob, value))
+                    return false;
+                value.header.uniStringNamePtr = namePtr;
+                if (namePtr != nullptr) {
+                    const std::string utf8 (blob.data.begin () + sizeof (API_Attribute), blob.data.end ());
+                    *namePtr = GS::UniString (utf8.c_str (), CC_UTF8);
+                }
+                return true;
+            }
+        };
+
+        template <>
+        struct Codec<GS::UniString> {
+            static constexpr bool Recordable = true;
+
+            static void Save (const GS::UniString& value, ArgBlob& blob)
+            {
+                blob.kind = ArgKind::String;
+                blob.data.clear ();
+                AppendUtf8 (blob.data, value.ToCStr (CC_UTF8).Get ());
+            }
+
+            static bool Load (const ArgBlob& blob, GS::UniString& value)
+            {
+                if (blob.kind != ArgKind::String)
+                    return false;
+                const std::string utf8 (blob.data.begin (), blob.data.end ());
+                value = GS::UniString (utf8.c_str (), CC_UTF8);
+                return true;
+            }
+        };
+
+        template <typename T>
+        struct Codec<GS::Array<T>> {
+            static constexpr bool Recordable = std::is_trivially_copyable<T>::value;
+
+            static void Save (const GS::Array<T>& value, ArgBlob& blob)
+            {
+                blob.kind = ArgKind::Array;
+                blob.count = value.GetSize ();
+                blob.itemSize = sizeof (T);
+                blob.data.resize (static_cast<std::size_t> (blob.count) * sizeof (T));
+                for (UIndex i = 0; i < value.GetSize (); ++i)
+                    std::memcpy (blob.data.data () + static_cast<std::size_t> (i) * sizeof (T), &value[i], sizeof (T));
+            }
+
+            static bool Load (const ArgBlob& blob, GS::Array<T>& value)
+            {
+                if (blob.kind != ArgKind::Array || blob.itemSize != sizeof (T))
+                    return false;
+                value.Clear ();
+                value.SetCapacity (blob.count);
+                // смещения кратны sizeof (T), а значит и выравниванию T
+                for (UInt32 i = 0; i < blob.count; ++i)
+                    value.Push (*reinterpret_cast<const T*> (blob.data.data () + static_cast<std::size_t> (i) * sizeof (T)));
+                return true;
+            }
+        };
+
+        // ---- Хэш входа ----
+        // FNV-1a: по хэшу воспроизведение отличает вызовы одной функции с разными аргументами
+        class InputHash {
+        public:
+            void Add (const void* data, std::size_t size)
+            {
+                const unsigned char* bytes = static_cast<const unsigned char*> (data);
+                for (std::size_t i = 0; i < size; ++i) {
+                    value ^= bytes[i];
+                    value *= 1099511628211ull;
+                }
+            }
+
+            template <typename T>
+            void AddValue (const T& item) { Add (&item, sizeof (T)); }
+
+            void AddCString (const char* text) { Add (text, std::strlen (text) + 1); }
+
+            std::uint64_t Get () const { return value; }
+
+        private:
+            std::uint64_t value = 14695981039346656037ull;
+        };
+
+        // Что из объекта определяет результат вызова. Изменяемые аргументы ACAPI — чаще всего
+        // структуры «вход + выход» (guid задан, остальное заполняет Archicad), поэтому в хэш идут
+        // только ключевые поля; остальное до вызова может быть мусором. Для типов без
+        // специализации изменяемый аргумент считается чистым выходом и в хэш не входит
+        template <typename T>
+        struct InputKey { static constexpr bool Keyed = false; };
+
+        template <>
+        struct InputKey<API_Guid> {
+            static constexpr bool Keyed = true;
+            static void Add (const API_Guid& value, InputHash& hash) { hash.AddValue (value); }
+        };
+
+        template <>
+        struct InputKey<GS::UniString> {
+            static constexpr bool Keyed = true;
+            static void Add (const GS::UniString& value, InputHash& hash)
+            {
+                hash.AddCString (value.ToCStr (CC_UTF8).Get ());
+            }
+        };
+
+        template <>
+        struct InputKey<API_Elem_Head> {
+            static constexpr bool Keyed = true;
+            static void Add (const API_Elem_Head& value, InputHash& hash) { hash.AddValue (value.guid); }
+        };
+
+        template <>
+        struct InputKey<API_Element> {
+            static constexpr bool Keyed = true;
+            static void Add (const API_Element& value, InputHash& hash) { hash.AddValue (value.header.guid); }
+        };
+
+        template <>
+        struct InputKey<API_Attribute> {
+            static constexpr bool Keyed = true;
+            static void Add (const API_Attribute& value, InputHash& hash)
+            {
+                hash.AddValue (value.header.typeID);
+                hash.AddValue (value.header.index);
+                hash.AddValue (value.header.guid);
+            }
+        };
+
+        template <>
+        struct InputKey<API_DatabaseInfo> {
+            static constexpr bool Keyed = true;
+            static void Add (const API_DatabaseInfo& value, InputHash& hash)
+            {
+                hash.AddValue (value.typeID);
+                hash.AddValue (value.databaseUnId);
+            }
+        };
+
+        template <>
+        struct InputKey<API_NavigatorItem> {
+            static constexpr bool Keyed = true;
+            static void Add (const API_NavigatorItem& value, InputHash& hash)
+            {
+                hash.AddValue (value.guid);
+                hash.AddValue (value.mapId);
+                hash.AddValue (value.itemType);
+                InputKey<API_DatabaseInfo>::Add (value.db, hash);
+            }
+        };
+
+        // Константный вход (значение, константная ссылка или указатель): ключ или байты целиком
+        template <typename T>
+        void HashInputValue (const T& value, InputHash& hash)
+        {
+            if constexpr (InputKey<T>::Keyed)
+                InputKey<T>::Add (value, hash);
+            else if constexpr (std::is_trivially_copyable<T>::value && !std::is_pointer<T>::value && !std::is_null_pointer<T>::value)
+                hash.AddValue (value);
+        }
+
+        template <typename A>
+        void HashArg (A&& arg, InputHash& hash)
+        {
+            using D = std::remove_reference_t<A>;
+            using V = std::remove_cv_t<D>;
+            if constexpr (std::is_pointer<V>::value) {
+                using P = std::remove_pointer_t<V>;
+                const bool isNull = (arg == nullptr);
+                hash.AddValue (isNull);
+                if constexpr (!std::is_void<P>::value && !std::is_pointer<P>::value && !std::is_function<P>::value) {
+                    using T = std::remove_cv_t<P>;
+                    if (isNull)
+                        return;
+                    if constexpr (std::is_const<P>::value)
+                        HashInputValue<T> (*arg, hash);
+                    else if constexpr (InputKey<T>::Keyed)
+                        InputKey<T>::Add (*arg, hash);
+                }
+            } else if constexpr (std::is_null_pointer<V>::value) {
+                hash.AddValue (true);
+            } else if constexpr (std::is_lvalue_reference<A>::value && !std::is_const<D>::value && !std::is_array<D>::value) {
+                if constexpr (InputKey<V>::Keyed)
+                    InputKey<V>::Add (arg, hash);
+            } else {
+                HashInputValue<V> (arg, hash);
+            }
+        }
+
+        // Какой объект аргумента изменяем: указатель на неконстантный объект или неконстантная ссылка
+        template <typename A, typename Action>
+        void VisitMutable (A&& arg, Action&& action)
+        {
+            using D = std::remove_reference_t<A>;
+            if constexpr (std::is_pointer<D>::value) {
+                using P = std::remove_pointer_t<D>;
+                if constexpr (!std::is_const<P>::value && !std::is_void<P>::value && !std::is_pointer<P>::value) {
+                    if (arg != nullptr)
+                        action (*arg);
+                }
+            } else if constexpr (std::is_lvalue_reference<A>::value && !std::is_const<D>::value && !std::is_null_pointer<D>::value && !std::is_array<D>::value) {
+                action (arg);
+            }
+        }
+
+        template <typename A>
+        void SaveArg (A&& arg, ArgBlob& blob)
+        {
+            VisitMutable (std::forward<A> (arg), [&blob] (auto& value) {
+                using T = std::remove_cv_t<std::remove_reference_t<decltype (value)>>;
+                if constexpr (Codec<T>::Recordable)
+                    Codec<T>::Save (value, blob);
+            });
+        }
+
+        template <typename A>
+        void LoadArg (A&& arg, const ArgBlob& blob)
+        {
+            if (blob.kind == ArgKind::Skipped)
+                return;
+            VisitMutable (std::forward<A> (arg), [&blob] (auto& value) {
+                using T = std::remove_cv_t<std::remove_reference_t<decltype (value)>>;
+                if constexpr (Codec<T>::Recordable)
+                    Codec<T>::Load (blob, value);
+            });
+        }
+
+        void WriteCall (const char* function, ApiRecordFormat::CallRecord& call);
+        const ApiRecordFormat::CallRecord* NextReplayCall (ReplaySite& site, std::uint64_t inputHash);
+
+    } // namespace Detail
+
+    // Хэш входных аргументов вызова; при записи считается до вызова, пока выходы не заполнены
+    template <typename... Args>
+    std::uint64_t HashInputs (Args&&... args)
+    {
+        Detail::InputHash hash;
+        (Detail::HashArg (std::forward<Args> (args), hash), ...);
+        return hash.Get ();
+    }
+
+    template <typename... Args>
+    void Record (const char* function, std::uint64_t inputHash, GSErrCode result, UInt64 elapsedUs, Args&&... args)
+    {
+        ApiRecordFormat::CallRecord call;
+        call.inputHash = inputHash;
+        call.result = static_cast<std::int32_t> (result);
+        call.elapsedUs = static_cast<std::uint32_t> (elapsedUs);
+        call.args.resize (sizeof... (Args));
+        std::size_t index = 0;
+        (Detail::SaveArg (std::forward<Args> (args), call.args[index++]), ...);
+        Detail::WriteCall (function, call);
+    }
+
+    template <typename... Args>
+    GSErrCode Replay (ReplaySite& site, Args&&... args)
+    {
+        const ApiRecordFormat::CallRecord* call = Detail::NextReplayCall (site, HashInputs (std::forward<Args> (args)...));
+        if (call == nullptr)
+            return APIERR_GENERAL;
+
+        std::size_t index = 0;
+        auto load = [call, &index] (auto&& arg) {
+            if (index < call->args.size ())
+                Detail::LoadArg (std::forward<decltype (arg)> (arg), call->args[index]);
+            ++index;
+        };
+        (load (std::forward<Args> (args)), ...);
+        return static_cast<GSErrCode> (call->result);
+    }
+
+} // namespace ApiRecorder
+
+#endif // APIRECORDER_HPP
@@ -0,0 +1,207 @@
+#include "BridgeStats.hpp"
+
+#include <cstdio>
+#include <memory>
+#include <vector>
+
+namespace BridgeStats {
+
+#ifdef DEBUG_UI_LOGS
+static std::atomic<bool> s_enabled { true };
+#else
+static std::atomic<bool> s_enabled { false };
+#endif
+
+// Регистрация идёт из главного потока при создании палитр; записи не удаляются
+static std::vector<std::unique_ptr<FunctionStats>>  s_functions;
+static GS::HashTable<GS::UniString, FunctionStats*> s_byName;
+
+bool IsEnabled ()
+{
+    return s_enabled.load (std::memory_order_relaxed);
+}
+
+void SetEnabled (bool enabled)
+{
+    s_enabled.store (enabled, std::memory_order_relaxed);
+}
+
+// ---------------- Регистрация ----------------
+FunctionStats* Register (const char* name)
+{
+    const GS::UniString key (name);
+    FunctionStats* stats = nullptr;
+    if (s_byName.Get (key, &stats))
+        return stats;
+
+    s_functions.push_back (std::make_unique<FunctionStats> ());
+    stats = s_functions.back ().get ();
+    stats->name = key;
+    s_byName.Add (key, stats);
+    return stats;
+}
+
+// ---------------- Учёт вызова ----------------
+static UInt32 LatencyBucket (UInt64 elapsedNs)
+{
+    UInt64 us = elapsedNs / 1000;
+    UInt32 bucket = 0;
+    while (us != 0 && bucket + 1 < LatencyBucketCount) {
+        us >>= 1;
+        ++bucket;
+    }
+    return bucket;
+}
+
+void Record (FunctionStats& stats, UInt64 elapsedNs, UInt64 requestBytes, UInt64 responseBytes)
+{
+    stats.calls.fetch_add (1, std::memory_order_relaxed);
+    stats.totalNs.fetch_add (elapsedNs, std::memory_order_relaxed);
+    stats.requestBytes.fetch_add (requestBytes, std::memory_order_relaxed);
+    stats.responseBytes.fetch_add (responseBytes, std::memory_order_relaxed);
+    stats.latency[LatencyBucket (elapsedNs)].fetch_add (1, std::memory_order_relaxed);
+
+    UInt64 prevMax = stats.maxNs.load (std::memory_order_relaxed);
+    while (elapsedNs > prevMax && !stats.maxNs.compare_exchange_weak (prevMax, elapsedNs, std::memory_order_relaxed)) {
+    }
+}
+
+// ---------------- Размер полезной нагрузки ----------------
+UInt64 EstimatePayloadBytes (const GS::Ref<JS::Base>& value)
+{
+    if (value == nullptr)
+        return 0;
+
+    if (GS::Ref<JS::Value> v = GS::DynamicCast<JS::Value> (value)) {
+        switch (v->GetType ()) {
+            case JS::Value::STRING:  return v->GetString ().GetLength () + 2;
+            case JS::Value::BOOL:    return 5;
+            case JS::Value::INTEGER: return 8;
+            case JS::Value::DOUBLE:  return 16;
+            default:                 return 4;
+        }
+    }
+
+    if (GS::Ref<JS::Array> a = GS::DynamicCast<JS::Array> (value)) {
+        UInt64 bytes = 2;
+        for (const GS::Ref<JS::Base>& item : a->GetItemArray ())
+            bytes += EstimatePayloadBytes (item) + 1;
+        return bytes;
+    }
+
+    if (GS::Ref<JS::Object> o = GS::DynamicCast<JS::Object> (value)) {
+        UInt64 bytes = 2;
+        const GS::HashTable<GS::UniString, GS::Ref<JS::Base>>& table = o->GetItemTable ();
+        for (auto it = table.EnumeratePairs (); it != nullptr; ++it)
+            bytes += (*it->key).GetLength () + 4 + EstimatePayloadBytes (*it->value);
+        return bytes;
+    }
+
+    return 0;
+}
+
+// ---------------- Снимок ----------------
+static double BucketUpperMs (UInt32 bucket)
+{
+    return static_cast<double> (1ULL << bucket) / 1000.0;
+}
+
+static double Percentile (const UInt64 (&counts)[LatencyBucketCount], UInt64 total, double fraction)
+{
+    const UInt64 target = static_cast<UInt64> (fraction * static_cast<double> (total) + 0.5);
+    UInt64 seen = 0;
+    for (UInt32 b = 0; b < LatencyBucketCount; ++b) {
+        seen += counts[b];
+        if (seen >= target && seen > 0)
+            return BucketUpperMs (b);
+    }
+    return BucketUpperMs (LatencyBucketCount - 1);
+}
+
+GS::Array<FunctionSummary> GetSummary ()
+{
+    GS::Array<FunctionSummary> result;
+    for (const std::unique_ptr<FunctionStats>& stats : s_functions) {
+        FunctionSummary summary;
+        summary.name = stats->name;
+        summary.calls = stats->calls.load (std::memory_order_relaxed);
+        summary.requestBytes = stats->requestBytes.load (std::memory_order_relaxed);
+        summary.responseBytes = stats->responseBytes.load (std::memory_order_relaxed);
+        summary.maxMs = static_cast<double> (stats->maxNs.load (std::memory_order_relaxed)) / 1.0e6;
+        if (summary.calls > 0) {
+            summary.meanMs = static_cast<double> (stats->totalNs.load (std::memory_order_relaxed)) / 1.0e6 / static_cast<double> (summary.calls);
+
+            UInt64 counts[LatencyBucketCount];
+            UInt64 total = 0;
+            for (UInt32 b = 0; b < LatencyBucketCount; ++b) {
+                counts[b] = stats->latency[b].load (std::memory_order_relaxed);
+                total += counts[b];
+            }
+            summary.p50Ms = Percentile (counts, total, 0.50);
+            summary.p95Ms = Percentile (counts, total, 0.95);
+            summary.p99Ms = Percentile (counts, total, 0.99);
+        }
+        result.Push (summary);
+    }
+    return result;
+}
+
+void Reset ()
+{
+    for (const std::unique_ptr<FunctionStats>& stats : s_functions) {
+        stats->calls.store (0, std::memory_order_relaxed);
+        stats->totalNs.store (0, std::memory_order_relaxed);
+        stats->maxNs.store (0, std::memory_order_relaxed);
+        stats->requestBytes.store (0, std::memory_order_relaxed);
+        stats->responseBytes.store (0, std::memory_order_relaxed);
+        for (UInt32 b = 0; b < LatencyBucketCount; ++b)
+            stats->latency[b].store (0, std::memory_order_relaxed);
+    }
+}
+
+// ---------------- Выгрузка в JSON ----------------
+GS::UniString ToJson ()
+{
+    const GS::Array<FunctionSummary> summary = GetSummary ();
+
+    GS::UniString json ("{\n  \"enabled\": ");
+    json += IsEnabled () ? "true" : "false";
+    json += ",\n  \"functions\": [";
+
+    char line[512];
+    bool first = true;
+    for (const FunctionSummary& item : summary) {
+        if (item.calls == 0)
+            continue;
+        std::snprintf (line, sizeof (line),
+            "%s\n    { \"name\": \"%s\", \"calls\": %llu, \"meanMs\": %.3f, \"p50Ms\": %.3f, \"p95Ms\": %.3f, \"p99Ms\": %.3f, \"maxMs\": %.3f, \"requestBytes\": %llu, \"responseBytes\": %llu }",
+            first ? "" : ",",
+            item.name.ToCStr ().Get (),
+            static_cast<unsigned long long> (item.calls),
+            item.meanMs, item.p50Ms, item.p95Ms, item.p99Ms, item.maxMs,
+            static_cast<unsigned long long> (item.requestBytes),
+            static_cast<unsigned long long> (item.responseBytes));
+        json += line;
+        first = false;
+    }
+    json += "\n  ]\n}\n";
+    return json;
+}
+
+bool WriteJson (const GS::UniString& filePath)
+{
+#ifdef GS_WIN
+    FILE* fp = _wfopen (filePath.ToUStr ().Get (), L"w");
+#else
+    FILE* fp = fopen (filePath.ToCStr ().Get (), "w");
+#endif
+    if (fp == nullptr)
+        return false;
+
+    const GS::UniString json = ToJson ();
+    fputs (json.ToCStr (CC_UTF8).Get (), fp);
+    fclose (fp);
+    return true;
+}
+
+} // namespace BridgeStats
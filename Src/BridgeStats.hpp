@@ -0,0 +1,61 @@
+#ifndef BRIDGESTATS_HPP
+#define BRIDGESTATS_HPP
+
+#include "APIEnvir.h"
+#include "ACAPinc.h"
+#include "GSRoot.hpp"
+#include "DGBrowser.hpp"
+
+#include <atomic>
+
+// Статистика вызовов JS-моста: число вызовов, гистограмма задержек (p50/p95/p99),
+// объём запроса и ответа. Счётчики — атомики без блокировок; при выключенном сборе
+// обёртка вызова делает одну проверку флага.
+namespace BridgeStats {
+
+    // Корзины задержки: 0 — меньше 1 мкс, k — [2^(k-1), 2^k) мкс
+    const UInt32 LatencyBucketCount = 40;
+
+    struct FunctionStats {
+        GS::UniString               name;
+        std::atomic<UInt64>         calls { 0 };
+        std::atomic<UInt64>         totalNs { 0 };
+        std::atomic<UInt64>         maxNs { 0 };
+        std::atomic<UInt64>         requestBytes { 0 };
+        std::atomic<UInt64>         responseBytes { 0 };
+        std::atomic<UInt64>         latency[LatencyBucketCount] = {};
+    };
+
+    // Снимок для отчёта (задержки в миллисекундах, перцентили — по верхней границе корзины)
+    struct FunctionSummary {
+        GS::UniString name;
+        UInt64        calls = 0;
+        double        meanMs = 0.0;
+        double        p50Ms = 0.0;
+        double        p95Ms = 0.0;
+        double        p99Ms = 0.0;
+        double        maxMs = 0.0;
+        UInt64        requestBytes = 0;
+        UInt64        responseBytes = 0;
+    };
+
+    bool IsEnabled ();
+    void SetEnabled (bool enabled);
+
+    // Счётчики функции по имени; вызывается при регистрации, адрес стабилен до выгрузки
+    FunctionStats* Register (const char* name);
+
+    void Record (FunctionStats& stats, UInt64 elapsedNs, UInt64 requestBytes, UInt64 responseBytes);
+
+    // Оценка размера значения в JSON-представлении (строки — по числу символов)
+    UInt64 EstimatePayloadBytes (const GS::Ref<JS::Base>& value);
+
+    GS::Array<FunctionSummary> GetSummary ();
+    void Reset ();
+
+    GS::UniString ToJson ();
+    bool WriteJson (const GS::UniString& filePath);
+
+} // namespace BridgeStats
+
+#endif // BRIDGESTATS_HPP
@@ -18,10 +18,26 @@ extern "C" {
 #include "IdLayersPalette.hpp"
 #include "SelectionPropertyHelper.hpp"
 #include "SelectionMetricsHelper.hpp"
+#include "SelectionGroupHelper.hpp"
+#include "SelectionSetHelper.hpp"
 #include "SelectionDetailsPalette.hpp"
 #include "ToLayoutPalette.hpp"
 #include "LayoutHelper.hpp"
-
+#include "NameCache.hpp"
+#include "MetricsCache.hpp"
+#include "GrossMetricsJob.hpp"
+#include "SeoLossReport.hpp"
+#include "SeoWatch.hpp"
+#include "SeoLinks.hpp"
+#include "GuidCodec.hpp"
+#include "JsBinding.hpp"
+#include "BridgeStats.hpp"
+#include "ApiProfiler.hpp"
+#include "TraceLog.hpp"
+#include "ApiRecorder.hpp"
+
+#include <chrono>
+#include <functional>
 #include <cmath>
 #include <cstdio>
 #include <cstring>
@@ -89,6 +105,30 @@ static GS::Array<GS::UniString> GetStringArrayFromJavaScriptVariable(GS::Ref<JS:
 	return result;
 }
 
+// --- Extract GUIDs: array of strings and/or packed blocks, or a single packed string ---
+static GS::Array<API_Guid> GetGuidArrayFromJavaScriptVariable(GS::Ref<JS::Base> jsVariable)
+{
+	GS::Array<API_Guid> result;
+	if (GS::Ref<JS::Value> jsValue = GS::DynamicCast<JS::Value>(jsVariable)) {
+		if (jsValue->GetType() == JS::Value::STRING)
+			GuidCodec::AppendGuids(jsValue->GetString(), result);
+		return result;
+	}
+
+	GS::Ref<JS::Array> jsArray = GS::DynamicCast<JS::Array>(jsVariable);
+	if (jsArray == nullptr)
+		return result;
+
+	const GS::Array<GS::Ref<JS::Base>>& items = jsArray->GetItemArray();
+	result.SetCapacity(items.GetSize());
+	for (UIndex i = 0; i < items.GetSize(); ++i) {
+		GS::Ref<JS::Value> item = GS::DynamicCast<JS::Value>(items[i]);
+		if (item != nullptr && item->GetType() == JS::Value::STRING)
+			GuidCodec::AppendGuids(item->GetString(), result);
+	}
+	return result;
+}
+
 template<class Type>
 static GS::Ref<JS::Base> ConvertToJavaScriptVariable(const Type& cppVariable)
 {
@@ -96,14 +136,19 @@ static GS::Ref<JS::Base> ConvertToJavaScriptVariable(const Type& cppVariable)
 }
 
 template<>
-GS::Ref<JS::Base> ConvertToJavaScriptVariable(const SelectionHelper::ElementInfo& elemInfo)
+GS::Ref<JS::Base> ConvertToJavaScriptVariable(const SelectionHelper::SelectedElements& selected)
 {
-	GS::Ref<JS::Array> js = new JS::Array();
-	js->AddItem(ConvertToJavaScriptVariable(elemInfo.guidStr));
-	js->AddItem(ConvertToJavaScriptVariable(elemInfo.typeName));
-	js->AddItem(ConvertToJavaScriptVariable(elemInfo.elemID));
-	js->AddItem(ConvertToJavaScriptVariable(elemInfo.layerName));
-	return js;
+	// Строки формируются только здесь, на границе моста
+	GS::Ref<JS::Array> jsElements = new JS::Array();
+	for (const SelectionHelper::ElementRecord& record : selected.records) {
+		GS::Ref<JS::Array> js = new JS::Array();
+		js->AddItem(ConvertToJavaScriptVariable(APIGuidToString(record.guid)));
+		js->AddItem(ConvertToJavaScriptVariable(NameCache::GetString(record.typeName)));
+		js->AddItem(ConvertToJavaScriptVariable(selected.GetElemID(record)));
+		js->AddItem(ConvertToJavaScriptVariable(NameCache::GetString(record.layerName)));
+		jsElements->AddItem(js);
+	}
+	return jsElements;
 }
 
 template<>
@@ -115,6 +160,32 @@ GS::Ref<JS::Base> ConvertToJavaScriptVariable(const LayerHelper::LayerInfo& laye
 	return js;
 }
 
+template<>
+GS::Ref<JS::Base> ConvertToJavaScriptVariable(const SelectionMetricsHelper::Metric& metric)
+{
+	GS::Ref<JS::Object> js = new JS::Object();
+	js->AddItem("key", new JS::Value(metric.key));
+	js->AddItem("name", new JS::Value(metric.name));
+	js->AddItem("grossValue", new JS::Value(metric.grossValue));
+	js->AddItem("netValue", new JS::Value(metric.netValue));
+	js->AddItem("diffValue", new JS::Value(metric.diffValue));
+	js->AddItem("grossPending", new JS::Value(metric.grossPending));
+	return js;
+}
+
+template<>
+GS::Ref<JS::Base> ConvertToJavaScriptVariable(const SelectionMetricsHelper::ElementMetrics& element)
+{
+	GS::Ref<JS::Object> js = new JS::Object();
+	js->AddItem("guid", new JS::Value(APIGuidToString(element.guid)));
+	GS::Ref<JS::Array> jsMetrics = new JS::Array();
+	for (const SelectionMetricsHelper::Metric& metric : element.metrics) {
+		jsMetrics->AddItem(ConvertToJavaScriptVariable(metric));
+	}
+	js->AddItem("metrics", jsMetrics);
+	return js;
+}
+
 template<class Type>
 static GS::Ref<JS::Base> ConvertToJavaScriptVariable(const GS::Array<Type>& cppArray)
 {
@@ -125,6 +196,225 @@ static GS::Ref<JS::Base> ConvertToJavaScriptVariable(const GS::Array<Type>& cppA
 	return newArray;
 }
 
+// --- Реестр функций моста: те же лямбды доступны ACAPI.Batch по имени ---
+typedef std::function<GS::Ref<JS::Base>(GS::Ref<JS::Base>)> BridgeFunction;
+
+static GS::HashTable<GS::UniString, BridgeFunction>& GetBridgeFunctions()
+{
+	static GS::HashTable<GS::UniString, BridgeFunction> functions;
+	return functions;
+}
+
+// Каждая функция обёрнута учётом времени и объёма (BridgeStats); при выключенном сборе —
+// только проверка флага
+static void AddBridgeFunction(JS::Object* jsACAPI, const char* name, const BridgeFunction& function)
+{
+	BridgeStats::FunctionStats* stats = BridgeStats::Register(name);
+	// name — строковый литерал, живёт всё время работы
+	BridgeFunction instrumented = [stats, name, function](GS::Ref<JS::Base> param) -> GS::Ref<JS::Base> {
+		TraceLog::Span traceSpan(name, "bridge");
+		if (!BridgeStats::IsEnabled())
+			return function(param);
+
+		const UInt64 requestBytes = BridgeStats::EstimatePayloadBytes(param);
+		const std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+		GS::Ref<JS::Base> result = function(param);
+		const UInt64 elapsedNs = static_cast<UInt64>(std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start).count());
+		BridgeStats::Record(*stats, elapsedNs, requestBytes, BridgeStats::EstimatePayloadBytes(result));
+		return result;
+	};
+
+	GetBridgeFunctions().Put(GS::UniString(name), instrumented);
+	jsACAPI->AddItem(new JS::Function(name, instrumented));
+}
+
+// --- Таблицы полей для типизированного разбора параметров (JsBinding) ---
+// Точка привязки: строка LB/LT/RT/RB/MM или число 0..4
+static void DecodeAnchor(const JS::Value& value, LayoutHelper::PlaceParams& out)
+{
+	using Anchor = LayoutHelper::PlaceParams::Anchor;
+	if (value.GetType() == JS::Value::INTEGER) {
+		switch (value.GetInteger()) {
+			case 1:  out.anchorPosition = Anchor::LeftTop;     break;
+			case 2:  out.anchorPosition = Anchor::RightTop;    break;
+			case 3:  out.anchorPosition = Anchor::RightBottom; break;
+			case 4:  out.anchorPosition = Anchor::Middle;      break;
+			default: out.anchorPosition = Anchor::LeftBottom;  break;
+		}
+		return;
+	}
+	if (value.GetType() != JS::Value::STRING)
+		return;
+
+	const GS::UniString& anchor = value.GetString();
+	if (JsBinding::KeyEquals(anchor, "LT"))
+		out.anchorPosition = Anchor::LeftTop;
+	else if (JsBinding::KeyEquals(anchor, "RT"))
+		out.anchorPosition = Anchor::RightTop;
+	else if (JsBinding::KeyEquals(anchor, "RB"))
+		out.anchorPosition = Anchor::RightBottom;
+	else if (JsBinding::KeyEquals(anchor, "MM"))
+		out.anchorPosition = Anchor::Middle;
+	else if (JsBinding::KeyEquals(anchor, "LB"))
+		out.anchorPosition = Anchor::LeftBottom;
+	// Нераспознанное значение — остаётся значение по умолчанию
+}
+
+using PlaceParams = LayoutHelper::PlaceParams;
+
+static constexpr JsBinding::Field<PlaceParams> PlaceParamsFields[] = {
+	JsBinding::IntField<PlaceParams>("masterLayoutIndex", &PlaceParams::masterLayoutIndex),
+	JsBinding::IntField<PlaceParams>("layoutIndex", &PlaceParams::layoutIndex),
+	JsBinding::DoubleField<PlaceParams>("scale", &PlaceParams::scale),
+	JsBinding::StringField<PlaceParams>("drawingName", &PlaceParams::drawingName),
+	JsBinding::StringField<PlaceParams>("layoutName", &PlaceParams::layoutName),
+	JsBinding::StringField<PlaceParams>("targetFolder", &PlaceParams::targetFolder),
+	JsBinding::CustomField<PlaceParams>("anchorPosition", &DecodeAnchor),
+	JsBinding::CustomField<PlaceParams>("anchor", &DecodeAnchor),  // старое имя ключа
+	JsBinding::BoolField<PlaceParams>("fitScaleToLayout", &PlaceParams::fitScaleToLayout),
+	JsBinding::BoolField<PlaceParams>("useMarqueeAsBoundary", &PlaceParams::useMarqueeAsBoundary),
+	JsBinding::GuidField<PlaceParams>("placeViewGuid", &PlaceParams::placeViewGuid),
+	JsBinding::BoolField<PlaceParams>("useGridRegion", &PlaceParams::useGridRegion),
+	JsBinding::IntField<PlaceParams>("gridRows", &PlaceParams::gridRows),
+	JsBinding::IntField<PlaceParams>("gridCols", &PlaceParams::gridCols),
+	JsBinding::DoubleField<PlaceParams>("gridGapMm", &PlaceParams::gridGapMm),
+	JsBinding::IntField<PlaceParams>("regionStartRow", &PlaceParams::regionStartRow),
+	JsBinding::IntField<PlaceParams>("regionStartCol", &PlaceParams::regionStartCol),
+	JsBinding::IntField<PlaceParams>("regionSpanRows", &PlaceParams::regionSpanRows),
+	JsBinding::IntField<PlaceParams>("regionSpanCols", &PlaceParams::regionSpanCols),
+};
+
+#ifdef DEBUG_UI_LOGS
+// Прежний ручной разбор PlaceOnLayout (до JsBinding) без изменений — база для BenchPlaceParamsDecode
+static void DecodePlaceParamsLegacy(GS::Ref<JS::Base> param, LayoutHelper::PlaceParams& p)
+{
+	if (GS::Ref<JS::Object> obj = GS::DynamicCast<JS::Object>(param)) {
+		const GS::HashTable<GS::UniString, GS::Ref<JS::Base>>& tbl = obj->GetItemTable();
+		GS::Ref<JS::Base> item;
+		if (tbl.Get("masterLayoutIndex", &item)) {
+			if (GS::Ref<JS::Value> vv = GS::DynamicCast<JS::Value>(item))
+				p.masterLayoutIndex = static_cast<Int32>(vv->GetInteger());
+		}
+		if (tbl.Get("layoutIndex", &item)) {
+			if (GS::Ref<JS::Value> vv = GS::DynamicCast<JS::Value>(item))
+				p.layoutIndex = static_cast<Int32>(vv->GetInteger());
+		}
+		if (tbl.Get("scale", &item))
+			p.scale = GetDoubleFromJs(GS::DynamicCast<JS::Value>(item), 100.0);
+		if (tbl.Get("drawingName", &item))
+			p.drawingName = GetStringFromJavaScriptVariable(item);
+		if (tbl.Get("layoutName", &item))
+			p.layoutName = GetStringFromJavaScriptVariable(item);
+		if (tbl.Get("targetFolder", &item))
+			p.targetFolder = GetStringFromJavaScriptVariable(item);
+
+		// Точка привязки вида на макете (радиокнопки LB/LT/RT/RB/MM)
+		// Читаем максимально устойчиво: сначала строку, при неудаче — возможное целочисленное значение.
+		if (!tbl.Get("anchorPosition", &item)) {
+			// fallback на ключ "anchor" на случай изменений в HTML
+			tbl.Get("anchor", &item);
+		}
+		if (item != nullptr) {
+			GS::UniString anchorStr = GetStringFromJavaScriptVariable(item);
+			anchorStr.Trim ();
+			if (anchorStr == "LT") {
+				p.anchorPosition = LayoutHelper::PlaceParams::Anchor::LeftTop;
+			} else if (anchorStr == "RT") {
+				p.anchorPosition = LayoutHelper::PlaceParams::Anchor::RightTop;
+			} else if (anchorStr == "RB") {
+				p.anchorPosition = LayoutHelper::PlaceParams::Anchor::RightBottom;
+			} else if (anchorStr == "MM") {
+				p.anchorPosition = LayoutHelper::PlaceParams::Anchor::Middle;
+			} else if (anchorStr == "LB") {
+				p.anchorPosition = LayoutHelper::PlaceParams::Anchor::LeftBottom;
+			} else if (anchorStr.IsEmpty ()) {
+				// Возможен вариант, когда значение приходит как число (0..4)
+				if (GS::Ref<JS::Value> vv = GS::DynamicCast<JS::Value> (item)) {
+					if (vv->GetType () == JS::Value::INTEGER) {
+						switch (vv->GetInteger ()) {
+							case 1: p.anchorPosition = LayoutHelper::PlaceParams::Anchor::LeftTop;    break;
+							case 2: p.anchorPosition = LayoutHelper::PlaceParams::Anchor::RightTop;   break;
+							case 3: p.anchorPosition = LayoutHelper::PlaceParams::Anchor::RightBottom;break;
+							case 4: p.anchorPosition = LayoutHelper::PlaceParams::Anchor::Middle;     break;
+							default: p.anchorPosition = LayoutHelper::PlaceParams::Anchor::LeftBottom;break;
+						}
+					}
+				}
+			}
+			// Если anchorStr не распознан и не число — остаётся значение по умолчанию (LeftBottom)
+		}
+		if (tbl.Get("fitScaleToLayout", &item)) {
+			if (GS::Ref<JS::Value> vv = GS::DynamicCast<JS::Value>(item))
+				p.fitScaleToLayout = vv->GetBool();
+		}
+		if (tbl.Get("useMarqueeAsBoundary", &item)) {
+			if (GS::Ref<JS::Value> vv = GS::DynamicCast<JS::Value>(item))
+				p.useMarqueeAsBoundary = vv->GetBool();
+		}
+		// Палитра «Организация чертежей»: вид по GUID и область сетки
+		if (tbl.Get("placeViewGuid", &item)) {
+			GS::UniString guidStr = GetStringFromJavaScriptVariable(item);
+			if (!guidStr.IsEmpty())
+				p.placeViewGuid = APIGuidFromString(guidStr.ToCStr().Get());
+		}
+		if (tbl.Get("useGridRegion", &item)) {
+			if (GS::Ref<JS::Value> vv = GS::DynamicCast<JS::Value>(item))
+				p.useGridRegion = vv->GetBool();
+		}
+		if (tbl.Get("gridRows", &item))
+			p.gridRows = static_cast<Int32>(GetDoubleFromJs(GS::DynamicCast<JS::Value>(item), 1));
+		if (tbl.Get("gridCols", &item))
+			p.gridCols = static_cast<Int32>(GetDoubleFromJs(GS::DynamicCast<JS::Value>(item), 1));
+		if (tbl.Get("gridGapMm", &item))
+			p.gridGapMm = GetDoubleFromJs(GS::DynamicCast<JS::Value>(item), 0);
+		if (tbl.Get("regionStartRow", &item))
+			p.regionStartRow = static_cast<Int32>(GetDoubleFromJs(GS::DynamicCast<JS::Value>(item), 0));
+		if (tbl.Get("regionStartCol", &item))
+			p.regionStartCol = static_cast<Int32>(GetDoubleFromJs(GS::DynamicCast<JS::Value>(item), 0));
+		if (tbl.Get("regionSpanRows", &item))
+			p.regionSpanRows = static_cast<Int32>(GetDoubleFromJs(GS::DynamicCast<JS::Value>(item), 1));
+		if (tbl.Get("regionSpanCols", &item))
+			p.regionSpanCols = static_cast<Int32>(GetDoubleFromJs(GS::DynamicCast<JS::Value>(item), 1));
+	} else if (GS::Ref<JS::Value> v = GS::DynamicCast<JS::Value>(param)) {
+		p.layoutIndex = static_cast<Int32>(v->GetInteger());
+	}
+}
+#endif
+
+using LayerCreationParams = LayerHelper::LayerCreationParams;
+
+static constexpr JsBinding::Field<LayerCreationParams> LayerCreationParamsFields[] = {
+	JsBinding::StringField<LayerCreationParams>("folderPath", &LayerCreationParams::folderPath),
+	JsBinding::StringField<LayerCreationParams>("layerName", &LayerCreationParams::layerName),
+	JsBinding::StringField<LayerCreationParams>("baseID", &LayerCreationParams::baseID),
+	JsBinding::BoolField<LayerCreationParams>("hideLayer", &LayerCreationParams::hideLayer),
+};
+
+// Параметры и результат GetLayoutWorkingArea
+struct WorkingAreaArgs {
+	GS::UniString mode = "existing";
+	Int32 layoutIndex = -1;
+	Int32 masterIndex = -1;
+};
+
+static constexpr JsBinding::Field<WorkingAreaArgs> WorkingAreaArgsFields[] = {
+	JsBinding::StringField<WorkingAreaArgs>("mode", &WorkingAreaArgs::mode),
+	JsBinding::IntField<WorkingAreaArgs>("layoutIndex", &WorkingAreaArgs::layoutIndex),
+	JsBinding::IntField<WorkingAreaArgs>("masterIndex", &WorkingAreaArgs::masterIndex),
+};
+
+struct WorkingAreaResult {
+	bool ok = false;
+	double widthMm = 0.0;
+	double heightMm = 0.0;
+};
+
+static constexpr JsBinding::Field<WorkingAreaResult> WorkingAreaResultFields[] = {
+	JsBinding::BoolField<WorkingAreaResult>("ok", &WorkingAreaResult::ok),
+	JsBinding::DoubleField<WorkingAreaResult>("widthMm", &WorkingAreaResult::widthMm),
+	JsBinding::DoubleField<WorkingAreaResult>("heightMm", &WorkingAreaResult::heightMm),
+};
+
 static void EnsureModelWindowIsActive()
 {
 	API_WindowInfo windowInfo = {};
@@ -212,8 +502,14 @@ static bool GetLayoutWorkingAreaByMasterIndex (Int32 masterIndex, double& outWid
 }
 
 // --------------------- Project event handler ---------------------
+// Обработчик у дополнения может быть только один, поэтому сюда же подключены сбросы кешей
 static GSErrCode NotificationHandler(API_NotifyEventID notifID, Int32 /*param*/)
 {
+	NameCache::HandleProjectEvent(notifID);
+	MetricsCache::HandleProjectEvent(notifID);
+	GrossMetricsJob::HandleProjectEvent(notifID);
+	SeoWatch::HandleProjectEvent(notifID);
+
 	if (notifID == APINotify_Quit) {
 		BrowserRepl::DestroyInstance();
 	}
@@ -229,7 +525,8 @@ BrowserRepl::BrowserRepl() :
 	buttonLayout(GetReference(), ToolbarButtonLayoutId),
 	buttonSupport(GetReference(), ToolbarButtonSupportId)
 {
-	ACAPI_ProjectOperation_CatchProjectEvent(APINotify_Quit, NotificationHandler);
+	ACAPI_ProjectOperation_CatchProjectEvent(APINotify_Quit | APINotify_New | APINotify_NewAndReset |
+		APINotify_Open | APINotify_Close | APINotify_Save | APINotify_ChangeProjectDB, NotificationHandler);
 
 	Attach(*this);
 	AttachToAllItems(*this);
@@ -276,46 +573,39 @@ void BrowserRepl::RegisterACAPIJavaScriptObject(DG::Browser& targetBrowser)
 	JS::Object* jsACAPI = new JS::Object("ACAPI");
 
 	// --- Selection API ---
-	jsACAPI->AddItem(new JS::Function("GetSelectedElements", [](GS::Ref<JS::Base>) {
-		GS::Array<SelectionHelper::ElementInfo> elements = SelectionHelper::GetSelectedElements();
-		return ConvertToJavaScriptVariable(elements);
-		}));
+	AddBridgeFunction(jsACAPI, "GetSelectedElements", [](GS::Ref<JS::Base>) {
+		const SelectionHelper::SelectedElements selected = SelectionHelper::GetSelectedElements();
+		return ConvertToJavaScriptVariable(selected);
+		});
 
-	jsACAPI->AddItem(new JS::Function("AddElementToSelection", [](GS::Ref<JS::Base> param) {
+	AddBridgeFunction(jsACAPI, "AddElementToSelection", [](GS::Ref<JS::Base> param) {
 		const GS::UniString id = GetStringFromJavaScriptVariable(param);
 		SelectionHelper::ModifySelection(id, SelectionHelper::AddToSelection);
 		return ConvertToJavaScriptVariable(true);
-		}));
+		});
 
-	jsACAPI->AddItem(new JS::Function("RemoveElementFromSelection", [](GS::Ref<JS::Base> param) {
+	AddBridgeFunction(jsACAPI, "RemoveElementFromSelection", [](GS::Ref<JS::Base> param) {
 		const GS::UniString id = GetStringFromJavaScriptVariable(param);
 		SelectionHelper::ModifySelection(id, SelectionHelper::RemoveFromSelection);
 		return ConvertToJavaScriptVariable(true);
-		}));
+		});
 
-	jsACAPI->AddItem(new JS::Function("ChangeSelectedElementsID", [](GS::Ref<JS::Base> param) {
+	AddBridgeFunction(jsACAPI, "ChangeSelectedElementsID", [](GS::Ref<JS::Base> param) {
 		const GS::UniString baseID = GetStringFromJavaScriptVariable(param);
 		const bool success = SelectionHelper::ChangeSelectedElementsID(baseID);
 		return ConvertToJavaScriptVariable(success);
-		}));
+		});
 
-	jsACAPI->AddItem(new JS::Function("SetElementsID", [](GS::Ref<JS::Base> param) {
+	AddBridgeFunction(jsACAPI, "SetElementsID", [](GS::Ref<JS::Base> param) {
 		GS::Array<API_Guid> guids;
 		GS::UniString newId;
 
 		if (GS::Ref<JS::Array> params = GS::DynamicCast<JS::Array>(param)) {
 			const GS::Array<GS::Ref<JS::Base>>& items = params->GetItemArray();
 			if (items.GetSize() >= 2) {
-				GS::Array<GS::UniString> guidStrings = GetStringArrayFromJavaScriptVariable(items[0]);
+				guids = GetGuidArrayFromJavaScriptVariable(items[0]);
 				newId = GetStringFromJavaScriptVariable(items[1]);
 				newId.Trim();
-
-				for (UIndex i = 0; i < guidStrings.GetSize(); ++i) {
-					API_Guid guid = APIGuidFromString(guidStrings[i].ToCStr().Get());
-					if (guid != APINULLGuid) {
-						guids.Push(guid);
-					}
-				}
 			}
 		}
 
@@ -324,18 +614,11 @@ void BrowserRepl::RegisterACAPIJavaScriptObject(DG::Browser& targetBrowser)
 		jsResult->AddItem("updated", ConvertToJavaScriptVariable((Int32)result.updated));
 		jsResult->AddItem("requested", ConvertToJavaScriptVariable((Int32)result.requested));
 		return jsResult;
-		}));
+		});
 
-	jsACAPI->AddItem(new JS::Function("ApplyCheckedSelection", [](GS::Ref<JS::Base> param) {
-		GS::Array<GS::UniString> guidStrings = GetStringArrayFromJavaScriptVariable(param);
-		
-		GS::Array<API_Guid> guids;
-		for (UIndex i = 0; i < guidStrings.GetSize(); ++i) {
-			API_Guid guid = APIGuidFromString(guidStrings[i].ToCStr().Get());
-			if (guid != APINULLGuid) {
-				guids.Push(guid);
-			}
-		}
+	// Вход: массив строк GUID и/или упакованных блоков (GuidCodec), либо один упакованный блок
+	AddBridgeFunction(jsACAPI, "ApplyCheckedSelection", [](GS::Ref<JS::Base> param) {
+		GS::Array<API_Guid> guids = GetGuidArrayFromJavaScriptVariable(param);
 		
 		SelectionHelper::ApplyCheckedSelectionResult result = SelectionHelper::ApplyCheckedSelection(guids);
 		
@@ -346,14 +629,234 @@ void BrowserRepl::RegisterACAPIJavaScriptObject(DG::Browser& targetBrowser)
 		EnsureModelWindowIsActive();
 
 		return jsResult;
-		}));
+		});
+
+	// Группировка выделения на стороне C++ для таблицы «Детали выделения»
+	// Вход: { keys: ["type","id","layer",...], sortColumn?: string, sortDirection?: "asc"|"desc", sums?: bool, summaryThreshold?: int }
+	// Выход: { snapshot: int, total: int, hasSums: bool, summary: bool, resolved: [bool], rows: [{ index, keys: [..], count, area, volume }] }
+	AddBridgeFunction(jsACAPI, "GetSelectionGroups", [](GS::Ref<JS::Base> param) {
+		GS::Array<GS::UniString> keyNames;
+		GS::UniString sortColumn;
+		GS::UniString sortDirection ("asc");
+		bool withSums = false;
+		UInt32 summaryThreshold = SelectionGroupHelper::DefaultSummaryThreshold;
+
+		if (GS::Ref<JS::Object> obj = GS::DynamicCast<JS::Object> (param)) {
+			const GS::HashTable<GS::UniString, GS::Ref<JS::Base>>& tbl = obj->GetItemTable ();
+			GS::Ref<JS::Base> item;
+			if (tbl.Get ("keys", &item))
+				keyNames = GetStringArrayFromJavaScriptVariable (item);
+			if (tbl.Get ("sortColumn", &item))
+				sortColumn = GetStringFromJavaScriptVariable (item);
+			if (tbl.Get ("sortDirection", &item))
+				sortDirection = GetStringFromJavaScriptVariable (item);
+			if (tbl.Get ("sums", &item)) {
+				if (GS::Ref<JS::Value> vv = GS::DynamicCast<JS::Value> (item))
+					withSums = (vv->GetType () == JS::Value::BOOL) && vv->GetBool ();
+			}
+			if (tbl.Get ("summaryThreshold", &item)) {
+				const double threshold = GetDoubleFromJs (item, -1.0);
+				if (threshold >= 0.0)
+					summaryThreshold = static_cast<UInt32> (threshold);
+			}
+		}
+
+		GS::Array<SelectionGroupHelper::KeySpec> keys;
+		GS::Array<GS::UniString> validKeyNames;
+		for (const GS::UniString& keyName : keyNames) {
+			SelectionGroupHelper::KeySpec spec;
+			if (SelectionGroupHelper::ParseKeySpec (keyName, spec)) {
+				keys.Push (spec);
+				validKeyNames.Push (keyName);
+			}
+		}
+		if (keys.IsEmpty ()) {
+			keys.Push (SelectionGroupHelper::KeySpec ());
+			validKeyNames.Push ("type");
+		}
+
+		const SelectionGroupHelper::SortSpec sortSpec = SelectionGroupHelper::ParseSortSpec (sortColumn, sortDirection, validKeyNames);
+		const SelectionGroupHelper::GroupsResult groups = SelectionGroupHelper::GetSelectionGroups (keys, sortSpec, withSums, summaryThreshold);
+
+		GS::Ref<JS::Array> jsRows = new JS::Array ();
+		for (const SelectionGroupHelper::GroupRow& row : groups.rows) {
+			GS::Ref<JS::Object> jsRow = new JS::Object ();
+			jsRow->AddItem ("index", new JS::Value (static_cast<Int32> (row.groupIndex)));
+			jsRow->AddItem ("keys", ConvertToJavaScriptVariable (row.keyValues));
+			jsRow->AddItem ("count", new JS::Value (static_cast<Int32> (row.count)));
+			if (groups.hasSums) {
+				jsRow->AddItem ("area", new JS::Value (row.area));
+				jsRow->AddItem ("volume", new JS::Value (row.volume));
+			}
+			jsRows->AddItem (jsRow);
+		}
+
+		GS::Ref<JS::Object> jsResult = new JS::Object ();
+		jsResult->AddItem ("snapshot", new JS::Value (static_cast<Int32> (groups.snapshotId)));
+		jsResult->AddItem ("total", new JS::Value (static_cast<Int32> (groups.totalElements)));
+		jsResult->AddItem ("hasSums", new JS::Value (groups.hasSums));
+		jsResult->AddItem ("summary", new JS::Value (groups.summary));
+		jsResult->AddItem ("resolved", ConvertToJavaScriptVariable (groups.keyResolved));
+		jsResult->AddItem ("rows", jsRows);
+		return jsResult;
+		});
+
+	// Отложенные ключи (ID, свойства) для одной группы в сводном режиме
+	// Вход: [snapshot, groupIndex, ["id",...]]; Выход: [{ keys: [..], count }]
+	AddBridgeFunction(jsACAPI, "GetSelectionGroupDetails", [](GS::Ref<JS::Base> param) {
+		Int32 snapshotId = 0;
+		Int32 groupIndex = -1;
+		GS::Array<SelectionGroupHelper::KeySpec> keys;
+		if (GS::Ref<JS::Array> params = GS::DynamicCast<JS::Array> (param)) {
+			const GS::Array<GS::Ref<JS::Base>>& items = params->GetItemArray ();
+			if (items.GetSize () >= 3) {
+				snapshotId = static_cast<Int32> (GetDoubleFromJs (items[0], 0.0));
+				groupIndex = static_cast<Int32> (GetDoubleFromJs (items[1], -1.0));
+				for (const GS::UniString& keyName : GetStringArrayFromJavaScriptVariable (items[2])) {
+					SelectionGroupHelper::KeySpec spec;
+					if (SelectionGroupHelper::ParseKeySpec (keyName, spec))
+						keys.Push (spec);
+				}
+			}
+		}
 
-	jsACAPI->AddItem(new JS::Function("GetSelectedProperties", [](GS::Ref<JS::Base> param) {
+		GS::Ref<JS::Array> jsRows = new JS::Array ();
+		if (snapshotId > 0 && groupIndex >= 0) {
+			const GS::Array<SelectionGroupHelper::GroupRow> rows = SelectionGroupHelper::GetGroupDetails (static_cast<UInt32> (snapshotId), static_cast<UInt32> (groupIndex), keys);
+			for (const SelectionGroupHelper::GroupRow& row : rows) {
+				GS::Ref<JS::Object> jsRow = new JS::Object ();
+				jsRow->AddItem ("keys", ConvertToJavaScriptVariable (row.keyValues));
+				jsRow->AddItem ("count", new JS::Value (static_cast<Int32> (row.count)));
+				jsRows->AddItem (jsRow);
+			}
+		}
+		return jsRows;
+		});
+
+	// GUID элементов группы из снимка GetSelectionGroups (запрашиваются только при необходимости)
+	// Вход: [snapshot, groupIndex, packed?]; Выход: массив строк GUID (пустой, если снимок устарел),
+	// при packed == true — одна строка base64 (GuidCodec)
+	AddBridgeFunction(jsACAPI, "GetSelectionGroupGuids", [](GS::Ref<JS::Base> param) -> GS::Ref<JS::Base> {
+		Int32 snapshotId = 0;
+		Int32 groupIndex = -1;
+		bool packed = false;
+		if (GS::Ref<JS::Array> params = GS::DynamicCast<JS::Array> (param)) {
+			const GS::Array<GS::Ref<JS::Base>>& items = params->GetItemArray ();
+			if (items.GetSize () >= 2) {
+				snapshotId = static_cast<Int32> (GetDoubleFromJs (items[0], 0.0));
+				groupIndex = static_cast<Int32> (GetDoubleFromJs (items[1], -1.0));
+			}
+			if (items.GetSize () >= 3) {
+				if (GS::Ref<JS::Value> vv = GS::DynamicCast<JS::Value> (items[2]))
+					packed = (vv->GetType () == JS::Value::BOOL) && vv->GetBool ();
+			}
+		}
+
+		GS::Array<API_Guid> guids;
+		if (snapshotId > 0 && groupIndex >= 0)
+			guids = SelectionGroupHelper::GetGroupGuids (static_cast<UInt32> (snapshotId), static_cast<UInt32> (groupIndex));
+
+		if (packed)
+			return new JS::Value (GuidCodec::Encode (guids));
+
+		GS::Ref<JS::Array> jsGuids = new JS::Array ();
+		for (const API_Guid& guid : guids)
+			jsGuids->AddItem (new JS::Value (APIGuidToString (guid)));
+		return jsGuids;
+		});
+
+	// --- Selection sets API (наборы выделения, сохраняемые в проекте) ---
+	AddBridgeFunction(jsACAPI, "GetSelectionSets", [](GS::Ref<JS::Base>) {
+		GS::Ref<JS::Array> jsSets = new JS::Array ();
+		for (const SelectionSetHelper::SetInfo& info : SelectionSetHelper::GetSavedSets ()) {
+			GS::Ref<JS::Object> obj = new JS::Object ();
+			obj->AddItem ("name", new JS::Value (info.name));
+			obj->AddItem ("count", new JS::Value (static_cast<Int32> (info.count)));
+			jsSets->AddItem (obj);
+		}
+		return jsSets;
+		});
+
+	// Сохранить текущее выделение в набор
+	// Вход: { name: string, mode?: "replace"|"union"|"difference" } — заменить набор, добавить к нему или убрать из него
+	// Выход: { ok: bool, count: int }
+	AddBridgeFunction(jsACAPI, "SaveSelectionSet", [](GS::Ref<JS::Base> param) {
+		GS::UniString name;
+		GS::UniString mode ("replace");
+		if (GS::Ref<JS::Object> obj = GS::DynamicCast<JS::Object> (param)) {
+			const GS::HashTable<GS::UniString, GS::Ref<JS::Base>>& tbl = obj->GetItemTable ();
+			GS::Ref<JS::Base> item;
+			if (tbl.Get ("name", &item))
+				name = GetStringFromJavaScriptVariable (item);
+			if (tbl.Get ("mode", &item))
+				mode = GetStringFromJavaScriptVariable (item);
+		}
+		name.Trim ();
+
+		SelectionSetHelper::GuidSet set = SelectionSetHelper::GetCurrentSelection ();
+		if (mode == "union" || mode == "difference") {
+			SelectionSetHelper::GuidSet stored;
+			SelectionSetHelper::LoadSet (name, stored);
+			set = (mode == "union")
+				? SelectionSetHelper::Combine (stored, set, SelectionSetHelper::SetOperation::Union)
+				: SelectionSetHelper::Combine (stored, set, SelectionSetHelper::SetOperation::Difference);
+		}
+
+		const bool ok = !name.IsEmpty () && SelectionSetHelper::SaveSet (name, set) == NoError;
+		GS::Ref<JS::Object> jsResult = new JS::Object ();
+		jsResult->AddItem ("ok", new JS::Value (ok));
+		jsResult->AddItem ("count", new JS::Value (static_cast<Int32> (set.size ())));
+		return jsResult;
+		});
+
+	// Выделить результат операции над наборами (слева направо)
+	// Вход: { sets: [string], op?: "union"|"intersection"|"difference" }
+	// Выход: { applied: int, stale: int }
+	AddBridgeFunction(jsACAPI, "ApplySelectionSet", [](GS::Ref<JS::Base> param) {
+		GS::Array<GS::UniString> names;
+		GS::UniString op ("union");
+		if (GS::Ref<JS::Object> obj = GS::DynamicCast<JS::Object> (param)) {
+			const GS::HashTable<GS::UniString, GS::Ref<JS::Base>>& tbl = obj->GetItemTable ();
+			GS::Ref<JS::Base> item;
+			if (tbl.Get ("sets", &item))
+				names = GetStringArrayFromJavaScriptVariable (item);
+			if (tbl.Get ("op", &item))
+				op = GetStringFromJavaScriptVariable (item);
+		}
+
+		SelectionSetHelper::SetOperation operation = SelectionSetHelper::SetOperation::Union;
+		if (op == "intersection")
+			operation = SelectionSetHelper::SetOperation::Intersection;
+		else if (op == "difference")
+			operation = SelectionSetHelper::SetOperation::Difference;
+
+		SelectionSetHelper::GuidSet result;
+		for (UIndex i = 0; i < names.GetSize (); ++i) {
+			SelectionSetHelper::GuidSet set;
+			SelectionSetHelper::LoadSet (names[i], set);
+			result = (i == 0) ? set : SelectionSetHelper::Combine (result, set, operation);
+		}
+
+		const SelectionSetHelper::ApplyResult applyResult = SelectionSetHelper::ApplyAsSelection (result);
+		EnsureModelWindowIsActive ();
+
+		GS::Ref<JS::Object> jsResult = new JS::Object ();
+		jsResult->AddItem ("applied", new JS::Value (static_cast<Int32> (applyResult.applied)));
+		jsResult->AddItem ("stale", new JS::Value (static_cast<Int32> (applyResult.stale)));
+		return jsResult;
+		});
+
+	AddBridgeFunction(jsACAPI, "DeleteSelectionSet", [](GS::Ref<JS::Base> param) {
+		const GS::UniString name = GetStringFromJavaScriptVariable (param);
+		return new JS::Value (!name.IsEmpty () && SelectionSetHelper::DeleteSet (name) == NoError);
+		});
+
+	AddBridgeFunction(jsACAPI, "GetSelectedProperties", [](GS::Ref<JS::Base> param) {
 		API_Guid requestedGuid = APINULLGuid;
 		if (param != nullptr) {
-			GS::UniString guidStr = GetStringFromJavaScriptVariable(param);
-			if (!guidStr.IsEmpty()) {
-				requestedGuid = APIGuidFromString(guidStr.ToCStr().Get());
+			const GS::Array<API_Guid> guids = GetGuidArrayFromJavaScriptVariable(param);
+			if (!guids.IsEmpty()) {
+				requestedGuid = guids[0];
 			}
 		}
 
@@ -369,9 +872,9 @@ void BrowserRepl::RegisterACAPIJavaScriptObject(DG::Browser& targetBrowser)
 			jsProps->AddItem(obj);
 		}
 		return jsProps;
-	}));
+	});
 
-	jsACAPI->AddItem(new JS::Function("GetSelectionSeoMetrics", [](GS::Ref<JS::Base> param) {
+	AddBridgeFunction(jsACAPI, "GetSelectionSeoMetrics", [](GS::Ref<JS::Base> param) {
 		API_Guid requestedGuid = APINULLGuid;
 		if (param != nullptr) {
 			GS::UniString guidStr = GetStringFromJavaScriptVariable(param);
@@ -380,56 +883,177 @@ void BrowserRepl::RegisterACAPIJavaScriptObject(DG::Browser& targetBrowser)
 			}
 		}
 
-		GS::Array<SelectionMetricsHelper::Metric> metrics = (requestedGuid == APINULLGuid)
-			? SelectionMetricsHelper::CollectForFirstSelected()
-			: SelectionMetricsHelper::CollectForGuid(requestedGuid);
-		GS::Ref<JS::Array> jsMetrics = new JS::Array();
-		for (const auto& metric : metrics) {
+		if (requestedGuid == APINULLGuid) {
+			requestedGuid = SelectionMetricsHelper::GetFirstSelected();
+		}
+
+		// Сразу — net (или всё из кеша); gross досчитывается порциями и приходит через OnSeoGrossMetricsReady()
+		bool grossReady = true;
+		GS::Array<SelectionMetricsHelper::Metric> metrics = SelectionMetricsHelper::CollectNetForGuid(requestedGuid, grossReady);
+		if (!grossReady) {
+			GS::Array<API_Guid> pending;
+			pending.Push(requestedGuid);
+			GrossMetricsJob::Start(pending);
+		}
+
+		GS::Ref<JS::Object> jsResult = new JS::Object();
+		jsResult->AddItem("guid", new JS::Value(APIGuidToString(requestedGuid)));
+		jsResult->AddItem("metrics", ConvertToJavaScriptVariable(metrics));
+		jsResult->AddItem("grossPending", new JS::Value(!grossReady));
+		return jsResult;
+	});
+
+	// Слежение за показанными элементами: вход — GUID (массив строк или упакованный блок), пусто — выключить.
+	// Изменённые элементы и цели изменённых операторов только помечаются устаревшими (OnSeoMetricsStale()):
+	// пересчёт — undo-команда, и сразу после правки или Undo он испортил бы историю отмены
+	AddBridgeFunction(jsACAPI, "SetSeoWatch", [](GS::Ref<JS::Base> param) {
+		SeoWatch::Watch(GetGuidArrayFromJavaScriptVariable(param));
+		return new JS::Value(static_cast<Int32>(SeoWatch::GetTargetCount()));
+	});
+
+	// Пересчитать помеченные SeoWatch элементы (по запросу пользователя); результаты — через
+	// OnSeoGrossMetricsReady(). Возвращает число поставленных в расчёт элементов
+	AddBridgeFunction(jsACAPI, "RecomputeStaleSeoMetrics", [](GS::Ref<JS::Base>) {
+		const GS::Array<API_Guid> stale = SeoWatch::TakeStale();
+		if (!stale.IsEmpty()) {
+			GrossMetricsJob::Enqueue(stale);
+		}
+		return new JS::Value(static_cast<Int32>(stale.GetSize()));
+	});
+
+	// SEO-связи элементов: [{ guid, ok, operators: [guid], targets: [guid] }] — какие операторы режут элемент
+	// и какие цели режет он сам; ok = false — связи прочитать не удалось (списки неполны).
+	// Вход — GUID (массив строк или упакованный блок), пусто — выделение
+	AddBridgeFunction(jsACAPI, "GetSeoLinks", [](GS::Ref<JS::Base> param) {
+		GS::Array<API_Guid> guids = GetGuidArrayFromJavaScriptVariable(param);
+		if (guids.IsEmpty()) {
+			const SelectionHelper::SelectedElements selected = SelectionHelper::GetSelectedElements();
+			for (const SelectionHelper::ElementRecord& record : selected.records) {
+				guids.Push(record.guid);
+			}
+		}
+
+		GS::Ref<JS::Array> jsLinks = new JS::Array();
+		for (const API_Guid& guid : guids) {
+			GS::Array<API_Guid> operators;
+			GS::Array<API_Guid> targets;
+			const bool ok = SeoLinks::GetOperators(guid, operators) == NoError
+				&& SeoLinks::GetTargets(guid, targets) == NoError;
+			GS::Ref<JS::Array> jsOperators = new JS::Array();
+			for (const API_Guid& oper : operators) {
+				jsOperators->AddItem(new JS::Value(APIGuidToString(oper)));
+			}
+			GS::Ref<JS::Array> jsTargets = new JS::Array();
+			for (const API_Guid& target : targets) {
+				jsTargets->AddItem(new JS::Value(APIGuidToString(target)));
+			}
+			GS::Ref<JS::Object> obj = new JS::Object();
+			obj->AddItem("guid", new JS::Value(APIGuidToString(guid)));
+			obj->AddItem("ok", new JS::Value(ok));
+			obj->AddItem("operators", jsOperators);
+			obj->AddItem("targets", jsTargets);
+			jsLinks->AddItem(obj);
+		}
+		return jsLinks;
+	});
+
+	// Готовые gross-метрики отложенного расчёта: [{ guid, metrics }]; забранные из очереди удаляются
+	AddBridgeFunction(jsACAPI, "TakeSeoGrossMetrics", [](GS::Ref<JS::Base>) {
+		return ConvertToJavaScriptVariable(GrossMetricsJob::TakeReady());
+	});
+
+	// SEO-потери всего выделения: { elements: [{ guid, metrics }], totals: [metric], grossMs, copies }
+	// Вход "compare": gross считается ещё и прежним путём (команда на элемент), добавляются perElementGrossMs
+	// и perElementCopies; в этом режиме кеш метрик не используется, чтобы замер был честным. Элементы без
+	// SEO-операторов оба пути пропускают одинаково, copies показывает, сколько копий сделано на самом деле
+	AddBridgeFunction(jsACAPI, "GetSelectionSeoTotals", [](GS::Ref<JS::Base> param) {
+		const bool compare = (param != nullptr && GetStringFromJavaScriptVariable(param) == "compare");
+		SelectionMetricsHelper::SelectionMetrics perElement;
+		if (compare) {
+			perElement = SelectionMetricsHelper::CollectForSelection(SelectionMetricsHelper::GrossMode::PerElement, false);
+		}
+		const SelectionMetricsHelper::SelectionMetrics result = SelectionMetricsHelper::CollectForSelection(
+			SelectionMetricsHelper::GrossMode::Batched, !compare);
+		GS::Ref<JS::Object> jsResult = new JS::Object();
+		jsResult->AddItem("elements", ConvertToJavaScriptVariable(result.elements));
+		jsResult->AddItem("totals", ConvertToJavaScriptVariable(result.totals));
+		jsResult->AddItem("grossMs", ConvertToJavaScriptVariable(result.grossMs));
+		jsResult->AddItem("copies", new JS::Value(static_cast<Int32>(result.copiedCount)));
+		if (compare) {
+			jsResult->AddItem("perElementGrossMs", ConvertToJavaScriptVariable(perElement.grossMs));
+			jsResult->AddItem("perElementCopies", new JS::Value(static_cast<Int32>(perElement.copiedCount)));
+		}
+		return jsResult;
+	});
+
+	// Отчёт о потерях SEO по всему проекту в CSV. Вход: размер порции (число, необязательно)
+	AddBridgeFunction(jsACAPI, "ExportSeoLossReport", [](GS::Ref<JS::Base> param) {
+		SeoLossReport::Options options;
+		const double batchSize = GetDoubleFromJs(param, (double)SeoLossReport::DefaultBatchSize);
+		options.batchSize = (batchSize >= 1.0) ? static_cast<UInt32>(batchSize) : SeoLossReport::DefaultBatchSize;
+		const SeoLossReport::Result result = SeoLossReport::Export(options);
+
+		GS::Ref<JS::Object> jsResult = new JS::Object();
+		jsResult->AddItem("ok", new JS::Value(result.ok));
+		jsResult->AddItem("filePath", new JS::Value(result.filePath));
+		jsResult->AddItem("elements", new JS::Value(static_cast<Int32>(result.elementCount)));
+		jsResult->AddItem("unresolved", new JS::Value(static_cast<Int32>(result.unresolvedCount)));
+		jsResult->AddItem("rows", new JS::Value(static_cast<Int32>(result.rowCount)));
+		jsResult->AddItem("cancelled", new JS::Value(result.cancelled));
+		return jsResult;
+	});
+
+	// Замер масок количеств по типам выделенных элементов: [{ typeName, count, fullMs, minimalMs }]
+	AddBridgeFunction(jsACAPI, "BenchmarkQuantityMasks", [](GS::Ref<JS::Base>) {
+		GS::Ref<JS::Array> jsRows = new JS::Array();
+		for (const SelectionMetricsHelper::MaskBenchmarkRow& row : SelectionMetricsHelper::BenchmarkQuantityMasks()) {
 			GS::Ref<JS::Object> obj = new JS::Object();
-			obj->AddItem("key", new JS::Value(metric.key));
-			obj->AddItem("name", new JS::Value(metric.name));
-			obj->AddItem("grossValue", new JS::Value(metric.grossValue));
-			obj->AddItem("netValue", new JS::Value(metric.netValue));
-			obj->AddItem("diffValue", new JS::Value(metric.diffValue));
-			jsMetrics->AddItem(obj);
+			obj->AddItem("typeName", new JS::Value(row.typeName));
+			obj->AddItem("count", new JS::Value(static_cast<Int32>(row.elementCount)));
+			obj->AddItem("fullMs", new JS::Value(row.fullMs));
+			obj->AddItem("minimalMs", new JS::Value(row.minimalMs));
+			jsRows->AddItem(obj);
 		}
-		return jsMetrics;
-	}));
+		return jsRows;
+	});
 
 	// --- Layers API ---
-	jsACAPI->AddItem(new JS::Function("CreateLayerAndMoveElements", [](GS::Ref<JS::Base> param) {
+	// Вход: { folderPath, layerName, hideLayer } или строка "папка|слой|1" (старый формат)
+	AddBridgeFunction(jsACAPI, "CreateLayerAndMoveElements", [](GS::Ref<JS::Base> param) {
 		LayerHelper::LayerCreationParams params;
 		
-		GS::UniString jsonStr = GetStringFromJavaScriptVariable(param);
-		
-		GS::Array<GS::UniString> parts;
-		jsonStr.Split(GS::UniString("|"), [&parts](const GS::UniString& part) {
-			parts.Push(part);
-		});
-		
-		if (parts.GetSize() >= 2) {
-			params.folderPath = parts[0];
-			params.layerName = parts[1];
-			params.baseID = GS::UniString("");
-			params.hideLayer = false;
+		if (!JsBinding::Decode(param, LayerCreationParamsFields, params)) {
+			GS::UniString jsonStr = GetStringFromJavaScriptVariable(param);
 			
-			if (parts.GetSize() >= 3) {
-				params.hideLayer = (parts[2] == "1" || parts[2] == "true" || parts[2] == "True");
+			GS::Array<GS::UniString> parts;
+			jsonStr.Split(GS::UniString("|"), [&parts](const GS::UniString& part) {
+				parts.Push(part);
+			});
+			
+			if (parts.GetSize() >= 2) {
+				params.folderPath = parts[0];
+				params.layerName = parts[1];
+				params.baseID = GS::UniString("");
+				params.hideLayer = false;
+				
+				if (parts.GetSize() >= 3) {
+					params.hideLayer = (parts[2] == "1" || parts[2] == "true" || parts[2] == "True");
+				}
 			}
 		}
 		
 		const bool success = LayerHelper::CreateLayerAndMoveElements(params);
 		return ConvertToJavaScriptVariable(success);
-		}));
+		});
 
-	jsACAPI->AddItem(new JS::Function("GetLayersList", [](GS::Ref<JS::Base>) {
+	AddBridgeFunction(jsACAPI, "GetLayersList", [](GS::Ref<JS::Base>) {
 		const GS::Array<LayerHelper::LayerInfo> layers = LayerHelper::GetLayersList();
 		return ConvertToJavaScriptVariable(layers);
-		}));
+		});
 
 	// --- Layout API (для палитры To Layout) ---
 	// Простой список макетов (используется в старом UI и для совместимости)
-	jsACAPI->AddItem(new JS::Function("GetLayouts", [](GS::Ref<JS::Base>) {
+	AddBridgeFunction(jsACAPI, "GetLayouts", [](GS::Ref<JS::Base>) {
 		const GS::Array<LayoutHelper::LayoutItem> layouts = LayoutHelper::GetLayoutList();
 		GS::Ref<JS::Array> jsArr = new JS::Array();
 		for (UIndex i = 0; i < layouts.GetSize(); ++i) {
@@ -439,57 +1063,21 @@ void BrowserRepl::RegisterACAPIJavaScriptObject(DG::Browser& targetBrowser)
 			jsArr->AddItem(obj);
 		}
 		return jsArr;
-		}));
+		});
 
 	// Группированный список макетов: имитируем папки Навигатора
 	// Формат: [{ groupName: string, layouts: [{ index: int, name: string }, ...] }, ...]
-	jsACAPI->AddItem(new JS::Function("GetLayoutsTree", [](GS::Ref<JS::Base>) {
+	AddBridgeFunction(jsACAPI, "GetLayoutsTree", [](GS::Ref<JS::Base>) {
 		const GS::Array<LayoutHelper::LayoutItem> layouts = LayoutHelper::GetLayoutList();
-
-		// Карта: имя группы -> индексы макетов в исходном массиве
-		GS::HashTable<GS::UniString, GS::Array<UIndex>> groups;
-		GS::Array<GS::UniString> groupOrder;
-
-		for (UIndex i = 0; i < layouts.GetSize(); ++i) {
-			const GS::UniString& fullName = layouts[i].name;
-
-			GS::UniString groupName;
-
-			// Пробуем разделить по '/' как по разделителю папок
-			USize slashPos = fullName.FindFirst (GS::UniChar ('/'));
-			if (slashPos != MaxUSize) {
-				groupName = fullName.GetSubstring (0, slashPos);
-			} else {
-				// Если нет разделителя — считаем, что макет без папки
-				groupName = GS::UniString ("Без папки");
-			}
-
-			if (!groups.ContainsKey (groupName)) {
-				groups.Add (groupName, GS::Array<UIndex> ());
-				groupOrder.Push (groupName);
-			}
-
-			GS::Array<UIndex>* idxArray = groups.GetPtr (groupName);
-			if (idxArray != nullptr) {
-				idxArray->Push (i);
-			}
-		}
+		const GS::Array<LayoutHelper::LayoutGroup> groups = LayoutHelper::GetLayoutGroups(layouts);
 
 		GS::Ref<JS::Array> jsGroups = new JS::Array();
-
-		for (UIndex gi = 0; gi < groupOrder.GetSize(); ++gi) {
-			const GS::UniString& grpName = groupOrder[gi];
-			const GS::Array<UIndex>& idxArray = groups[grpName];
-
+		for (const LayoutHelper::LayoutGroup& group : groups) {
 			GS::Ref<JS::Object> grpObj = new JS::Object();
-			grpObj->AddItem("groupName", new JS::Value(grpName));
+			grpObj->AddItem("groupName", new JS::Value(group.groupName));
 
 			GS::Ref<JS::Array> jsLayouts = new JS::Array();
-			for (UIndex k = 0; k < idxArray.GetSize(); ++k) {
-				UIndex idx = idxArray[k];
-				if (idx >= layouts.GetSize())
-					continue;
-
+			for (UIndex idx : group.layoutIndices) {
 				GS::Ref<JS::Object> lo = new JS::Object();
 				lo->AddItem("index", new JS::Value(static_cast<Int32>(idx)));
 				lo->AddItem("name", new JS::Value(layouts[idx].name));
@@ -501,9 +1089,9 @@ void BrowserRepl::RegisterACAPIJavaScriptObject(DG::Browser& targetBrowser)
 		}
 
 		return jsGroups;
-		}));
+		});
 
-	jsACAPI->AddItem(new JS::Function("GetLayoutFolders", [](GS::Ref<JS::Base>) {
+	AddBridgeFunction(jsACAPI, "GetLayoutFolders", [](GS::Ref<JS::Base>) {
 		const GS::Array<LayoutHelper::LayoutFolderItem> folders = LayoutHelper::GetLayoutFolders();
 		GS::Ref<JS::Array> jsArr = new JS::Array();
 		for (UIndex i = 0; i < folders.GetSize(); ++i) {
@@ -512,9 +1100,9 @@ void BrowserRepl::RegisterACAPIJavaScriptObject(DG::Browser& targetBrowser)
 			jsArr->AddItem(obj);
 		}
 		return jsArr;
-		}));
+		});
 
-	jsACAPI->AddItem(new JS::Function("GetMasterLayouts", [](GS::Ref<JS::Base>) {
+	AddBridgeFunction(jsACAPI, "GetMasterLayouts", [](GS::Ref<JS::Base>) {
 		const GS::Array<LayoutHelper::MasterLayoutItem> masters = LayoutHelper::GetMasterLayoutList();
 		GS::Ref<JS::Array> jsArr = new JS::Array();
 		for (UIndex i = 0; i < masters.GetSize(); ++i) {
@@ -524,58 +1112,35 @@ void BrowserRepl::RegisterACAPIJavaScriptObject(DG::Browser& targetBrowser)
 			jsArr->AddItem(obj);
 		}
 		return jsArr;
-		}));
+		});
 
 	// Рабочая область макета (с учётом полей) для ориентира сетки в палитре «Организация чертежей»
 	// Вход: { mode: "existing"|"master", layoutIndex?: int, masterIndex?: int }
 	// Выход: { ok: bool, widthMm: double, heightMm: double }
-	jsACAPI->AddItem(new JS::Function("GetLayoutWorkingArea", [](GS::Ref<JS::Base> param) {
-		GS::UniString mode ("existing");
-		Int32 layoutIndex = -1;
-		Int32 masterIndex = -1;
-
-		if (GS::Ref<JS::Object> obj = GS::DynamicCast<JS::Object> (param)) {
-			const GS::HashTable<GS::UniString, GS::Ref<JS::Base>>& tbl = obj->GetItemTable ();
-			GS::Ref<JS::Base> item;
-			if (tbl.Get ("mode", &item)) {
-				GS::UniString m = GetStringFromJavaScriptVariable (item);
-				if (!m.IsEmpty ())
-					mode = m;
-			}
-			if (tbl.Get ("layoutIndex", &item)) {
-				if (GS::Ref<JS::Value> vv = GS::DynamicCast<JS::Value> (item))
-					layoutIndex = static_cast<Int32> (vv->GetInteger ());
-			}
-			if (tbl.Get ("masterIndex", &item)) {
-				if (GS::Ref<JS::Value> vv = GS::DynamicCast<JS::Value> (item))
-					masterIndex = static_cast<Int32> (vv->GetInteger ());
-			}
-		} else if (GS::Ref<JS::Value> v = GS::DynamicCast<JS::Value> (param)) {
+	AddBridgeFunction(jsACAPI, "GetLayoutWorkingArea", [](GS::Ref<JS::Base> param) {
+		WorkingAreaArgs args;
+		if (!JsBinding::Decode (param, WorkingAreaArgsFields, args)) {
 			// Для совместимости: если передано одно число — считаем его индексом существующего макета
-			if (v->GetType () == JS::Value::INTEGER)
-				layoutIndex = static_cast<Int32> (v->GetInteger ());
+			if (GS::Ref<JS::Value> v = GS::DynamicCast<JS::Value> (param)) {
+				if (v->GetType () == JS::Value::INTEGER)
+					args.layoutIndex = static_cast<Int32> (v->GetInteger ());
+			}
 		}
 
-		double w = 0.0, h = 0.0;
-		bool ok = false;
-		if (mode == "master" || mode == "template") {
-			ok = GetLayoutWorkingAreaByMasterIndex (masterIndex, w, h);
+		WorkingAreaResult result;
+		if (JsBinding::KeyEquals (args.mode, "master") || JsBinding::KeyEquals (args.mode, "template")) {
+			result.ok = GetLayoutWorkingAreaByMasterIndex (args.masterIndex, result.widthMm, result.heightMm);
 		} else {
-			ok = GetLayoutWorkingAreaByExistingIndex (layoutIndex, w, h);
+			result.ok = GetLayoutWorkingAreaByExistingIndex (args.layoutIndex, result.widthMm, result.heightMm);
 		}
+		return JsBinding::Encode (result, WorkingAreaResultFields);
+		});
 
-		GS::Ref<JS::Object> result = new JS::Object ();
-		result->AddItem ("ok", new JS::Value (ok));
-		result->AddItem ("widthMm", new JS::Value (w));
-		result->AddItem ("heightMm", new JS::Value (h));
-		return result;
-		}));
-
-	jsACAPI->AddItem(new JS::Function("GetDrawingScale", [](GS::Ref<JS::Base>) {
+	AddBridgeFunction(jsACAPI, "GetDrawingScale", [](GS::Ref<JS::Base>) {
 		return new JS::Value(LayoutHelper::GetCurrentDrawingScale());
-		}));
+		});
 
-	jsACAPI->AddItem(new JS::Function("GetPlaceableViews", [](GS::Ref<JS::Base>) {
+	AddBridgeFunction(jsACAPI, "GetPlaceableViews", [](GS::Ref<JS::Base>) {
 		const GS::Array<LayoutHelper::PlaceableViewItem> views = LayoutHelper::GetPlaceableViews();
 		GS::Ref<JS::Array> jsArr = new JS::Array();
 		for (UIndex i = 0; i < views.GetSize(); ++i) {
@@ -587,109 +1152,26 @@ void BrowserRepl::RegisterACAPIJavaScriptObject(DG::Browser& targetBrowser)
 			jsArr->AddItem(obj);
 		}
 		return jsArr;
-		}));
+		});
 
-	jsACAPI->AddItem(new JS::Function("PlaceOnLayout", [](GS::Ref<JS::Base> param) {
+	AddBridgeFunction(jsACAPI, "PlaceOnLayout", [](GS::Ref<JS::Base> param) {
 		LayoutHelper::PlaceParams p = {};
 		p.masterLayoutIndex = -1;
 		p.layoutIndex = 0;
 		p.scale = 100.0;
-		if (GS::Ref<JS::Object> obj = GS::DynamicCast<JS::Object>(param)) {
-			const GS::HashTable<GS::UniString, GS::Ref<JS::Base>>& tbl = obj->GetItemTable();
-			GS::Ref<JS::Base> item;
-			if (tbl.Get("masterLayoutIndex", &item)) {
-				if (GS::Ref<JS::Value> vv = GS::DynamicCast<JS::Value>(item))
-					p.masterLayoutIndex = static_cast<Int32>(vv->GetInteger());
-			}
-			if (tbl.Get("layoutIndex", &item)) {
-				if (GS::Ref<JS::Value> vv = GS::DynamicCast<JS::Value>(item))
-					p.layoutIndex = static_cast<Int32>(vv->GetInteger());
-			}
-			if (tbl.Get("scale", &item))
-				p.scale = GetDoubleFromJs(GS::DynamicCast<JS::Value>(item), 100.0);
-			if (tbl.Get("drawingName", &item))
-				p.drawingName = GetStringFromJavaScriptVariable(item);
-			if (tbl.Get("layoutName", &item))
-				p.layoutName = GetStringFromJavaScriptVariable(item);
-			if (tbl.Get("targetFolder", &item))
-				p.targetFolder = GetStringFromJavaScriptVariable(item);
-
-			// Точка привязки вида на макете (радиокнопки LB/LT/RT/RB/MM)
-			// Читаем максимально устойчиво: сначала строку, при неудаче — возможное целочисленное значение.
-			if (!tbl.Get("anchorPosition", &item)) {
-				// fallback на ключ "anchor" на случай изменений в HTML
-				tbl.Get("anchor", &item);
-			}
-			if (item != nullptr) {
-				GS::UniString anchorStr = GetStringFromJavaScriptVariable(item);
-				anchorStr.Trim ();
-				if (anchorStr == "LT") {
-					p.anchorPosition = LayoutHelper::PlaceParams::Anchor::LeftTop;
-				} else if (anchorStr == "RT") {
-					p.anchorPosition = LayoutHelper::PlaceParams::Anchor::RightTop;
-				} else if (anchorStr == "RB") {
-					p.anchorPosition = LayoutHelper::PlaceParams::Anchor::RightBottom;
-				} else if (anchorStr == "MM") {
-					p.anchorPosition = LayoutHelper::PlaceParams::Anchor::Middle;
-				} else if (anchorStr == "LB") {
-					p.anchorPosition = LayoutHelper::PlaceParams::Anchor::LeftBottom;
-				} else if (anchorStr.IsEmpty ()) {
-					// Возможен вариант, когда значение приходит как число (0..4)
-					if (GS::Ref<JS::Value> vv = GS::DynamicCast<JS::Value> (item)) {
-						if (vv->GetType () == JS::Value::INTEGER) {
-							switch (vv->GetInteger ()) {
-								case 1: p.anchorPosition = LayoutHelper::PlaceParams::Anchor::LeftTop;    break;
-								case 2: p.anchorPosition = LayoutHelper::PlaceParams::Anchor::RightTop;   break;
-								case 3: p.anchorPosition = LayoutHelper::PlaceParams::Anchor::RightBottom;break;
-								case 4: p.anchorPosition = LayoutHelper::PlaceParams::Anchor::Middle;     break;
-								default: p.anchorPosition = LayoutHelper::PlaceParams::Anchor::LeftBottom;break;
-							}
-						}
-					}
-				}
-				// Если anchorStr не распознан и не число — остаётся значение по умолчанию (LeftBottom)
-			}
-			if (tbl.Get("fitScaleToLayout", &item)) {
-				if (GS::Ref<JS::Value> vv = GS::DynamicCast<JS::Value>(item))
-					p.fitScaleToLayout = vv->GetBool();
+		{
+			TRACE_SPAN("decode PlaceParams", "bridge");
+			if (!JsBinding::Decode(param, PlaceParamsFields, p)) {
+				if (GS::Ref<JS::Value> v = GS::DynamicCast<JS::Value>(param))
+					p.layoutIndex = static_cast<Int32>(v->GetInteger());
 			}
-			if (tbl.Get("useMarqueeAsBoundary", &item)) {
-				if (GS::Ref<JS::Value> vv = GS::DynamicCast<JS::Value>(item))
-					p.useMarqueeAsBoundary = vv->GetBool();
-			}
-			// Палитра «Организация чертежей»: вид по GUID и область сетки
-			if (tbl.Get("placeViewGuid", &item)) {
-				GS::UniString guidStr = GetStringFromJavaScriptVariable(item);
-				if (!guidStr.IsEmpty())
-					p.placeViewGuid = APIGuidFromString(guidStr.ToCStr().Get());
-			}
-			if (tbl.Get("useGridRegion", &item)) {
-				if (GS::Ref<JS::Value> vv = GS::DynamicCast<JS::Value>(item))
-					p.useGridRegion = vv->GetBool();
-			}
-			if (tbl.Get("gridRows", &item))
-				p.gridRows = static_cast<Int32>(GetDoubleFromJs(GS::DynamicCast<JS::Value>(item), 1));
-			if (tbl.Get("gridCols", &item))
-				p.gridCols = static_cast<Int32>(GetDoubleFromJs(GS::DynamicCast<JS::Value>(item), 1));
-			if (tbl.Get("gridGapMm", &item))
-				p.gridGapMm = GetDoubleFromJs(GS::DynamicCast<JS::Value>(item), 0);
-			if (tbl.Get("regionStartRow", &item))
-				p.regionStartRow = static_cast<Int32>(GetDoubleFromJs(GS::DynamicCast<JS::Value>(item), 0));
-			if (tbl.Get("regionStartCol", &item))
-				p.regionStartCol = static_cast<Int32>(GetDoubleFromJs(GS::DynamicCast<JS::Value>(item), 0));
-			if (tbl.Get("regionSpanRows", &item))
-				p.regionSpanRows = static_cast<Int32>(GetDoubleFromJs(GS::DynamicCast<JS::Value>(item), 1));
-			if (tbl.Get("regionSpanCols", &item))
-				p.regionSpanCols = static_cast<Int32>(GetDoubleFromJs(GS::DynamicCast<JS::Value>(item), 1));
-		} else if (GS::Ref<JS::Value> v = GS::DynamicCast<JS::Value>(param)) {
-			p.layoutIndex = static_cast<Int32>(v->GetInteger());
 		}
 		const bool success = LayoutHelper::PlaceSelectionOnLayoutWithParams(p);
 		return ConvertToJavaScriptVariable(success);
-		}));
+		});
 
 	// --- Help / Palette control ---
-	jsACAPI->AddItem(new JS::Function("OpenHelp", [](GS::Ref<JS::Base> param) {
+	AddBridgeFunction(jsACAPI, "OpenHelp", [](GS::Ref<JS::Base> param) {
 		GS::UniString url;
 		if (GS::Ref<JS::Value> v = GS::DynamicCast<JS::Value>(param)) {
 			if (v->GetType() == JS::Value::STRING) url = v->GetString();
@@ -697,30 +1179,180 @@ void BrowserRepl::RegisterACAPIJavaScriptObject(DG::Browser& targetBrowser)
 		if (url.IsEmpty()) url = "https://landscape.227.info/help/start";
 		HelpPalette::ShowWithURL(url);
 		return new JS::Value(true);
-		}));
+		});
 
-	jsACAPI->AddItem(new JS::Function("OpenIdLayersPalette", [](GS::Ref<JS::Base>) {
+	AddBridgeFunction(jsACAPI, "OpenIdLayersPalette", [](GS::Ref<JS::Base>) {
 		IdLayersPalette::ShowPalette();
 		return new JS::Value(true);
-		}));
+		});
 
-	jsACAPI->AddItem(new JS::Function("OpenSelectionDetailsPalette", [](GS::Ref<JS::Base>) {
+	AddBridgeFunction(jsACAPI, "OpenSelectionDetailsPalette", [](GS::Ref<JS::Base>) {
 		SelectionDetailsPalette::ShowPalette();
 		return new JS::Value(true);
-		}));
+		});
 
-	jsACAPI->AddItem(new JS::Function("OpenToLayoutPalette", [](GS::Ref<JS::Base>) {
+	AddBridgeFunction(jsACAPI, "OpenToLayoutPalette", [](GS::Ref<JS::Base>) {
 		ToLayoutPalette::ShowPalette();
 		return new JS::Value(true);
-		}));
+		});
 
-	jsACAPI->AddItem(new JS::Function("ClosePalette", [](GS::Ref<JS::Base>) {
+	AddBridgeFunction(jsACAPI, "ClosePalette", [](GS::Ref<JS::Base>) {
 		if (BrowserRepl::HasInstance() && BrowserRepl::GetInstance().IsVisible())
 			BrowserRepl::GetInstance().Hide();
 		return new JS::Value(true);
-		}));
+		});
+
+#ifdef DEBUG_UI_LOGS
+	// Микробенчмарк передачи GUID: строки vs упакованный base64 (только отладочная сборка)
+	// Вход: количество GUID; Выход: { count, stringEncodeMs, stringDecodeMs, packedEncodeMs, packedDecodeMs, stringChars, packedChars }
+	AddBridgeFunction(jsACAPI, "BenchGuidTransport", [](GS::Ref<JS::Base> param) {
+		const Int32 count = static_cast<Int32> (GetDoubleFromJs (param, 40000.0));
+		GS::Array<API_Guid> source;
+		source.SetCapacity (count > 0 ? count : 0);
+		for (Int32 i = 0; i < count; ++i) {
+			GS::Guid guid;
+			guid.Generate ();
+			source.Push (GSGuid2APIGuid (guid));
+		}
+
+		using Clock = std::chrono::steady_clock;
+		auto elapsedMs = [] (Clock::time_point from) {
+			return std::chrono::duration<double, std::milli> (Clock::now () - from).count ();
+		};
+
+		Clock::time_point t = Clock::now ();
+		GS::Array<GS::UniString> strings;
+		strings.SetCapacity (source.GetSize ());
+		for (const API_Guid& guid : source)
+			strings.Push (APIGuidToString (guid));
+		const double stringEncodeMs = elapsedMs (t);
+
+		t = Clock::now ();
+		GS::Array<API_Guid> fromStrings;
+		fromStrings.SetCapacity (strings.GetSize ());
+		for (const GS::UniString& str : strings)
+			fromStrings.Push (APIGuidFromString (str.ToCStr ().Get ()));
+		const double stringDecodeMs = elapsedMs (t);
+
+		t = Clock::now ();
+		const GS::UniString packed = GuidCodec::Encode (source);
+		const double packedEncodeMs = elapsedMs (t);
+
+		t = Clock::now ();
+		GS::Array<API_Guid> fromPacked;
+		const bool packedOk = GuidCodec::Decode (packed, fromPacked) && fromPacked == source;
+		const double packedDecodeMs = elapsedMs (t);
+
+		GS::Ref<JS::Object> result = new JS::Object ();
+		result->AddItem ("count", new JS::Value (count));
+		result->AddItem ("stringEncodeMs", new JS::Value (stringEncodeMs));
+		result->AddItem ("stringDecodeMs", new JS::Value (stringDecodeMs));
+		result->AddItem ("packedEncodeMs", new JS::Value (packedEncodeMs));
+		result->AddItem ("packedDecodeMs", new JS::Value (packedDecodeMs));
+		result->AddItem ("stringChars", new JS::Value (static_cast<Int32> (source.GetSize () * 36)));
+		result->AddItem ("packedChars", new JS::Value (static_cast<Int32> (packed.GetLength ())));
+		result->AddItem ("roundTripOk", new JS::Value (packedOk && fromStrings == source));
+		return result;
+		});
+
+	// Стоимость разбора PlaceParams: один проход JsBinding::Decode против прежнего ручного разбора
+	// (DecodePlaceParamsLegacy — поиск каждого ключа и преобразование значений). Вход: число повторов;
+	// Выход: { iterations, bindingNsPerDecode, legacyNsPerDecode, sameResult }
+	AddBridgeFunction(jsACAPI, "BenchPlaceParamsDecode", [](GS::Ref<JS::Base> param) {
+		const Int32 iterations = static_cast<Int32> (GetDoubleFromJs (param, 100000.0));
+
+		// Тот же набор ключей, что отправляет палитра «Организация чертежей»
+		GS::Ref<JS::Object> payload = new JS::Object ();
+		payload->AddItem ("masterLayoutIndex", new JS::Value (-1));
+		payload->AddItem ("layoutIndex", new JS::Value (3));
+		payload->AddItem ("scale", new JS::Value (50.0));
+		payload->AddItem ("drawingName", new JS::Value (GS::UniString ("План 1-го этажа")));
+		payload->AddItem ("layoutName", new JS::Value (GS::UniString ("Лист 1")));
+		payload->AddItem ("targetFolder", new JS::Value (GS::UniString ("Планы")));
+		payload->AddItem ("anchorPosition", new JS::Value (GS::UniString ("MM")));
+		payload->AddItem ("fitScaleToLayout", new JS::Value (true));
+		payload->AddItem ("useMarqueeAsBoundary", new JS::Value (false));
+		payload->AddItem ("placeViewGuid", new JS::Value (APIGuidToString (GSGuid2APIGuid (GS::Guid ()))));
+		payload->AddItem ("useGridRegion", new JS::Value (true));
+		payload->AddItem ("gridRows", new JS::Value (2));
+		payload->AddItem ("gridCols", new JS::Value (3));
+		payload->AddItem ("gridGapMm", new JS::Value (5.0));
+		payload->AddItem ("regionStartRow", new JS::Value (0));
+		payload->AddItem ("regionStartCol", new JS::Value (1));
+		payload->AddItem ("regionSpanRows", new JS::Value (1));
+		payload->AddItem ("regionSpanCols", new JS::Value (2));
+		GS::Ref<JS::Base> payloadBase = payload;
+
+		using Clock = std::chrono::steady_clock;
+		auto elapsedNs = [] (Clock::time_point from) {
+			return std::chrono::duration<double, std::nano> (Clock::now () - from).count ();
+		};
+
+		// Умолчания — как в PlaceOnLayout
+		auto makeDefault = [] () {
+			LayoutHelper::PlaceParams p = {};
+			p.masterLayoutIndex = -1;
+			p.layoutIndex = 0;
+			p.scale = 100.0;
+			return p;
+		};
+
+		Int32 checksum = 0;
+		LayoutHelper::PlaceParams bindingResult = makeDefault ();
+		Clock::time_point t = Clock::now ();
+		for (Int32 i = 0; i < iterations; ++i) {
+			LayoutHelper::PlaceParams p = makeDefault ();
+			JsBinding::Decode (payloadBase, PlaceParamsFields, p);
+			checksum += p.gridCols;
+			if (i == 0)
+				bindingResult = p;
+		}
+		const double bindingNs = elapsedNs (t);
+
+		LayoutHelper::PlaceParams legacyResult = makeDefault ();
+		t = Clock::now ();
+		for (Int32 i = 0; i < iterations; ++i) {
+			LayoutHelper::PlaceParams p = makeDefault ();
+			DecodePlaceParamsLegacy (payloadBase, p);
+			checksum += p.gridCols;
+			if (i == 0)
+				legacyResult = p;
+		}
+		const double legacyNs = elapsedNs (t);
+
+		// Оба разбора должны дать одно и то же, иначе сравнение времени бессмысленно
+		const bool sameResult = iterations <= 0 || (
+			bindingResult.masterLayoutIndex == legacyResult.masterLayoutIndex &&
+			bindingResult.layoutIndex == legacyResult.layoutIndex &&
+			bindingResult.scale == legacyResult.scale &&
+			bindingResult.drawingName == legacyResult.drawingName &&
+			bindingResult.layoutName == legacyResult.layoutName &&
+			bindingResult.targetFolder == legacyResult.targetFolder &&
+			bindingResult.anchorPosition == legacyResult.anchorPosition &&
+			bindingResult.fitScaleToLayout == legacyResult.fitScaleToLayout &&
+			bindingResult.useMarqueeAsBoundary == legacyResult.useMarqueeAsBoundary &&
+			bindingResult.placeViewGuid == legacyResult.placeViewGuid &&
+			bindingResult.useGridRegion == legacyResult.useGridRegion &&
+			bindingResult.gridRows == legacyResult.gridRows &&
+			bindingResult.gridCols == legacyResult.gridCols &&
+			bindingResult.gridGapMm == legacyResult.gridGapMm &&
+			bindingResult.regionStartRow == legacyResult.regionStartRow &&
+			bindingResult.regionStartCol == legacyResult.regionStartCol &&
+			bindingResult.regionSpanRows == legacyResult.regionSpanRows &&
+			bindingResult.regionSpanCols == legacyResult.regionSpanCols);
+
+		const double divisor = iterations > 0 ? static_cast<double> (iterations) : 1.0;
+		GS::Ref<JS::Object> result = new JS::Object ();
+		result->AddItem ("iterations", new JS::Value (iterations));
+		result->AddItem ("bindingNsPerDecode", new JS::Value (bindingNs / divisor));
+		result->AddItem ("legacyNsPerDecode", new JS::Value (legacyNs / divisor));
+		result->AddItem ("sameResult", new JS::Value (sameResult));
+		result->AddItem ("checksum", new JS::Value (checksum));
+		return result;
+		});
+#endif
 
-	jsACAPI->AddItem(new JS::Function("LogMessage", [](GS::Ref<JS::Base> param) {
+	AddBridgeFunction(jsACAPI, "LogMessage", [](GS::Ref<JS::Base> param) {
 		if (GS::Ref<JS::Value> v = GS::DynamicCast<JS::Value>(param)) {
 			if (v->GetType() == JS::Value::STRING) {
 				ACAPI_WriteReport("[JS] ", false);
@@ -728,7 +1360,183 @@ void BrowserRepl::RegisterACAPIJavaScriptObject(DG::Browser& targetBrowser)
 			}
 		}
 		return new JS::Value(true);
-		}));
+		});
+
+	// --- Статистика моста ---
+	// Выход: { enabled, functions: [{ name, calls, meanMs, p50Ms, p95Ms, p99Ms, maxMs, requestBytes, responseBytes }] }
+	AddBridgeFunction(jsACAPI, "GetPerfStats", [](GS::Ref<JS::Base>) {
+		GS::Ref<JS::Array> functions = new JS::Array();
+		for (const BridgeStats::FunctionSummary& item : BridgeStats::GetSummary()) {
+			if (item.calls == 0)
+				continue;
+			GS::Ref<JS::Object> obj = new JS::Object();
+			obj->AddItem("name", new JS::Value(item.name));
+			obj->AddItem("calls", new JS::Value(static_cast<double>(item.calls)));
+			obj->AddItem("meanMs", new JS::Value(item.meanMs));
+			obj->AddItem("p50Ms", new JS::Value(item.p50Ms));
+			obj->AddItem("p95Ms", new JS::Value(item.p95Ms));
+			obj->AddItem("p99Ms", new JS::Value(item.p99Ms));
+			obj->AddItem("maxMs", new JS::Value(item.maxMs));
+			obj->AddItem("requestBytes", new JS::Value(static_cast<double>(item.requestBytes)));
+			obj->AddItem("responseBytes", new JS::Value(static_cast<double>(item.responseBytes)));
+			functions->AddItem(obj);
+		}
+		GS::Ref<JS::Object> result = new JS::Object();
+		result->AddItem("enabled", new JS::Value(BridgeStats::IsEnabled()));
+		result->AddItem("functions", functions);
+		return result;
+		});
+
+	// Вход: true/false — включить/выключить сбор; счётчики при этом не сбрасываются
+	AddBridgeFunction(jsACAPI, "SetPerfStatsEnabled", [](GS::Ref<JS::Base> param) {
+		if (GS::Ref<JS::Value> v = GS::DynamicCast<JS::Value>(param)) {
+			if (v->GetType() == JS::Value::BOOL)
+				BridgeStats::SetEnabled(v->GetBool());
+		}
+		return new JS::Value(BridgeStats::IsEnabled());
+		});
+
+	AddBridgeFunction(jsACAPI, "ResetPerfStats", [](GS::Ref<JS::Base>) {
+		BridgeStats::Reset();
+		return new JS::Value(true);
+		});
+
+	// Профиль вызовов ACAPI (сборка с TOLAYOUT_API_PROFILE): вывести рейтинг в отчёт сессии.
+	// Вход: true — после вывода обнулить счётчики. Выход: собран ли профилировщик
+	AddBridgeFunction(jsACAPI, "PrintApiProfile", [](GS::Ref<JS::Base> param) {
+		ApiProfiler::PrintReport();
+		if (GS::Ref<JS::Value> v = GS::DynamicCast<JS::Value>(param)) {
+			if (v->GetType() == JS::Value::BOOL && v->GetBool())
+				ApiProfiler::Reset();
+		}
+		return new JS::Value(ApiProfiler::IsCompiledIn());
+		});
+
+	// Запись вызовов ACAPI для Tools/ApiReplay (сборка с TOLAYOUT_API_RECORD).
+	// Вход: true — начать запись в tolayout_api.rec (папка логов), false — остановить.
+	// Выход: путь к файлу при старте, иначе ""
+	AddBridgeFunction(jsACAPI, "SetApiRecording", [](GS::Ref<JS::Base> param) {
+		bool enable = false;
+		if (GS::Ref<JS::Value> v = GS::DynamicCast<JS::Value>(param)) {
+			if (v->GetType() == JS::Value::BOOL) enable = v->GetBool();
+		}
+		if (!ApiRecorder::IsCompiledIn()) {
+			ACAPI_WriteReport("[ApiRecorder] Запись вызовов не включена в сборку (TOLAYOUT_API_RECORD).", false);
+			return new JS::Value(GS::UniString());
+		}
+		if (!enable) {
+			ACAPI_WriteReport("[ApiRecorder] Записано вызовов: %llu", false, static_cast<unsigned long long>(ApiRecorder::GetRecordedCallCount()));
+			ApiRecorder::Stop();
+			return new JS::Value(GS::UniString());
+		}
+		const GS::UniString path = LicenseManager::GetLogDirectory() + "\\tolayout_api.rec";
+		return new JS::Value(ApiRecorder::Start(path) ? path : GS::UniString());
+		});
+
+	// --- Трассировка (Chrome trace-event) ---
+	// Вход: bool — включить/выключить запись интервалов. Выход: текущее состояние
+	AddBridgeFunction(jsACAPI, "TraceSetEnabled", [](GS::Ref<JS::Base> param) {
+		if (GS::Ref<JS::Value> v = GS::DynamicCast<JS::Value>(param)) {
+			if (v->GetType() == JS::Value::BOOL)
+				TraceLog::SetEnabled(v->GetBool());
+		}
+		return new JS::Value(TraceLog::IsEnabled());
+		});
+
+	// Интервал со стороны палитры: { name, durationMs, cat? }. Интервал заканчивается
+	// в момент вызова и ложится на отдельную дорожку "Palette (JS)"
+	AddBridgeFunction(jsACAPI, "TraceSpan", [](GS::Ref<JS::Base> param) {
+		if (!TraceLog::IsEnabled())
+			return new JS::Value(false);
+
+		GS::Ref<JS::Object> obj = GS::DynamicCast<JS::Object>(param);
+		if (obj == nullptr)
+			return new JS::Value(false);
+
+		const GS::HashTable<GS::UniString, GS::Ref<JS::Base>>& table = obj->GetItemTable();
+		GS::UniString name("palette");
+		GS::UniString category("palette");
+		double durationMs = 0.0;
+		GS::Ref<JS::Base> item;
+		if (table.Get("name", &item)) {
+			if (GS::Ref<JS::Value> v = GS::DynamicCast<JS::Value>(item))
+				if (v->GetType() == JS::Value::STRING) name = v->GetString();
+		}
+		if (table.Get("cat", &item)) {
+			if (GS::Ref<JS::Value> v = GS::DynamicCast<JS::Value>(item))
+				if (v->GetType() == JS::Value::STRING) category = v->GetString();
+		}
+		if (table.Get("durationMs", &item)) {
+			if (GS::Ref<JS::Value> v = GS::DynamicCast<JS::Value>(item)) {
+				if (v->GetType() == JS::Value::DOUBLE) durationMs = v->GetDouble();
+				else if (v->GetType() == JS::Value::INTEGER) durationMs = static_cast<double>(v->GetInteger());
+			}
+		}
+
+		const UInt64 endUs = TraceLog::NowUs();
+		UInt64 durationUs = durationMs > 0.0 ? static_cast<UInt64>(durationMs * 1000.0) : 0;
+		if (durationUs > endUs)
+			durationUs = endUs;
+		TraceLog::AddSpan(name.ToCStr(CC_UTF8).Get(), category.ToCStr(CC_UTF8).Get(), endUs - durationUs, durationUs, TraceLog::Track::Palette);
+		return new JS::Value(true);
+		});
+
+	// Выгрузка буфера в tolayout_trace.json (папка логов). Выход: путь к файлу или ""
+	AddBridgeFunction(jsACAPI, "TraceExport", [](GS::Ref<JS::Base>) {
+		const GS::UniString path = LicenseManager::GetLogDirectory() + "\\tolayout_trace.json";
+		return new JS::Value(TraceLog::WriteChromeTrace(path) ? path : GS::UniString());
+		});
+
+	AddBridgeFunction(jsACAPI, "TraceClear", [](GS::Ref<JS::Base>) {
+		TraceLog::Clear();
+		return new JS::Value(true);
+		});
+
+	// --- Batch API ---
+	// Вход: [{ fn: "GetLayoutsTree", args: ... }, ...]; вызовы выполняются по порядку
+	// с общим кешем запроса (списки макетов/шаблонов/видов читаются один раз).
+	// Выход: [{ fn, ok: true, result } | { fn, ok: false, error }, ...] — одним ответом
+	AddBridgeFunction(jsACAPI, "Batch", [](GS::Ref<JS::Base> param) {
+		GS::Ref<JS::Array> results = new JS::Array();
+		GS::Ref<JS::Array> calls = GS::DynamicCast<JS::Array>(param);
+		if (calls == nullptr)
+			return results;
+
+		LayoutHelper::RequestCacheScope cacheScope;
+		const GS::HashTable<GS::UniString, BridgeFunction>& functions = GetBridgeFunctions();
+
+		for (const GS::Ref<JS::Base>& call : calls->GetItemArray()) {
+			GS::UniString fnName;
+			GS::Ref<JS::Base> args;
+			if (GS::Ref<JS::Object> obj = GS::DynamicCast<JS::Object>(call)) {
+				const auto& tbl = obj->GetItemTable();
+				GS::Ref<JS::Base> item;
+				if (tbl.Get("fn", &item)) {
+					GS::Ref<JS::Value> v = GS::DynamicCast<JS::Value>(item);
+					if (v != nullptr && v->GetType() == JS::Value::STRING)
+						fnName = v->GetString();
+				}
+				tbl.Get("args", &args);
+			}
+
+			GS::Ref<JS::Object> entry = new JS::Object();
+			entry->AddItem("fn", new JS::Value(fnName));
+
+			const BridgeFunction* function = functions.GetPtr(fnName);
+			if (function == nullptr || fnName == "Batch") {
+				entry->AddItem("ok", new JS::Value(false));
+				entry->AddItem("error", new JS::Value(GS::UniString("Unknown function: ") + fnName));
+				results->AddItem(entry);
+				continue;
+			}
+
+			GS::Ref<JS::Base> result = (*function)(args);
+			entry->AddItem("ok", new JS::Value(true));
+			entry->AddItem("result", result != nullptr ? result : GS::Ref<JS::Base>(new JS::Value(false)));
+			results->AddItem(entry);
+		}
+		return results;
+		});
 
 	// --- Register object in the browser ---
 	targetBrowser.RegisterAsynchJSObject(jsACAPI);
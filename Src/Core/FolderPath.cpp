@@ -0,0 +1,47 @@
+#include "FolderPath.hpp"
+
+namespace FolderPath {
+
+static bool StartsWith (const std::string& str, const char* prefix)
+{
+    return str.compare (0, std::char_traits<char>::length (prefix), prefix) == 0;
+}
+
+std::vector<std::string> Split (const std::string& path)
+{
+    std::vector<std::string> parts;
+    std::string::size_type start = 0;
+    while (start <= path.size ()) {
+        std::string::size_type end = path.find ('/', start);
+        if (end == std::string::npos)
+            end = path.size ();
+        if (end > start)
+            parts.emplace_back (path, start, end - start);
+        start = end + 1;
+    }
+    return parts;
+}
+
+std::string RemoveRootPrefix (const std::string& path)
+{
+    static const char* const prefixes[] = { "Слои/", "Layers/" };
+    for (const char* prefix : prefixes) {
+        if (StartsWith (path, prefix))
+            return path.substr (std::char_traits<char>::length (prefix));
+    }
+    if (path == "Слои" || path == "Layers")
+        return std::string ();
+    return path;
+}
+
+std::vector<std::string> RemoveRootFolder (const std::vector<std::string>& parts)
+{
+    if (parts.empty ())
+        return parts;
+    const std::string& first = parts[0];
+    if (first == "Слои" || first == "Layers" || first == "layers" || first == "LAYERS")
+        return std::vector<std::string> (parts.begin () + 1, parts.end ());
+    return parts;
+}
+
+} // namespace FolderPath
@@ -0,0 +1,21 @@
+#ifndef FOLDERPATH_HPP
+#define FOLDERPATH_HPP
+
+#include <string>
+#include <vector>
+
+// Пути папок атрибутов ("Группа/Подгруппа") в UTF-8. Без заголовков DevKit.
+namespace FolderPath {
+
+    // Разбить путь по '/'; пустые части отбрасываются
+    std::vector<std::string> Split (const std::string& path);
+
+    // Убрать корневую папку "Слои/" или "Layers/" в начале пути; сам корень -> ""
+    std::string RemoveRootPrefix (const std::string& path);
+
+    // Убрать корневую папку "Слои"/"Layers" из начала разобранного пути
+    std::vector<std::string> RemoveRootFolder (const std::vector<std::string>& parts);
+
+} // namespace FolderPath
+
+#endif // FOLDERPATH_HPP
@@ -0,0 +1,72 @@
+#include "LayerVolumes.hpp"
+
+namespace LayerVolumes {
+
+// Множитель, приводящий сумму слоёв к объёму элемента (1 — если нормировать не к чему)
+static double NormalizationFactor (double elementVolume, double rawTotal)
+{
+    return (rawTotal > 0.0 && elementVolume > 0.0) ? elementVolume / rawTotal : 1.0;
+}
+
+static double RawTotal (const std::vector<Component>& components)
+{
+    double total = 0.0;
+    for (const Component& component : components)
+        total += component.volume;
+    return total;
+}
+
+void Aggregator::Reset ()
+{
+    // clear сохраняет корзины таблицы и ёмкость вектора
+    slotByMaterial.clear ();
+    values.clear ();
+}
+
+MaterialVolume& Aggregator::Slot (std::int32_t material)
+{
+    const auto inserted = slotByMaterial.emplace (material, values.size ());
+    if (inserted.second) {
+        values.emplace_back ();
+        values.back ().material = material;
+    }
+    return values[inserted.first->second];
+}
+
+void Aggregator::Add (const std::vector<Component>& gross, double grossVolume,
+                      const std::vector<Component>& net, double netVolume)
+{
+    // Множители известны до раскладки, поэтому нормирование идёт в том же проходе
+    const double grossFactor = NormalizationFactor (grossVolume, RawTotal (gross));
+    const double netFactor = NormalizationFactor (netVolume, RawTotal (net));
+
+    for (const Component& component : gross) {
+        if (component.material > 0)
+            Slot (component.material).grossVolume += component.volume * grossFactor;
+    }
+    for (const Component& component : net) {
+        if (component.material > 0)
+            Slot (component.material).netVolume += component.volume * netFactor;
+    }
+}
+
+std::vector<MaterialVolume> Aggregator::GetResult () const
+{
+    std::vector<MaterialVolume> result;
+    result.reserve (values.size ());
+    ForEach ([&] (const MaterialVolume& value) { result.push_back (value); });
+    return result;
+}
+
+std::vector<MaterialVolume> Distribute (const std::vector<Component>& gross, double grossVolume,
+                                        const std::vector<Component>& net, double netVolume)
+{
+    if (gross.empty () && net.empty ())
+        return std::vector<MaterialVolume> ();
+
+    Aggregator aggregator;
+    aggregator.Add (gross, grossVolume, net, netVolume);
+    return aggregator.GetResult ();
+}
+
+} // namespace LayerVolumes
@@ -0,0 +1,60 @@
+#ifndef LAYERVOLUMES_HPP
+#define LAYERVOLUMES_HPP
+
+#include <cstdint>
+#include <unordered_map>
+#include <vector>
+
+// Послойные объёмы многослойной конструкции по материалам до и после SEO. Без заголовков DevKit.
+namespace LayerVolumes {
+
+    /** Слой конструкции из API_CompositeQuantity: индекс строительного материала и объём */
+    struct Component {
+        std::int32_t    material = 0;
+        double          volume = 0.0;
+    };
+
+    struct MaterialVolume {
+        std::int32_t    material = 0;
+        double          grossVolume = 0.0;
+        double          netVolume = 0.0;
+    };
+
+    // Суммы объёмов по материалам для одного или многих элементов: один проход по слоям каждого
+    // элемента, материал -> позиция через хеш, порядок — первое появление. Память таблицы и
+    // результата переиспользуется после Reset, поэтому один накопитель обслуживает весь проход.
+    class Aggregator {
+    public:
+        void Reset ();
+
+        // Слои элемента (только положительные индексы материалов); сумма слоёв нормируется
+        // к объёму элемента grossVolume / netVolume (0 — объём неизвестен)
+        void Add (const std::vector<Component>& gross, double grossVolume,
+                  const std::vector<Component>& net, double netVolume);
+
+        // Материалы с ненулевым объёмом хотя бы в одном состоянии, без копирования результата
+        template <typename Visitor>
+        void ForEach (Visitor&& visitor) const
+        {
+            for (const MaterialVolume& value : values) {
+                if (value.grossVolume != 0.0 || value.netVolume != 0.0)
+                    visitor (value);
+            }
+        }
+
+        std::vector<MaterialVolume> GetResult () const;
+
+    private:
+        MaterialVolume& Slot (std::int32_t material);
+
+        std::unordered_map<std::int32_t, std::size_t>   slotByMaterial;
+        std::vector<MaterialVolume>                     values;
+    };
+
+    // Объёмы по материалам одного элемента (Aggregator на один элемент)
+    std::vector<MaterialVolume> Distribute (const std::vector<Component>& gross, double grossVolume,
+                                            const std::vector<Component>& net, double netVolume);
+
+} // namespace LayerVolumes
+
+#endif // LAYERVOLUMES_HPP
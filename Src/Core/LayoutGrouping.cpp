@@ -0,0 +1,29 @@
+#include "LayoutGrouping.hpp"
+
+#include <unordered_map>
+
+namespace LayoutGrouping {
+
+const char* const UngroupedName = "Без папки";
+
+std::vector<Group> GroupByFolder (const std::vector<std::string>& layoutNames)
+{
+    std::vector<Group> groups;
+    std::unordered_map<std::string, std::uint32_t> groupByName;   // имя группы -> позиция в groups
+
+    for (std::uint32_t i = 0; i < layoutNames.size (); ++i) {
+        const std::string& fullName = layoutNames[i];
+        const std::string::size_type slashPos = fullName.find ('/');
+        std::string groupName = (slashPos != std::string::npos) ? fullName.substr (0, slashPos) : std::string (UngroupedName);
+
+        const auto inserted = groupByName.emplace (groupName, static_cast<std::uint32_t> (groups.size ()));
+        if (inserted.second) {
+            groups.emplace_back ();
+            groups.back ().name = std::move (groupName);
+        }
+        groups[inserted.first->second].indices.push_back (i);
+    }
+    return groups;
+}
+
+} // namespace LayoutGrouping
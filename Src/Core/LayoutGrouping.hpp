@@ -0,0 +1,24 @@
+#ifndef LAYOUTGROUPING_HPP
+#define LAYOUTGROUPING_HPP
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+// Группировка макетов по папке в имени ("Папка/Макет") для дерева палитры. Без заголовков DevKit.
+namespace LayoutGrouping {
+
+    // Группа для имён без '/'
+    extern const char* const UngroupedName;
+
+    struct Group {
+        std::string                 name;
+        std::vector<std::uint32_t>  indices;    // индексы в исходном списке имён
+    };
+
+    // Группы в порядке первого появления, внутри группы — исходный порядок макетов
+    std::vector<Group> GroupByFolder (const std::vector<std::string>& layoutNames);
+
+} // namespace LayoutGrouping
+
+#endif // LAYOUTGROUPING_HPP
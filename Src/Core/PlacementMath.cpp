@@ -0,0 +1,100 @@
+#include "PlacementMath.hpp"
+
+namespace PlacementMath {
+
+bool NormalizeToMillimeters (Sheet& sheet)
+{
+    if (!(sheet.sizeX > 0.001 && sheet.sizeX < 100.0 && sheet.sizeY > 0.001 && sheet.sizeY < 100.0))
+        return false;
+    sheet.sizeX *= 1000.0;
+    sheet.sizeY *= 1000.0;
+    sheet.leftMargin *= 1000.0;
+    sheet.rightMargin *= 1000.0;
+    sheet.topMargin *= 1000.0;
+    sheet.bottomMargin *= 1000.0;
+    return true;
+}
+
+Rect GridRegionRect (const Sheet& sheet, int rows, int cols, double gapMm,
+                     int startRow, int startCol, int spanRows, int spanCols)
+{
+    const double availW = sheet.sizeX - sheet.leftMargin - sheet.rightMargin;
+    const double availH = sheet.sizeY - sheet.topMargin - sheet.bottomMargin;
+    if (cols < 1) cols = 1;
+    if (rows < 1) rows = 1;
+    const double gap = gapMm > 0 ? gapMm : 0;
+    const double cellW = (availW - (cols - 1) * gap) / cols;
+    const double cellH = (availH - (rows - 1) * gap) / rows;
+    if (spanRows < 1) spanRows = 1;
+    if (spanRows > rows) spanRows = rows;
+    const int rowFromBottom = (startRow >= 0 && startRow < rows) ? startRow : 0;
+
+    Rect rect;
+    rect.left   = sheet.leftMargin + startCol * (cellW + gap);
+    rect.bottom = sheet.bottomMargin + rowFromBottom * (cellH + gap);
+    rect.width  = spanCols * cellW + (spanCols > 1 ? (spanCols - 1) * gap : 0);
+    rect.height = spanRows * cellH + (spanRows > 1 ? (spanRows - 1) * gap : 0);
+    return rect;
+}
+
+Point AnchorPoint (const Sheet& sheet, Anchor anchor)
+{
+    const double MM_TO_M = 1.0 / 1000.0;
+    const double left   = sheet.leftMargin * MM_TO_M;
+    const double right  = (sheet.sizeX - sheet.rightMargin) * MM_TO_M;
+    const double top    = (sheet.sizeY - sheet.topMargin) * MM_TO_M;
+    const double bottom = sheet.bottomMargin * MM_TO_M;
+
+    Point point;
+    switch (anchor) {
+        case Anchor::LeftTop:     point.x = left;  point.y = top;    break;
+        case Anchor::RightTop:    point.x = right; point.y = top;    break;
+        case Anchor::RightBottom: point.x = right; point.y = bottom; break;
+        case Anchor::Middle:
+            point.x = left + (right - left) * 0.5;
+            point.y = bottom + (top - bottom) * 0.5;
+            break;
+        default:                  point.x = left;  point.y = bottom; break;
+    }
+    return point;
+}
+
+Point DrawingOrigin (const Sheet& sheet, Anchor anchor, double sizeWm, double sizeHm)
+{
+    Point origin = AnchorPoint (sheet, anchor);
+    switch (anchor) {
+        case Anchor::LeftTop:
+            origin.y -= sizeHm;
+            break;
+        case Anchor::Middle:
+            origin.x -= sizeWm * 0.5;
+            origin.y -= sizeHm * 0.5;
+            break;
+        case Anchor::RightTop:
+            origin.x -= sizeWm;
+            origin.y -= sizeHm;
+            break;
+        case Anchor::RightBottom:
+            origin.x -= sizeWm;
+            break;
+        default:
+            break;
+    }
+    return origin;
+}
+
+bool FitScale (double extentW, double extentH, double availWmm, double availHmm, FitResult& result)
+{
+    if (!(extentW > 1e-6 && extentH > 1e-6) || !(availWmm > 1.0 && availHmm > 1.0))
+        return false;
+
+    // Размер на листе = extent * 1000 / scale, поэтому вид помещается целиком при scale >= max (scaleW, scaleH)
+    result.scaleW = extentW * 1000.0 / availWmm;
+    result.scaleH = extentH * 1000.0 / availHmm;
+    result.scale = (result.scaleW > result.scaleH) ? result.scaleW : result.scaleH;
+    if (result.scale < 1.0) result.scale = 1.0;
+    if (result.scale > 10000.0) result.scale = 10000.0;
+    return true;
+}
+
+} // namespace PlacementMath
@@ -0,0 +1,68 @@
+#ifndef PLACEMENTMATH_HPP
+#define PLACEMENTMATH_HPP
+
+// Геометрия размещения вида на макете: сетка секторов, точка привязки, подгон масштаба.
+// Без заголовков DevKit — собирается в tolayout_core и проверяется Tools/CoreBench.
+namespace PlacementMath {
+
+    /** Лист макета: размер и поля в мм (как API_LayoutInfo) */
+    struct Sheet {
+        double sizeX = 0.0;
+        double sizeY = 0.0;
+        double leftMargin = 0.0;
+        double rightMargin = 0.0;
+        double topMargin = 0.0;
+        double bottomMargin = 0.0;
+    };
+
+    /** Прямоугольник от левого нижнего угла листа, мм */
+    struct Rect {
+        double left = 0.0;
+        double bottom = 0.0;
+        double width = 0.0;
+        double height = 0.0;
+    };
+
+    /** Точка на листе, м */
+    struct Point {
+        double x = 0.0;
+        double y = 0.0;
+    };
+
+    /** Точка привязки вида на макете: углы + центр */
+    enum class Anchor {
+        LeftBottom = 0,  // LB
+        LeftTop,         // LT
+        RightTop,        // RT
+        RightBottom,     // RB
+        Middle           // MM (центр)
+    };
+
+    // Некоторые версии/контексты возвращают размеры в метрах (0.21 x 0.297); API указывает мм.
+    // Переводит лист в мм, если размеры похожи на метры; true — если перевод был.
+    bool NormalizeToMillimeters (Sheet& sheet);
+
+    // Область сетки rows×cols с зазором gapMm; startRow — индекс ряда от низа листа (0 = нижний ряд)
+    Rect GridRegionRect (const Sheet& sheet, int rows, int cols, double gapMm,
+                         int startRow, int startCol, int spanRows, int spanCols);
+
+    // Точка привязки на листе (углы и центр области внутри полей), м
+    Point AnchorPoint (const Sheet& sheet, Anchor anchor);
+
+    // Левый нижний угол чертежа sizeW×sizeH (м), привязанного к точке anchor листа
+    Point DrawingOrigin (const Sheet& sheet, Anchor anchor, double sizeWm, double sizeHm);
+
+    /** Результат подгона масштаба: scale = max (scaleW, scaleH), ограничен 1..10000 */
+    struct FitResult {
+        double scale = 0.0;
+        double scaleW = 0.0;
+        double scaleH = 0.0;
+    };
+
+    // Масштаб, при котором рамка вида extentW×extentH (модель, м) помещается в область availW×availH (мм).
+    // false — если рамка или область вырождены.
+    bool FitScale (double extentW, double extentH, double availWmm, double availHmm, FitResult& result);
+
+} // namespace PlacementMath
+
+#endif // PLACEMENTMATH_HPP
@@ -0,0 +1,167 @@
+#include "GrossMetricsJob.hpp"
+#include "SelectionDetailsPalette.hpp"
+#include "ApiProfiler.hpp"
+#include "TraceLog.hpp"
+#include "Logger.hpp"
+
+#include <algorithm>
+#include <chrono>
+
+namespace GrossMetricsJob {
+
+// Идентификатор дополнения — как 'MDID' 32500 в RFIX/Browser_ReplFix.grc
+static const UInt32 OwnDeveloperID = 909404777;
+static const UInt32 OwnLocalID = 3235336477;
+
+// ---------------- Состояние задания ----------------
+static GS::Array<API_Guid>                                  s_queue;
+static UIndex                                               s_next = 0;
+static GS::Array<SelectionMetricsHelper::ElementMetrics>    s_ready;
+static bool                                                 s_posted = false;   // порция уже стоит в цикле событий
+static double                                               s_msPerElement = 0.0;
+
+// Сколько элементов уложится в SliceBudgetMs по замерам прошлых порций
+static UIndex NextSliceSize ()
+{
+    if (s_msPerElement <= 0.0)
+        return 1;
+    const double fit = SliceBudgetMs / s_msPerElement;
+    return static_cast<UIndex> (std::max (1.0, std::min (fit, static_cast<double> (MaxSliceElements))));
+}
+
+static void PostSlice ()
+{
+    if (s_posted)
+        return;
+
+    API_ModulID mdid = {};
+    mdid.developerID = OwnDeveloperID;
+    mdid.localID = OwnLocalID;
+    const GSErrCode err = ACAPI_AddOnAddOnCommunication_CallFromEventLoop (&mdid, CommandID, CommandVersion, nullptr, true, nullptr);
+    if (err != NoError) {
+        LOG_WARN ("[GrossMetricsJob] не удалось поставить порцию в цикл событий: %d", static_cast<int> (err));
+        s_queue.Clear ();
+        s_next = 0;
+        return;
+    }
+    s_posted = true;
+}
+
+// ---------------- Одна порция ----------------
+static GSErrCode __ACENV_CALL SliceHandler (GSHandle /*params*/, GSPtr /*resultData*/, bool /*silentMode*/)
+{
+    s_posted = false;
+    if (s_next >= s_queue.GetSize ())
+        return NoError;
+
+    API_OPERATION ("metrics");
+    TRACE_SPAN ("gross slice", "metrics");
+
+    const UIndex count = std::min (NextSliceSize (), s_queue.GetSize () - s_next);
+    GS::Array<API_Guid> slice;
+    slice.SetCapacity (count);
+    for (UIndex i = 0; i < count; ++i)
+        slice.Push (s_queue[s_next + i]);
+    s_next += count;
+
+    const std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now ();
+    const SelectionMetricsHelper::SelectionMetrics result = SelectionMetricsHelper::CollectForGuids (slice);
+    const double elapsedMs = std::chrono::duration<double, std::milli> (std::chrono::steady_clock::now () - start).count ();
+
+    // Элементы из кеша почти бесплатны, поэтому оценку обновляем только по реальному расчёту
+    if (result.grossMs > 0.0) {
+        const double sample = elapsedMs / count;
+        s_msPerElement = (s_msPerElement <= 0.0) ? sample : 0.7 * s_msPerElement + 0.3 * sample;
+    }
+    for (const SelectionMetricsHelper::ElementMetrics& element : result.elements)
+        s_ready.Push (element);
+
+    LOG_DEBUG ("[GrossMetricsJob] порция %u элементов, %.1f мс, осталось %u", static_cast<unsigned> (count), elapsedMs,
+        static_cast<unsigned> (s_queue.GetSize () - s_next));
+
+    if (s_next < s_queue.GetSize ()) {
+        PostSlice ();
+    } else {
+        s_queue.Clear ();
+        s_next = 0;
+    }
+
+    SelectionDetailsPalette::NotifySeoGrossMetricsReady ();
+    return NoError;
+}
+
+GSErrCode RegisterService ()
+{
+    return ACAPI_AddOnAddOnCommunication_RegisterSupportedService (CommandID, CommandVersion);
+}
+
+GSErrCode InstallHandler ()
+{
+    return ACAPI_AddOnAddOnCommunication_InstallModulCommandHandler (CommandID, CommandVersion, SliceHandler);
+}
+
+// ---------------- Управление заданием ----------------
+void Start (const GS::Array<API_Guid>& guids)
+{
+    if (IsRunning () && guids == s_queue)
+        return;
+
+    Cancel ();
+    if (guids.IsEmpty ())
+        return;
+
+    s_queue = guids;
+    PostSlice ();
+}
+
+void Enqueue (const GS::Array<API_Guid>& guids)
+{
+    for (const API_Guid& guid : guids) {
+        bool queued = false;
+        for (UIndex i = s_next; i < s_queue.GetSize () && !queued; ++i)
+            queued = (s_queue[i] == guid);
+        if (!queued)
+            s_queue.Push (guid);
+    }
+    if (IsRunning ())
+        PostSlice ();
+}
+
+void Cancel ()
+{
+    // Уже поставленная порция найдёт пустую очередь и ничего не сделает
+    s_queue.Clear ();
+    s_next = 0;
+    s_ready.Clear ();
+}
+
+bool IsRunning ()
+{
+    return s_next < s_queue.GetSize ();
+}
+
+GS::Array<SelectionMetricsHelper::ElementMetrics> TakeReady ()
+{
+    GS::Array<SelectionMetricsHelper::ElementMetrics> ready;
+    ready.Swap (s_ready);
+    return ready;
+}
+
+void HandleProjectEvent (API_NotifyEventID notifID)
+{
+    switch (notifID) {
+        case APINotify_New:
+        case APINotify_NewAndReset:
+        case APINotify_Open:
+        case APINotify_Close:
+        case APINotify_Quit:
+            // Элементы очереди принадлежат закрытому проекту. Прочие события (в том числе
+            // ChangeProjectDB) очередь не трогают — иначе теряются запрошенные палитрой пересчёты
+            Cancel ();
+            break;
+        default:
+            break;
+    }
+}
+
+} // namespace GrossMetricsJob
@@ -0,0 +1,48 @@
+#ifndef GROSSMETRICSJOB_HPP
+#define GROSSMETRICSJOB_HPP
+
+#include "APIEnvir.h"
+#include "ACAPinc.h"
+#include "GSRoot.hpp"
+
+#include "SelectionMetricsHelper.hpp"
+
+// Отложенный расчёт gross-метрик (через временные копии) для палитры выделения.
+// Палитра сразу получает net, а gross считается порциями из цикла событий Archicad:
+// одна порция — одна undo-команда на несколько элементов, между порциями интерфейс
+// обрабатывает клики. Готовые порции палитра забирает через TakeReady после
+// уведомления OnSeoGrossMetricsReady(). Смена выделения отменяет задание.
+namespace GrossMetricsJob {
+
+    // Команда дополнения, через которую порции ставятся в цикл событий
+    const GSType CommandID = 'TLGM';
+    const Int32  CommandVersion = 1;
+
+    // Целевая длительность одной порции: по ней подбирается число элементов
+    const double SliceBudgetMs = 40.0;
+    const UInt32 MaxSliceElements = 64;
+
+    // RegisterInterface / Initialize
+    GSErrCode RegisterService ();
+    GSErrCode InstallHandler ();
+
+    // Посчитать gross для элементов; заменяет текущее задание (то же самое не перезапускается)
+    void Start (const GS::Array<API_Guid>& guids);
+
+    // Добавить элементы к текущему заданию, не сбрасывая его (пересчёт изменившихся элементов)
+    void Enqueue (const GS::Array<API_Guid>& guids);
+
+    // Бросить очередь и непереданные результаты (смена выделения, закрытие проекта)
+    void Cancel ();
+
+    bool IsRunning ();
+
+    // Посчитанные с прошлого вызова элементы
+    GS::Array<SelectionMetricsHelper::ElementMetrics> TakeReady ();
+
+    // Реакция на событие проекта (вызывается из общего обработчика BrowserRepl)
+    void HandleProjectEvent (API_NotifyEventID notifID);
+
+} // namespace GrossMetricsJob
+
+#endif // GROSSMETRICSJOB_HPP
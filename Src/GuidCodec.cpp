@@ -0,0 +1,158 @@
+#include "GuidCodec.hpp"
+
+#include <cstring>
+#include <string>
+
+namespace GuidCodec {
+
+static const char EncodeTable[] = "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
+
+// Таблица декодирования: 0..63 — значение символа, 0x80 — недопустимый символ
+struct DecodeTableType {
+    unsigned char values[256];
+
+    DecodeTableType ()
+    {
+        std::memset (values, 0x80, sizeof (values));
+        for (unsigned char i = 0; i < 64; ++i)
+            values[static_cast<unsigned char> (EncodeTable[i])] = i;
+    }
+};
+
+static const DecodeTableType DecodeTable;
+
+static const UIndex GuidStringLength = 36;
+
+// ---------------- Обычная строка GUID ----------------
+bool IsGuidString (const GS::UniString& value)
+{
+    // В алфавите base64 нет '-', поэтому дефисы на своих местах однозначно отличают формы
+    return value.GetLength () == GuidStringLength &&
+           value[8] == '-' && value[13] == '-' && value[18] == '-' && value[23] == '-';
+}
+
+// ---------------- Упаковка ----------------
+GS::UniString Encode (const API_Guid* guids, UIndex count)
+{
+    if (guids == nullptr || count == 0)
+        return GS::UniString ();
+
+    const unsigned char* src = reinterpret_cast<const unsigned char*> (guids);
+    const UIndex byteCount = count * sizeof (API_Guid);
+    const UIndex fullBlocks = byteCount / 3;
+    const UIndex tail = byteCount - fullBlocks * 3;
+
+    std::string out;
+    out.resize ((fullBlocks + (tail != 0 ? 1 : 0)) * 4);
+    char* dst = &out[0];
+
+    // Основной цикл по блокам 3 байта -> 4 символа без ветвлений внутри
+    for (UIndex b = 0; b < fullBlocks; ++b) {
+        const UInt32 v = (static_cast<UInt32> (src[0]) << 16) | (static_cast<UInt32> (src[1]) << 8) | src[2];
+        dst[0] = EncodeTable[(v >> 18) & 0x3F];
+        dst[1] = EncodeTable[(v >> 12) & 0x3F];
+        dst[2] = EncodeTable[(v >> 6) & 0x3F];
+        dst[3] = EncodeTable[v & 0x3F];
+        src += 3;
+        dst += 4;
+    }
+
+    if (tail != 0) {
+        const UInt32 v = (static_cast<UInt32> (src[0]) << 16) | (tail == 2 ? (static_cast<UInt32> (src[1]) << 8) : 0);
+        dst[0] = EncodeTable[(v >> 18) & 0x3F];
+        dst[1] = EncodeTable[(v >> 12) & 0x3F];
+        dst[2] = (tail == 2) ? EncodeTable[(v >> 6) & 0x3F] : '=';
+        dst[3] = '=';
+    }
+
+    return GS::UniString (out.c_str ());
+}
+
+GS::UniString Encode (const GS::Array<API_Guid>& guids)
+{
+    return guids.IsEmpty () ? GS::UniString () : Encode (&guids[0], guids.GetSize ());
+}
+
+// ---------------- Распаковка ----------------
+bool Decode (const GS::UniString& packed, GS::Array<API_Guid>& out)
+{
+    const UIndex length = packed.GetLength ();
+    if (length == 0)
+        return true;
+    if (length % 4 != 0)
+        return false;
+
+    // UStr держит буфер символов — он должен жить, пока идёт разбор
+    const auto ustr = packed.ToUStr ();
+    const auto* src = ustr.Get ();
+
+    UIndex padding = 0;
+    if (src[length - 1] == '=') {
+        ++padding;
+        if (src[length - 2] == '=')
+            ++padding;
+    }
+
+    const UIndex byteCount = (length / 4) * 3 - padding;
+    if (byteCount % sizeof (API_Guid) != 0)
+        return false;
+
+    std::string bytes;
+    bytes.resize ((length / 4) * 3);
+    unsigned char* dst = reinterpret_cast<unsigned char*> (&bytes[0]);
+
+    // Ошибки накапливаются в invalid и проверяются один раз после цикла
+    unsigned char invalid = 0;
+    const UIndex blocks = length / 4;
+    for (UIndex b = 0; b < blocks; ++b) {
+        unsigned char c[4];
+        for (UIndex i = 0; i < 4; ++i) {
+            const UInt32 ch = static_cast<UInt32> (src[i]);
+            const unsigned char value = (ch < 256) ? DecodeTable.values[ch] : 0x80;
+            // '=' допустим только в последнем блоке, там он обрабатывается как ноль
+            const bool isPad = (ch == '=') && (b + 1 == blocks) && (i >= 4 - padding);
+            c[i] = isPad ? 0 : value;
+            invalid |= c[i];
+        }
+        const UInt32 v = (static_cast<UInt32> (c[0]) << 18) | (static_cast<UInt32> (c[1]) << 12) | (static_cast<UInt32> (c[2]) << 6) | c[3];
+        dst[0] = static_cast<unsigned char> (v >> 16);
+        dst[1] = static_cast<unsigned char> (v >> 8);
+        dst[2] = static_cast<unsigned char> (v);
+        src += 4;
+        dst += 3;
+    }
+    if ((invalid & 0x80) != 0)
+        return false;
+
+    const UIndex guidCount = byteCount / sizeof (API_Guid);
+    const UIndex first = out.GetSize ();
+    out.SetSize (first + guidCount);
+    if (guidCount > 0)
+        std::memcpy (&out[first], bytes.data (), byteCount);
+    return true;
+}
+
+// ---------------- Любая форма ----------------
+void AppendGuids (const GS::UniString& value, GS::Array<API_Guid>& out)
+{
+    if (value.IsEmpty ())
+        return;
+
+    if (IsGuidString (value)) {
+        const API_Guid guid = APIGuidFromString (value.ToCStr ().Get ());
+        if (guid != APINULLGuid)
+            out.Push (guid);
+        return;
+    }
+
+    GS::Array<API_Guid> decoded;
+    if (!Decode (value, decoded))
+        return;
+    out.SetCapacity (out.GetSize () + decoded.GetSize ());
+    for (const API_Guid& guid : decoded) {
+        if (guid != APINULLGuid)
+            out.Push (guid);
+    }
+}
+
+} // namespace GuidCodec
@@ -0,0 +1,27 @@
+#ifndef GUIDCODEC_HPP
+#define GUIDCODEC_HPP
+
+#include "APIEnvir.h"
+#include "ACAPinc.h"
+#include "GSRoot.hpp"
+
+// Упакованная передача GUID через JS-мост: base64 от подряд идущих 16-байтовых API_Guid.
+// Строка из 40k GUID занимает ~853k символов вместо 1.44M и разбирается без ToCStr() на каждый GUID.
+namespace GuidCodec {
+
+    // Строка в привычном виде "xxxxxxxx-xxxx-xxxx-xxxx-xxxxxxxxxxxx"
+    bool IsGuidString (const GS::UniString& value);
+
+    // Упаковать GUID в base64 (байтовый порядок — как в памяти API_Guid)
+    GS::UniString Encode (const API_Guid* guids, UIndex count);
+    GS::UniString Encode (const GS::Array<API_Guid>& guids);
+
+    // Распаковать base64 и дописать GUID в out; false, если строка повреждена
+    bool Decode (const GS::UniString& packed, GS::Array<API_Guid>& out);
+
+    // Принять любую форму: обычную строку GUID или упакованный блок; нулевые GUID отбрасываются
+    void AppendGuids (const GS::UniString& value, GS::Array<API_Guid>& out);
+
+} // namespace GuidCodec
+
+#endif // GUIDCODEC_HPP
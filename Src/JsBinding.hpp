@@ -0,0 +1,202 @@
+#ifndef JSBINDING_HPP
+#define JSBINDING_HPP
+
+#include "APIEnvir.h"
+#include "ACAPinc.h"
+#include "GSRoot.hpp"
+#include "DGBrowser.hpp"
+
+#include <cstddef>
+#include <cstdio>
+
+// Типизированные привязки JS-моста: поля структуры параметров описываются один раз
+// в constexpr-таблице { имя, указатель на член }. Decode проходит по таблице ключей
+// JS-объекта один раз и сравнивает ключи с ASCII-именами полей без временных UniString;
+// Encode строит JS-объект по той же таблице.
+namespace JsBinding {
+
+    enum class FieldKind { Int, Double, Bool, String, Guid, Custom };
+
+    template<class T>
+    struct Field {
+        typedef void (*CustomDecoder) (const JS::Value& value, T& out);
+
+        const char*          name;
+        FieldKind            kind;
+        Int32 T::*           intMember;
+        double T::*          doubleMember;
+        bool T::*            boolMember;
+        GS::UniString T::*   stringMember;
+        API_Guid T::*        guidMember;
+        CustomDecoder        custom;
+    };
+
+    template<class T>
+    constexpr Field<T> IntField (const char* name, Int32 T::* member)
+    {
+        return { name, FieldKind::Int, member, nullptr, nullptr, nullptr, nullptr, nullptr };
+    }
+
+    template<class T>
+    constexpr Field<T> DoubleField (const char* name, double T::* member)
+    {
+        return { name, FieldKind::Double, nullptr, member, nullptr, nullptr, nullptr, nullptr };
+    }
+
+    template<class T>
+    constexpr Field<T> BoolField (const char* name, bool T::* member)
+    {
+        return { name, FieldKind::Bool, nullptr, nullptr, member, nullptr, nullptr, nullptr };
+    }
+
+    template<class T>
+    constexpr Field<T> StringField (const char* name, GS::UniString T::* member)
+    {
+        return { name, FieldKind::String, nullptr, nullptr, nullptr, member, nullptr, nullptr };
+    }
+
+    template<class T>
+    constexpr Field<T> GuidField (const char* name, API_Guid T::* member)
+    {
+        return { name, FieldKind::Guid, nullptr, nullptr, nullptr, nullptr, member, nullptr };
+    }
+
+    // Поле с собственным разбором (перечисления, альтернативные форматы); при Encode пропускается
+    template<class T>
+    constexpr Field<T> CustomField (const char* name, typename Field<T>::CustomDecoder decoder)
+    {
+        return { name, FieldKind::Custom, nullptr, nullptr, nullptr, nullptr, nullptr, decoder };
+    }
+
+    // ---- Разбор значений ----
+
+    // Сравнение ключа с ASCII-именем поля посимвольно, без построения UniString
+    inline bool KeyEquals (const GS::UniString& key, const char* name)
+    {
+        const USize length = key.GetLength ();
+        for (USize i = 0; i < length; ++i) {
+            if (name[i] == '\0' || key[i] != static_cast<unsigned char> (name[i]))
+                return false;
+        }
+        return name[length] == '\0';
+    }
+
+    // Число из INTEGER / DOUBLE / строки "123.4" или "123,4"
+    inline bool ReadNumber (const JS::Value& value, double& out)
+    {
+        switch (value.GetType ()) {
+            case JS::Value::INTEGER:
+                out = static_cast<double> (value.GetInteger ());
+                return true;
+            case JS::Value::DOUBLE:
+                out = value.GetDouble ();
+                return true;
+            case JS::Value::STRING: {
+                const GS::UniString& s = value.GetString ();
+                const USize length = s.GetLength ();
+                char buffer[64];
+                if (length == 0 || length >= sizeof (buffer))
+                    return false;
+                for (USize i = 0; i < length; ++i) {
+                    const UInt32 ch = static_cast<UInt32> (s[i].GetValue ());
+                    buffer[i] = (ch == ',') ? '.' : (ch < 128 ? static_cast<char> (ch) : ' ');
+                }
+                buffer[length] = '\0';
+                return std::sscanf (buffer, "%lf", &out) == 1;
+            }
+            default:
+                return false;
+        }
+    }
+
+    template<class T>
+    void DecodeField (const Field<T>& field, const JS::Value& value, T& out)
+    {
+        double number = 0.0;
+        switch (field.kind) {
+            case FieldKind::Int:
+                if (ReadNumber (value, number))
+                    out.*field.intMember = static_cast<Int32> (number);
+                break;
+            case FieldKind::Double:
+                if (ReadNumber (value, number))
+                    out.*field.doubleMember = number;
+                break;
+            case FieldKind::Bool:
+                if (value.GetType () == JS::Value::BOOL)
+                    out.*field.boolMember = value.GetBool ();
+                else if (ReadNumber (value, number))
+                    out.*field.boolMember = (number != 0.0);
+                break;
+            case FieldKind::String:
+                if (value.GetType () == JS::Value::STRING)
+                    out.*field.stringMember = value.GetString ();
+                break;
+            case FieldKind::Guid:
+                if (value.GetType () == JS::Value::STRING && !value.GetString ().IsEmpty ())
+                    out.*field.guidMember = APIGuidFromString (value.GetString ().ToCStr ().Get ());
+                break;
+            case FieldKind::Custom:
+                field.custom (value, out);
+                break;
+        }
+    }
+
+    // Разобрать JS-объект в структуру за один проход по его ключам.
+    // Отсутствующие ключи оставляют значения по умолчанию; false, если param — не объект
+    template<class T, std::size_t N>
+    bool Decode (const GS::Ref<JS::Base>& param, const Field<T> (&fields)[N], T& out)
+    {
+        GS::Ref<JS::Object> obj = GS::DynamicCast<JS::Object> (param);
+        if (obj == nullptr)
+            return false;
+
+        const GS::HashTable<GS::UniString, GS::Ref<JS::Base>>& table = obj->GetItemTable ();
+        for (auto it = table.EnumeratePairs (); it != nullptr; ++it) {
+            const GS::UniString& key = *it->key;
+            GS::Ref<JS::Value> value = GS::DynamicCast<JS::Value> (*it->value);
+            if (value == nullptr)
+                continue;
+            for (std::size_t i = 0; i < N; ++i) {
+                if (KeyEquals (key, fields[i].name)) {
+                    DecodeField (fields[i], *value, out);
+                    break;
+                }
+            }
+        }
+        return true;
+    }
+
+    // Построить JS-объект из структуры по той же таблице полей
+    template<class T, std::size_t N>
+    GS::Ref<JS::Object> Encode (const T& in, const Field<T> (&fields)[N])
+    {
+        GS::Ref<JS::Object> obj = new JS::Object ();
+        for (std::size_t i = 0; i < N; ++i) {
+            const Field<T>& field = fields[i];
+            switch (field.kind) {
+                case FieldKind::Int:
+                    obj->AddItem (field.name, new JS::Value (in.*field.intMember));
+                    break;
+                case FieldKind::Double:
+                    obj->AddItem (field.name, new JS::Value (in.*field.doubleMember));
+                    break;
+                case FieldKind::Bool:
+                    obj->AddItem (field.name, new JS::Value (in.*field.boolMember));
+                    break;
+                case FieldKind::String:
+                    obj->AddItem (field.name, new JS::Value (in.*field.stringMember));
+                    break;
+                case FieldKind::Guid:
+                    obj->AddItem (field.name, new JS::Value (APIGuidToString (in.*field.guidMember)));
+                    break;
+                case FieldKind::Custom:
+                    break;
+            }
+        }
+        return obj;
+    }
+
+} // namespace JsBinding
+
+#endif // JSBINDING_HPP
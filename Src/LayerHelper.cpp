@@ -1,99 +1,55 @@
 #include "LayerHelper.hpp"
 #include "APICommon.h"
+#include "NameCache.hpp"
+#include "ApiProfiler.hpp"
+#include "TraceLog.hpp"
+#include "Logger.hpp"
+#include "FolderPath.hpp"
+
+#include <string>
+#include <vector>
 
 namespace LayerHelper {
 
+// Пути папок разбираются в Src/Core/FolderPath (UTF-8)
+static std::string ToUtf8(const GS::UniString& str)
+{
+    return std::string(str.ToCStr(CC_UTF8).Get());
+}
+
+static GS::Array<GS::UniString> ToUniParts(const std::vector<std::string>& parts)
+{
+    GS::Array<GS::UniString> result;
+    for (const std::string& part : parts)
+        result.Push(GS::UniString(part.c_str(), CC_UTF8));
+    return result;
+}
+
 // ---------------- Удалить префикс "Слои/" или "Layers/" из пути ---------------- 
 static GS::UniString RemoveRootFolderPrefix(const GS::UniString& path)
 {
     if (path.IsEmpty()) {
         return path;
     }
-    
-    // Проверяем, начинается ли путь с "Слои/" или "Layers/"
-    GS::UniString prefix1 = "Слои/";
-    GS::UniString prefix2 = "Layers/";
-    
-    if (path.GetLength() >= prefix1.GetLength() && 
-        path.GetSubstring(0, prefix1.GetLength()) == prefix1) {
-        return path.GetSubstring(prefix1.GetLength(), path.GetLength() - prefix1.GetLength());
-    }
-    
-    if (path.GetLength() >= prefix2.GetLength() && 
-        path.GetSubstring(0, prefix2.GetLength()) == prefix2) {
-        return path.GetSubstring(prefix2.GetLength(), path.GetLength() - prefix2.GetLength());
-    }
-    
-    // Также проверяем без слэша в конце
-    GS::UniString prefix1NoSlash = "Слои";
-    GS::UniString prefix2NoSlash = "Layers";
-    
-    if (path == prefix1NoSlash || path == prefix2NoSlash) {
-        return GS::UniString("");
-    }
-    
-    return path;
+    return GS::UniString(FolderPath::RemoveRootPrefix(ToUtf8(path)).c_str(), CC_UTF8);
 }
 
 // ---------------- Удалить первый элемент "Слои" или "Layers" из массива пути ---------------- 
 static GS::Array<GS::UniString> RemoveRootFolderFromPath(const GS::Array<GS::UniString>& pathParts)
 {
-    GS::Array<GS::UniString> result;
-    
-    if (pathParts.GetSize() == 0) {
-        return result;
-    }
-    
-    // Проверяем первый элемент
-    GS::UniString firstPart = pathParts[0];
-    
-    // Если первый элемент - "Слои" или "Layers" (регистронезависимо), пропускаем его
-    if (firstPart == "Слои" || firstPart == "Layers" || firstPart == "layers" || firstPart == "LAYERS") {
-        // Копируем остальные элементы
-        for (UIndex i = 1; i < pathParts.GetSize(); ++i) {
-            result.Push(pathParts[i]);
-        }
-    } else {
-        // Копируем все элементы
-        result = pathParts;
-    }
-    
-    return result;
+    std::vector<std::string> parts;
+    for (UIndex i = 0; i < pathParts.GetSize(); ++i)
+        parts.push_back(ToUtf8(pathParts[i]));
+    return ToUniParts(FolderPath::RemoveRootFolder(parts));
 }
 
 // ---------------- Разбить путь к папке на массив ---------------- 
 GS::Array<GS::UniString> ParseFolderPath(const GS::UniString& folderPath)
 {
-    GS::Array<GS::UniString> pathParts;
-    
     if (folderPath.IsEmpty()) {
-        return pathParts;
-    }
-
-    // Разбиваем строку по символу "/"
-    GS::UniString currentPath = folderPath;
-    GS::UniString separator = "/";
-    
-    while (!currentPath.IsEmpty()) {
-        Int32 separatorPos = currentPath.FindFirst(separator);
-        if (separatorPos == -1) {
-            // Последняя часть пути
-            if (!currentPath.IsEmpty()) {
-                pathParts.Push(currentPath);
-            }
-            break;
-        } else {
-            // Добавляем часть до разделителя
-            GS::UniString part = currentPath.GetSubstring(0, separatorPos);
-            if (!part.IsEmpty()) {
-                pathParts.Push(part);
-            }
-            // Убираем обработанную часть и разделитель
-            currentPath = currentPath.GetSubstring(separatorPos + 1, currentPath.GetLength() - separatorPos - 1);
-        }
+        return GS::Array<GS::UniString>();
     }
-
-    return pathParts;
+    return ToUniParts(FolderPath::Split(ToUtf8(folderPath)));
 }
 
 // ---------------- Создать папку для слоев ---------------- 
@@ -155,7 +111,7 @@ bool CreateLayerFolder(const GS::UniString& folderPath, GS::Guid& folderGuid)
         API_AttributeFolder existingFolder = {};
         existingFolder.typeID = API_LayerID;
         existingFolder.path = currentPath;
-        GSErrCode err = ACAPI_Attribute_GetFolder(existingFolder);
+        GSErrCode err = API_CALL(ACAPI_Attribute_GetFolder, existingFolder);
         
         if (err != NoError) {
             // Папка не существует, создаем её
@@ -163,31 +119,23 @@ bool CreateLayerFolder(const GS::UniString& folderPath, GS::Guid& folderGuid)
             folder.typeID = API_LayerID;
             folder.path = currentPath;
             
-            err = ACAPI_Attribute_CreateFolder(folder);
+            err = API_CALL(ACAPI_Attribute_CreateFolder, folder);
             if (err != NoError) {
-#ifdef DEBUG_UI_LOGS
-                ACAPI_WriteReport("[LayerHelper] Ошибка создания папки '%s' (код: %d)", true, 
-                    currentPathStr.ToCStr().Get(), err);
-#endif
+                LOG_WARN("[LayerHelper] Ошибка создания папки '%s' (код: %d)", 
+                    currentPathStr.ToCStr(CC_UTF8).Get(), err);
                 return false;
             }
-#ifdef DEBUG_UI_LOGS
-            ACAPI_WriteReport("[LayerHelper] Создана папка: %s", false, currentPathStr.ToCStr().Get());
-#endif
+            LOG_DEBUG("[LayerHelper] Создана папка: %s", currentPathStr.ToCStr(CC_UTF8).Get());
             
             // Используем GUID созданной папки
             folderGuid = folder.guid;
-#ifdef DEBUG_UI_LOGS
-            ACAPI_WriteReport("[LayerHelper] GUID созданной папки получен", false);
-            ACAPI_WriteReport("[LayerHelper] Папка создана успешно, GUID не пустой: %s", false, 
+            LOG_DEBUG("[LayerHelper] GUID созданной папки получен");
+            LOG_DEBUG("[LayerHelper] Папка создана успешно, GUID не пустой: %s", 
                 (folderGuid != GS::Guid()) ? "да" : "нет");
-#endif
         } else {
             // Папка существует, используем её GUID
             folderGuid = existingFolder.guid;
-#ifdef DEBUG_UI_LOGS
-            ACAPI_WriteReport("[LayerHelper] Папка уже существует: %s", false, currentPathStr.ToCStr().Get());
-#endif
+            LOG_DEBUG("[LayerHelper] Папка уже существует: %s", currentPathStr.ToCStr(CC_UTF8).Get());
         }
     }
 
@@ -195,30 +143,10 @@ bool CreateLayerFolder(const GS::UniString& folderPath, GS::Guid& folderGuid)
 }
 
 // ---------------- Найти слой по имени, вернуть его индекс (0 если не найден) ----------------
+// Обратная таблица имён строится в NameCache один раз за проход, а не перебором слоёв на каждый вызов
 static API_AttributeIndex FindLayerByName(const GS::UniString& layerName)
 {
-    API_AttributeIndex foundIndex = APIInvalidAttributeIndex;
-
-    // Получаем количество слоев
-    GS::UInt32 layerCount = 0;
-    if (ACAPI_Attribute_GetNum(API_LayerID, layerCount) != NoError || layerCount == 0)
-        return foundIndex;
-
-    // Перебираем все слои и ищем совпадение по имени
-    for (Int32 i = 1; i <= static_cast<Int32>(layerCount); ++i) {
-        API_Attribute attr = {};
-        attr.header.typeID = API_LayerID;
-        attr.header.index = ACAPI_CreateAttributeIndex(i);
-        if (ACAPI_Attribute_Get(&attr) != NoError)
-            continue;
-
-        if (GS::UniString(attr.header.name) == layerName) {
-            foundIndex = ACAPI_CreateAttributeIndex(i);
-            break;
-        }
-    }
-
-    return foundIndex;
+    return NameCache::FindLayerByName(layerName);
 }
 
 // ---------------- Создать слой в указанной папке ---------------- 
@@ -227,16 +155,12 @@ bool CreateLayer(const GS::UniString& folderPath, const GS::UniString& layerName
     // Если имя слоя совпадает с именем папки, или слой с таким именем уже существует —
     // не создаём новый слой, а только переносим существующий в указанную папку
     if (!layerName.IsEmpty() && (layerName == folderPath)) {
-#ifdef DEBUG_UI_LOGS
-        ACAPI_WriteReport("[LayerHelper] Имя слоя совпадает с именем папки: '%s' — пропускаем создание", false, layerName.ToCStr().Get());
-#endif
+        LOG_DEBUG("[LayerHelper] Имя слоя совпадает с именем папки: '%s' — пропускаем создание", layerName.ToCStr(CC_UTF8).Get());
         API_AttributeIndex existingIdx = FindLayerByName(layerName);
         if (existingIdx.IsPositive()) {
             layerIndex = existingIdx;
             if (!folderPath.IsEmpty()) {
-#ifdef DEBUG_UI_LOGS
-                ACAPI_WriteReport("[LayerHelper] Переносим существующий слой '%s' в папку '%s'", false, layerName.ToCStr().Get(), folderPath.ToCStr().Get());
-#endif
+                LOG_DEBUG("[LayerHelper] Переносим существующий слой '%s' в папку '%s'", layerName.ToCStr(CC_UTF8).Get(), folderPath.ToCStr(CC_UTF8).Get());
                 MoveLayerToFolder(layerIndex, folderPath);
             }
             return true;
@@ -247,9 +171,7 @@ bool CreateLayer(const GS::UniString& folderPath, const GS::UniString& layerName
         // чтобы избежать ошибки создания дубликата
         API_AttributeIndex existingIdx = FindLayerByName(layerName);
         if (existingIdx.IsPositive()) {
-#ifdef DEBUG_UI_LOGS
-            ACAPI_WriteReport("[LayerHelper] Слой '%s' уже существует — используем его и переносим при необходимости", false, layerName.ToCStr().Get());
-#endif
+            LOG_DEBUG("[LayerHelper] Слой '%s' уже существует — используем его и переносим при необходимости", layerName.ToCStr(CC_UTF8).Get());
             layerIndex = existingIdx;
             if (!folderPath.IsEmpty()) {
                 MoveLayerToFolder(layerIndex, folderPath);
@@ -273,36 +195,27 @@ bool CreateLayer(const GS::UniString& folderPath, const GS::UniString& layerName
     layer.layer.conClassId = 1; // Класс соединения по умолчанию
 
     // Создаем слой в корне (папка будет назначена позже через MoveLayerToFolder)
-#ifdef DEBUG_UI_LOGS
-    ACAPI_WriteReport("[LayerHelper] Создаем слой в корне", false);
-#endif
+    LOG_DEBUG("[LayerHelper] Создаем слой в корне");
 
     // Создаем слой
-    GSErrCode err = ACAPI_Attribute_Create(&layer, nullptr);
+    GSErrCode err = API_CALL(ACAPI_Attribute_Create, &layer, nullptr);
     if (err != NoError) {
-#ifdef DEBUG_UI_LOGS
-        ACAPI_WriteReport("[LayerHelper] Ошибка создания слоя: %s", true, layerName.ToCStr().Get());
-#endif
+        LOG_WARN("[LayerHelper] Ошибка создания слоя: %s", layerName.ToCStr(CC_UTF8).Get());
         return false;
     }
 
     layerIndex = layer.header.index;
+    NameCache::OnLayerChanged(layerIndex, layerName);
     
     // Перемещаем слой в папку, если папка указана
     if (!folderPath.IsEmpty()) {
-#ifdef DEBUG_UI_LOGS
-        ACAPI_WriteReport("[LayerHelper] Пытаемся переместить слой в папку: %s", false, folderPath.ToCStr().Get());
-#endif
+        LOG_DEBUG("[LayerHelper] Пытаемся переместить слой в папку: %s", folderPath.ToCStr(CC_UTF8).Get());
         if (!MoveLayerToFolder(layerIndex, folderPath)) {
-#ifdef DEBUG_UI_LOGS
-            ACAPI_WriteReport("[LayerHelper] Предупреждение: не удалось переместить слой в папку", false);
-#endif
+            LOG_DEBUG("[LayerHelper] Предупреждение: не удалось переместить слой в папку");
         }
     }
     
-#ifdef DEBUG_UI_LOGS
-    ACAPI_WriteReport("[LayerHelper] Создан слой: %s в папке: %s", false, layerName.ToCStr().Get(), folderPath.ToCStr().Get());
-#endif
+    LOG_DEBUG("[LayerHelper] Создан слой: %s в папке: %s", layerName.ToCStr(CC_UTF8).Get(), folderPath.ToCStr(CC_UTF8).Get());
     return true;
 }
 
@@ -312,30 +225,26 @@ bool MoveSelectedElementsToLayer(API_AttributeIndex layerIndex)
     // Получаем выделенные элементы
     API_SelectionInfo selectionInfo = {};
     GS::Array<API_Neig> selNeigs;
-    ACAPI_Selection_Get(&selectionInfo, &selNeigs, false, false);
+    API_CALL(ACAPI_Selection_Get, &selectionInfo, &selNeigs, false, false);
     BMKillHandle((GSHandle*)&selectionInfo.marquee.coords);
 
     if (selNeigs.IsEmpty()) {
-#ifdef DEBUG_UI_LOGS
-        ACAPI_WriteReport("[LayerHelper] Нет выделенных элементов", false);
-#endif
+        LOG_DEBUG("[LayerHelper] Нет выделенных элементов");
         return false;
     }
 
-#ifdef DEBUG_UI_LOGS
-    ACAPI_WriteReport("[LayerHelper] Перемещаем %d элементов в слой %s", false, (int)selNeigs.GetSize(), layerIndex.ToUniString().ToCStr().Get());
-#endif
+    LOG_DEBUG("[LayerHelper] Перемещаем %d элементов в слой %s", (int)selNeigs.GetSize(), layerIndex.ToUniString().ToCStr(CC_UTF8).Get());
 
-    // Перемещаем каждый элемент
+    // Перемещаем каждый элемент; в окно отчёта — одна сводка на операцию
+    Logger::OperationSummary summary("Перемещение элементов в слой");
     for (const API_Neig& neig : selNeigs) {
         API_Element element = {};
         element.header.guid = neig.guid;
         
-        GSErrCode err = ACAPI_Element_Get(&element);
+        GSErrCode err = API_CALL(ACAPI_Element_Get, &element);
         if (err != NoError) {
-#ifdef DEBUG_UI_LOGS
-            ACAPI_WriteReport("[LayerHelper] Ошибка получения элемента: %s", true, APIGuidToString(neig.guid).ToCStr().Get());
-#endif
+            LOG_WARN("[LayerHelper] Ошибка получения элемента: %s", APIGuidToString(neig.guid).ToCStr(CC_UTF8).Get());
+            summary.Failed();
             continue;
         }
 
@@ -346,15 +255,13 @@ bool MoveSelectedElementsToLayer(API_AttributeIndex layerIndex)
         element.header.layer = layerIndex;
         ACAPI_ELEMENT_MASK_SET(mask, API_Elem_Head, layer);
 
-        err = ACAPI_Element_Change(&element, &mask, nullptr, 0, true);
+        err = API_CALL(ACAPI_Element_Change, &element, &mask, nullptr, 0, true);
         if (err != NoError) {
-#ifdef DEBUG_UI_LOGS
-            ACAPI_WriteReport("[LayerHelper] Ошибка изменения слоя элемента: %s", true, APIGuidToString(neig.guid).ToCStr().Get());
-#endif
+            LOG_WARN("[LayerHelper] Ошибка изменения слоя элемента: %s", APIGuidToString(neig.guid).ToCStr(CC_UTF8).Get());
+            summary.Failed();
         } else {
-#ifdef DEBUG_UI_LOGS
-            ACAPI_WriteReport("[LayerHelper] Элемент перемещен в слой: %s", false, APIGuidToString(neig.guid).ToCStr().Get());
-#endif
+            LOG_TRACE("[LayerHelper] Элемент перемещен в слой: %s", APIGuidToString(neig.guid).ToCStr(CC_UTF8).Get());
+            summary.Succeeded();
         }
     }
 
@@ -368,17 +275,16 @@ bool ChangeSelectedElementsID(const GS::UniString& baseID)
 
     API_SelectionInfo selectionInfo = {};
     GS::Array<API_Neig> selNeigs;
-    ACAPI_Selection_Get(&selectionInfo, &selNeigs, false, false);
+    API_CALL(ACAPI_Selection_Get, &selectionInfo, &selNeigs, false, false);
     BMKillHandle((GSHandle*)&selectionInfo.marquee.coords);
 
     if (selNeigs.IsEmpty()) return false;
 
-#ifdef DEBUG_UI_LOGS
-    ACAPI_WriteReport("[LayerHelper] Изменяем ID %d элементов с базовым названием: %s", false, (int)selNeigs.GetSize(), baseID.ToCStr().Get());
-#endif
+    LOG_DEBUG("[LayerHelper] Изменяем ID %d элементов с базовым названием: %s", (int)selNeigs.GetSize(), baseID.ToCStr(CC_UTF8).Get());
 
     // Используем Undo-группу для возможности отмены
     GSErrCode err = ACAPI_CallUndoableCommand("Change Elements ID", [&]() -> GSErrCode {
+        Logger::OperationSummary summary("Изменение ID элементов");
         for (UIndex i = 0; i < selNeigs.GetSize(); ++i) {
             // Создаем новый ID: baseID-01, baseID-02, etc.
             GS::UniString newID = baseID;
@@ -387,15 +293,13 @@ bool ChangeSelectedElementsID(const GS::UniString& baseID)
             }
 
             // Изменяем ID элемента
-            if (ACAPI_Element_ChangeElementInfoString(&selNeigs[i].guid, &newID) != NoError) {
-#ifdef DEBUG_UI_LOGS
-                ACAPI_WriteReport("[LayerHelper] Ошибка изменения ID элемента: %s", true, APIGuidToString(selNeigs[i].guid).ToCStr().Get());
-#endif
+            if (API_CALL(ACAPI_Element_ChangeElementInfoString, &selNeigs[i].guid, &newID) != NoError) {
+                LOG_WARN("[LayerHelper] Ошибка изменения ID элемента: %s", APIGuidToString(selNeigs[i].guid).ToCStr(CC_UTF8).Get());
+                summary.Failed();
                 continue;
             } else {
-#ifdef DEBUG_UI_LOGS
-                ACAPI_WriteReport("[LayerHelper] ID изменен: %s", false, newID.ToCStr().Get());
-#endif
+                LOG_TRACE("[LayerHelper] ID изменен: %s", newID.ToCStr(CC_UTF8).Get());
+                summary.Succeeded();
             }
         }
         return NoError;
@@ -407,60 +311,61 @@ bool ChangeSelectedElementsID(const GS::UniString& baseID)
 // ---------------- Основная функция: создать папку, слой и переместить элементы ----------------
 bool CreateLayerAndMoveElements(const LayerCreationParams& params)
 {
-#ifdef DEBUG_UI_LOGS
-    ACAPI_WriteReport("[LayerHelper] Начинаем создание папки, слоя и перемещение элементов", false);
-    ACAPI_WriteReport("[LayerHelper] Папка: %s, Слой: %s, ID: %s", false, 
-        params.folderPath.ToCStr().Get(), 
-        params.layerName.ToCStr().Get(), 
-        params.baseID.ToCStr().Get());
-#endif
+    API_OPERATION("layer move");
+    TRACE_SPAN("CreateLayerAndMoveElements", "layer");
+    LOG_DEBUG("[LayerHelper] Начинаем создание папки, слоя и перемещение элементов");
+    LOG_DEBUG("[LayerHelper] Папка: %s, Слой: %s, ID: %s", 
+        params.folderPath.ToCStr(CC_UTF8).Get(), 
+        params.layerName.ToCStr(CC_UTF8).Get(), 
+        params.baseID.ToCStr(CC_UTF8).Get());
+
+    NameCache::BeginPass();
 
     // Используем Undo-группу для возможности отмены всей операции
     GSErrCode err = ACAPI_CallUndoableCommand("Create Layer and Move Elements", [&]() -> GSErrCode {
+        TRACE_SPAN("undo: Create Layer and Move Elements", "undo");
         // 1. Создаем слой
         API_AttributeIndex layerIndex;
-        if (!CreateLayer(params.folderPath, params.layerName, layerIndex)) {
-#ifdef DEBUG_UI_LOGS
-            ACAPI_WriteReport("[LayerHelper] Ошибка создания слоя", true);
-#endif
+        bool created;
+        {
+            TRACE_SPAN("create layer", "layer");
+            created = CreateLayer(params.folderPath, params.layerName, layerIndex);
+        }
+        if (!created) {
+            LOG_WARN("[LayerHelper] Ошибка создания слоя");
             return APIERR_GENERAL;
         }
 
         // 2. Перемещаем элементы в новый слой
-        if (!MoveSelectedElementsToLayer(layerIndex)) {
-#ifdef DEBUG_UI_LOGS
-            ACAPI_WriteReport("[LayerHelper] Ошибка перемещения элементов", true);
-#endif
+        bool moved;
+        {
+            TRACE_SPAN("move elements", "layer");
+            moved = MoveSelectedElementsToLayer(layerIndex);
+        }
+        if (!moved) {
+            LOG_WARN("[LayerHelper] Ошибка перемещения элементов");
             return APIERR_GENERAL;
         }
 
         // 3. Изменяем ID элементов (только если baseID не пустой)
         if (!params.baseID.IsEmpty()) {
             if (!ChangeSelectedElementsID(params.baseID)) {
-#ifdef DEBUG_UI_LOGS
-                ACAPI_WriteReport("[LayerHelper] Ошибка изменения ID элементов", true);
-#endif
+                LOG_WARN("[LayerHelper] Ошибка изменения ID элементов");
                 return APIERR_GENERAL;
             }
         } else {
-#ifdef DEBUG_UI_LOGS
-            ACAPI_WriteReport("[LayerHelper] ID элементов не изменяются (baseID пустой)", false);
-#endif
+            LOG_DEBUG("[LayerHelper] ID элементов не изменяются (baseID пустой)");
         }
 
         // 4. Скрываем слой, если требуется
         if (params.hideLayer) {
             if (!SetLayerVisibility(layerIndex, true)) {
-#ifdef DEBUG_UI_LOGS
-                ACAPI_WriteReport("[LayerHelper] Ошибка скрытия слоя", true);
-#endif
+                LOG_WARN("[LayerHelper] Ошибка скрытия слоя");
                 return APIERR_GENERAL;
             }
         }
 
-#ifdef DEBUG_UI_LOGS
-        ACAPI_WriteReport("[LayerHelper] Операция завершена успешно", false);
-#endif
+        LOG_DEBUG("[LayerHelper] Операция завершена успешно");
         return NoError;
     });
 
@@ -477,9 +382,7 @@ bool MoveLayerToFolder(API_AttributeIndex layerIndex, const GS::UniString& folde
     // Гарантируем существование папки и получаем её GUID
     GS::Guid folderGuid;
     if (!CreateLayerFolder(folderPath, folderGuid)) {
-#ifdef DEBUG_UI_LOGS
-        ACAPI_WriteReport("[LayerHelper] Не удалось подготовить папку для слоя: %s", true, folderPath.ToCStr().Get());
-#endif
+        LOG_WARN("[LayerHelper] Не удалось подготовить папку для слоя: %s", folderPath.ToCStr(CC_UTF8).Get());
         return false;
     }
 
@@ -493,12 +396,10 @@ bool MoveLayerToFolder(API_AttributeIndex layerIndex, const GS::UniString& folde
     layer.header.typeID = API_LayerID;
     layer.header.index = layerIndex;
     
-    GSErrCode err = ACAPI_Attribute_Get(&layer);
+    GSErrCode err = API_CALL(ACAPI_Attribute_Get, &layer);
     if (err != NoError) {
-#ifdef DEBUG_UI_LOGS
-        ACAPI_WriteReport("[LayerHelper] Не удалось получить информацию о слое (код: %d)", true, err);
-        ACAPI_WriteReport("[LayerHelper] Слой остался в корне, но папка создана: %s", false, folderPath.ToCStr().Get());
-#endif
+        LOG_WARN("[LayerHelper] Не удалось получить информацию о слое (код: %d)", err);
+        LOG_DEBUG("[LayerHelper] Слой остался в корне, но папка создана: %s", folderPath.ToCStr(CC_UTF8).Get());
         return true;
     }
     
@@ -508,11 +409,9 @@ bool MoveLayerToFolder(API_AttributeIndex layerIndex, const GS::UniString& folde
     currentLayer.header.typeID = API_LayerID;
     currentLayer.header.index = layerIndex;
     
-    err = ACAPI_Attribute_Get(&currentLayer);
+    err = API_CALL(ACAPI_Attribute_Get, &currentLayer);
     if (err != NoError) {
-#ifdef DEBUG_UI_LOGS
-        ACAPI_WriteReport("[LayerHelper] Ошибка получения слоя для перемещения (код: %d)", true, err);
-#endif
+        LOG_WARN("[LayerHelper] Ошибка получения слоя для перемещения (код: %d)", err);
         return false;
     }
     
@@ -532,24 +431,16 @@ bool MoveLayerToFolder(API_AttributeIndex layerIndex, const GS::UniString& folde
     targetFolder.guid = folderGuid;
     
     // Перемещаем слой в папку
-#ifdef DEBUG_UI_LOGS
-    ACAPI_WriteReport("[LayerHelper] Вызываем ACAPI_Attribute_Move...", false);
-#endif
-    err = ACAPI_Attribute_Move(foldersToMove, attributesToMove, targetFolder);
-#ifdef DEBUG_UI_LOGS
-    ACAPI_WriteReport("[LayerHelper] ACAPI_Attribute_Move вернул код: %d", false, err);
-#endif
+    LOG_DEBUG("[LayerHelper] Вызываем ACAPI_Attribute_Move...");
+    err = API_CALL(ACAPI_Attribute_Move, foldersToMove, attributesToMove, targetFolder);
+    LOG_DEBUG("[LayerHelper] ACAPI_Attribute_Move вернул код: %d", err);
     
     if (err != NoError) {
-#ifdef DEBUG_UI_LOGS
-        ACAPI_WriteReport("[LayerHelper] Ошибка перемещения слоя в папку '%s' (код: %d, hex: 0x%X)", true, 
-            folderPath.ToCStr().Get(), err, (unsigned int)err);
-        ACAPI_WriteReport("[LayerHelper] Слой остался в корне, но папка создана: %s", false, folderPath.ToCStr().Get());
-#endif
+        LOG_WARN("[LayerHelper] Ошибка перемещения слоя в папку '%s' (код: %d, hex: 0x%X)", 
+            folderPath.ToCStr(CC_UTF8).Get(), err, (unsigned int)err);
+        LOG_DEBUG("[LayerHelper] Слой остался в корне, но папка создана: %s", folderPath.ToCStr(CC_UTF8).Get());
     } else {
-#ifdef DEBUG_UI_LOGS
-        ACAPI_WriteReport("[LayerHelper] Слой успешно перемещен в папку: %s", false, folderPath.ToCStr().Get());
-#endif
+        LOG_DEBUG("[LayerHelper] Слой успешно перемещен в папку: %s", folderPath.ToCStr(CC_UTF8).Get());
     }
     
     return true;
@@ -558,21 +449,17 @@ bool MoveLayerToFolder(API_AttributeIndex layerIndex, const GS::UniString& folde
 // ---------------- Скрыть/показать слой ---------------- 
 bool SetLayerVisibility(API_AttributeIndex layerIndex, bool hidden)
 {
-#ifdef DEBUG_UI_LOGS
-    ACAPI_WriteReport("[LayerHelper] SetLayerVisibility: layer=%s, hidden=%s", false, 
-        layerIndex.ToUniString().ToCStr().Get(), hidden ? "true" : "false");
-#endif
+    LOG_DEBUG("[LayerHelper] SetLayerVisibility: layer=%s, hidden=%s", 
+        layerIndex.ToUniString().ToCStr(CC_UTF8).Get(), hidden ? "true" : "false");
     
     // Получаем текущий слой
     API_Attribute layer = {};
     layer.header.typeID = API_LayerID;
     layer.header.index = layerIndex;
     
-    GSErrCode err = ACAPI_Attribute_Get(&layer);
+    GSErrCode err = API_CALL(ACAPI_Attribute_Get, &layer);
     if (err != NoError) {
-#ifdef DEBUG_UI_LOGS
-        ACAPI_WriteReport("[LayerHelper] Ошибка получения слоя (код: %d)", true, err);
-#endif
+        LOG_WARN("[LayerHelper] Ошибка получения слоя (код: %d)", err);
         return false;
     }
     
@@ -584,17 +471,13 @@ bool SetLayerVisibility(API_AttributeIndex layerIndex, bool hidden)
     }
     
     // Сохраняем изменения через ACAPI_Attribute_Modify
-    err = ACAPI_Attribute_Modify(&layer, nullptr);
+    err = API_CALL(ACAPI_Attribute_Modify, &layer, nullptr);
     if (err != NoError) {
-#ifdef DEBUG_UI_LOGS
-        ACAPI_WriteReport("[LayerHelper] Ошибка установки видимости слоя (код: %d)", true, err);
-#endif
+        LOG_WARN("[LayerHelper] Ошибка установки видимости слоя (код: %d)", err);
         return false;
     }
     
-#ifdef DEBUG_UI_LOGS
-    ACAPI_WriteReport("[LayerHelper] Видимость слоя установлена: hidden=%s", false, hidden ? "true" : "false");
-#endif
+    LOG_DEBUG("[LayerHelper] Видимость слоя установлена: hidden=%s", hidden ? "true" : "false");
     return true;
 }
 
@@ -633,13 +516,13 @@ static void GetLayersFromFolderRecursive(
     if (folderPath.GetSize() > 0) {
         folder.path = folderPath;
         // Проверяем существование папки
-        if (ACAPI_Attribute_GetFolder(folder) != NoError)
+        if (API_CALL(ACAPI_Attribute_GetFolder, folder) != NoError)
             return; // Папка не существует
     }
     
     // Получаем содержимое папки
     API_AttributeFolderContent folderContent = {};
-    GSErrCode err = ACAPI_Attribute_GetFolderContent(folder, folderContent);
+    GSErrCode err = API_CALL(ACAPI_Attribute_GetFolderContent, folder, folderContent);
     
     if (err != NoError) {
         // Ошибка получения содержимого - пропускаем
@@ -660,7 +543,7 @@ static void GetLayersFromFolderRecursive(
         attr.header.guid = apiGuid;
         
         // Получаем информацию об атрибуте через GUID
-        GSErrCode err = ACAPI_Attribute_Get(&attr);
+        GSErrCode err = API_CALL(ACAPI_Attribute_Get, &attr);
         if (err == NoError) {
             LayerInfo info;
             info.name = attr.header.name;
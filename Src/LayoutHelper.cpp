@@ -5,6 +5,10 @@
 #include "APIEnvir.h"
 #include "ACAPinc.h"
 #include "LayoutHelper.hpp"
+#include "ApiProfiler.hpp"
+#include "TraceLog.hpp"
+#include "Logger.hpp"
+#include "LayoutGrouping.hpp"
 #include "DGModule.hpp"
 #include "DGDefs.h"
 #include "GSGuid.hpp"
@@ -13,6 +17,8 @@
 #include <new>
 #include <cstdio>
 #include <cmath>
+#include <string>
+#include <vector>
 
 namespace LayoutHelper {
 
@@ -79,21 +85,63 @@ private:
 	Int32 selectedIndex;
 };
 
+// -----------------------------------------------------------------------------
+// Кеш запроса: списки проекта живут, пока открыт хотя бы один RequestCacheScope
+// -----------------------------------------------------------------------------
+struct RequestCache {
+	UInt32 depth = 0;
+	bool hasLayouts = false;
+	bool hasMasters = false;
+	bool hasViews = false;
+	GS::Array<LayoutItem> layouts;
+	GS::Array<MasterLayoutItem> masters;
+	GS::Array<PlaceableViewItem> views;
+
+	void Clear ()
+	{
+		hasLayouts = hasMasters = hasViews = false;
+		layouts.Clear ();
+		masters.Clear ();
+		views.Clear ();
+	}
+};
+
+static RequestCache requestCache;
+
+RequestCacheScope::RequestCacheScope ()
+{
+	++requestCache.depth;
+}
+
+RequestCacheScope::~RequestCacheScope ()
+{
+	if (--requestCache.depth == 0)
+		requestCache.Clear ();
+}
+
+// Список макетов изменился (создан новый) — следующий вызов перечитает проект
+static void InvalidateLayoutCache ()
+{
+	requestCache.hasLayouts = false;
+	requestCache.layouts.Clear ();
+}
+
 // -----------------------------------------------------------------------------
 // GetLayoutList
 // -----------------------------------------------------------------------------
-GS::Array<LayoutItem> GetLayoutList ()
+static GS::Array<LayoutItem> ReadLayoutList ()
 {
+	API_OPERATION ("layout list");
 	GS::Array<LayoutItem> result;
 	GS::Array<API_DatabaseUnId> dbIds;
-	GSErrCode err = ACAPI_Database_GetLayoutDatabases (nullptr, &dbIds);
+	GSErrCode err = API_CALL (ACAPI_Database_GetLayoutDatabases, nullptr, &dbIds);
 	if (err != NoError || dbIds.IsEmpty ())
 		return result;
 	for (const API_DatabaseUnId& id : dbIds) {
 		API_DatabaseInfo dbInfo = {};
 		dbInfo.databaseUnId = id;
 		dbInfo.typeID = APIWind_LayoutID;
-		if (ACAPI_Window_GetDatabaseInfo (&dbInfo) == NoError) {
+		if (API_CALL (ACAPI_Window_GetDatabaseInfo, &dbInfo) == NoError) {
 			LayoutItem item;
 			item.databaseUnId = id;
 			item.name = GS::UniString (dbInfo.name);
@@ -108,6 +156,17 @@ GS::Array<LayoutItem> GetLayoutList ()
 	return result;
 }
 
+GS::Array<LayoutItem> GetLayoutList ()
+{
+	if (requestCache.depth == 0)
+		return ReadLayoutList ();
+	if (!requestCache.hasLayouts) {
+		requestCache.layouts = ReadLayoutList ();
+		requestCache.hasLayouts = true;
+	}
+	return requestCache.layouts;
+}
+
 // -----------------------------------------------------------------------------
 // GetLayoutFolders — список уникальных папок макетов
 // -----------------------------------------------------------------------------
@@ -136,21 +195,43 @@ GS::Array<LayoutFolderItem> GetLayoutFolders ()
 	return result;
 }
 
+// -----------------------------------------------------------------------------
+// GetLayoutGroups — имитация папок Навигатора по имени макета
+// -----------------------------------------------------------------------------
+GS::Array<LayoutGroup> GetLayoutGroups (const GS::Array<LayoutItem>& layouts)
+{
+	std::vector<std::string> names;
+	names.reserve (layouts.GetSize ());
+	for (const LayoutItem& layout : layouts)
+		names.push_back (std::string (layout.name.ToCStr (CC_UTF8).Get ()));
+
+	GS::Array<LayoutGroup> groups;
+	for (const LayoutGrouping::Group& source : LayoutGrouping::GroupByFolder (names)) {
+		LayoutGroup group;
+		group.groupName = GS::UniString (source.name.c_str (), CC_UTF8);
+		for (std::uint32_t index : source.indices)
+			group.layoutIndices.Push (index);
+		groups.Push (group);
+	}
+	return groups;
+}
+
 // -----------------------------------------------------------------------------
 // GetMasterLayoutList — шаблоны из папки Основные (Титульный лист, Обложка)
 // -----------------------------------------------------------------------------
-GS::Array<MasterLayoutItem> GetMasterLayoutList ()
+static GS::Array<MasterLayoutItem> ReadMasterLayoutList ()
 {
+	API_OPERATION ("layout list");
 	GS::Array<MasterLayoutItem> result;
 	GS::Array<API_DatabaseUnId> dbIds;
-	GSErrCode err = ACAPI_Database_GetMasterLayoutDatabases (nullptr, &dbIds);
+	GSErrCode err = API_CALL (ACAPI_Database_GetMasterLayoutDatabases, nullptr, &dbIds);
 	if (err != NoError || dbIds.IsEmpty ())
 		return result;
 	for (const API_DatabaseUnId& id : dbIds) {
 		API_DatabaseInfo dbInfo = {};
 		dbInfo.databaseUnId = id;
 		dbInfo.typeID = APIWind_MasterLayoutID;
-		if (ACAPI_Window_GetDatabaseInfo (&dbInfo) == NoError) {
+		if (API_CALL (ACAPI_Window_GetDatabaseInfo, &dbInfo) == NoError) {
 			MasterLayoutItem item;
 			item.databaseUnId = id;
 			item.name = GS::UniString (dbInfo.name);
@@ -165,6 +246,17 @@ GS::Array<MasterLayoutItem> GetMasterLayoutList ()
 	return result;
 }
 
+GS::Array<MasterLayoutItem> GetMasterLayoutList ()
+{
+	if (requestCache.depth == 0)
+		return ReadMasterLayoutList ();
+	if (!requestCache.hasMasters) {
+		requestCache.masters = ReadMasterLayoutList ();
+		requestCache.hasMasters = true;
+	}
+	return requestCache.masters;
+}
+
 // -----------------------------------------------------------------------------
 // GetPlaceableViews — виды из View Map для палитры «Организация чертежей»
 // Использует рекурсивный обход дерева View Map (GetNavigatorChildrenItems),
@@ -209,7 +301,7 @@ static void CollectPlaceableViewsRecursive (const API_NavigatorItem& node,
 	GS::Array<API_NavigatorItem> children;
 	API_NavigatorItem nodeCopy = node;
 	nodeCopy.mapId = API_PublicViewMap;
-	if (ACAPI_Navigator_GetNavigatorChildrenItems (&nodeCopy, &children) != NoError)
+	if (API_CALL (ACAPI_Navigator_GetNavigatorChildrenItems, &nodeCopy, &children) != NoError)
 		return;
 	// Путь папки для видов в этой ветке: если узел — папка с именем, добавляем его к пути
 	GS::UniString currentFolderPath = parentFolderPath;
@@ -247,13 +339,14 @@ static void CollectPlaceableViewsRecursive (const API_NavigatorItem& node,
 	}
 }
 
-GS::Array<PlaceableViewItem> GetPlaceableViews ()
+static GS::Array<PlaceableViewItem> ReadPlaceableViews ()
 {
+	API_OPERATION ("view list");
 	GS::Array<PlaceableViewItem> result;
 	int typeCounts[7] = {0};
 	API_NavigatorSet viewSet = {};
 	viewSet.mapId = API_PublicViewMap;
-	if (ACAPI_Navigator_GetNavigatorSet (&viewSet) != NoError)
+	if (API_CALL (ACAPI_Navigator_GetNavigatorSet, &viewSet) != NoError)
 		return result;
 	API_NavigatorItem rootItem = {};
 	BNZeroMemory (&rootItem, sizeof (rootItem));
@@ -261,23 +354,31 @@ GS::Array<PlaceableViewItem> GetPlaceableViews ()
 	rootItem.mapId = API_PublicViewMap;
 	CollectPlaceableViewsRecursive (rootItem, GS::UniString (""), result, typeCounts, 20);
 	// Логирование найденных видов по типам
-	char msg[512];
-	std::snprintf (msg, sizeof (msg),
-		"GetPlaceableViews: Планы=%d, Разрезы=%d, Фасады=%d, Внутр.фасады=%d, Детали=%d, Рабочие листы=%d, Документы3D=%d, Всего=%d",
+	LOG_DEBUG ("GetPlaceableViews: Планы=%d, Разрезы=%d, Фасады=%d, Внутр.фасады=%d, Детали=%d, Рабочие листы=%d, Документы3D=%d, Всего=%d",
 		typeCounts[0], typeCounts[1], typeCounts[2], typeCounts[3],
 		typeCounts[4], typeCounts[5], typeCounts[6],
 		static_cast<int>(result.GetSize()));
-	ACAPI_WriteReport (msg, false);
 	return result;
 }
 
+GS::Array<PlaceableViewItem> GetPlaceableViews ()
+{
+	if (requestCache.depth == 0)
+		return ReadPlaceableViews ();
+	if (!requestCache.hasViews) {
+		requestCache.views = ReadPlaceableViews ();
+		requestCache.hasViews = true;
+	}
+	return requestCache.views;
+}
+
 // -----------------------------------------------------------------------------
 // GetCurrentDrawingScale
 // -----------------------------------------------------------------------------
 double GetCurrentDrawingScale ()
 {
 	double scale = 100.0;
-	if (ACAPI_Drawing_GetDrawingScale (&scale) != NoError)
+	if (API_CALL (ACAPI_Drawing_GetDrawingScale, &scale) != NoError)
 		return 100.0;
 	return scale > 0 ? scale : 100.0;
 }
@@ -291,7 +392,7 @@ static bool GetSelectionFloorInd (short& outFloorInd)
 {
 	API_SelectionInfo selInfo = {};
 	GS::Array<API_Neig> selNeigs;
-	if (ACAPI_Selection_Get (&selInfo, &selNeigs, true) != NoError)
+	if (API_CALL (ACAPI_Selection_Get, &selInfo, &selNeigs, true) != NoError)
 		return false;
 	BMKillHandle ((GSHandle*) &selInfo.marquee.coords);
 	if (selInfo.typeID == API_SelEmpty || selNeigs.IsEmpty ())
@@ -301,7 +402,7 @@ static bool GetSelectionFloorInd (short& outFloorInd)
 	for (UIndex i = 0; i < selNeigs.GetSize (); i++) {
 		API_Element elem = {};
 		elem.header.guid = selNeigs[i].guid;
-		if (ACAPI_Element_Get (&elem) == NoError) {
+		if (API_CALL (ACAPI_Element_Get, &elem) == NoError) {
 			if (elem.header.floorInd > maxFloor)
 				maxFloor = elem.header.floorInd;
 			any = true;
@@ -321,14 +422,14 @@ static bool GetSelectionFloorInd (short& outFloorInd)
 static bool GetActiveFloorInd (short& outFloorInd)
 {
 	API_DatabaseInfo currentDb = {};
-	if (ACAPI_Database_GetCurrentDatabase (&currentDb) != NoError)
+	if (API_CALL (ACAPI_Database_GetCurrentDatabase, &currentDb) != NoError)
 		return false;
 	if (currentDb.typeID != APIWind_FloorPlanID)
 		return false;
 	
 	API_StoryInfo storyInfo = {};
 	// APIElemMask_FromFloorplan — в контексте текущего плана этажа (actStory для активного окна)
-	if (ACAPI_ProjectSetting_GetStorySettings (&storyInfo, APIElemMask_FromFloorplan) != NoError)
+	if (API_CALL (ACAPI_ProjectSetting_GetStorySettings, &storyInfo, APIElemMask_FromFloorplan) != NoError)
 		return false;
 	if (storyInfo.data == nullptr)
 		return false;
@@ -367,7 +468,7 @@ static void CollectStoryItems (const API_NavigatorItem& node, GS::Array<API_Navi
 		return;
 	}
 	GS::Array<API_NavigatorItem> children;
-	if (ACAPI_Navigator_GetNavigatorChildrenItems (const_cast<API_NavigatorItem*> (&node), &children) != NoError)
+	if (API_CALL (ACAPI_Navigator_GetNavigatorChildrenItems, const_cast<API_NavigatorItem*> (&node), &children) != NoError)
 		return;
 	for (UIndex c = 0; c < children.GetSize (); c++)
 		CollectStoryItems (children[c], outStories);
@@ -382,12 +483,12 @@ static bool FindStoryNavItemForFloor (const GS::Array<API_NavigatorItem>& storyI
 	{
 		API_NavigatorSet projSet = {};
 		projSet.mapId = API_ProjectMap;
-		if (ACAPI_Navigator_GetNavigatorSet (&projSet) == NoError) {
+		if (API_CALL (ACAPI_Navigator_GetNavigatorSet, &projSet) == NoError) {
 			API_NavigatorItem rootItem = {};
 			rootItem.guid = projSet.rootGuid;
 			rootItem.mapId = API_ProjectMap;
 			GS::Array<API_NavigatorItem> rootChildren;
-			if (ACAPI_Navigator_GetNavigatorChildrenItems (&rootItem, &rootChildren) == NoError) {
+			if (API_CALL (ACAPI_Navigator_GetNavigatorChildrenItems, &rootItem, &rootChildren) == NoError) {
 				GS::Array<API_NavigatorItem> treeStories;
 				for (UIndex c = 0; c < rootChildren.GetSize (); c++) {
 					if (rootChildren[c].itemType == API_StoryNavItem)
@@ -407,7 +508,7 @@ static bool FindStoryNavItemForFloor (const GS::Array<API_NavigatorItem>& storyI
 				}
 				// Запас: сопоставление по имени этажа из Story Settings (если floorNum не заполнен в дереве)
 				API_StoryInfo siName = {};
-				if (ACAPI_ProjectSetting_GetStorySettings (&siName) == NoError && siName.data != nullptr) {
+				if (API_CALL (ACAPI_ProjectSetting_GetStorySettings, &siName) == NoError && siName.data != nullptr) {
 					API_StoryType* stData = reinterpret_cast<API_StoryType*> (*siName.data);
 					short first = siName.firstStory, last = siName.lastStory;
 					short off = targetFloorInd - first;
@@ -430,7 +531,7 @@ static bool FindStoryNavItemForFloor (const GS::Array<API_NavigatorItem>& storyI
 				// Последний запас: индекс по firstStory
 				short firstStory = 0;
 				API_StoryInfo si2 = {};
-				if (ACAPI_ProjectSetting_GetStorySettings (&si2) == NoError) {
+				if (API_CALL (ACAPI_ProjectSetting_GetStorySettings, &si2) == NoError) {
 					firstStory = si2.firstStory;
 					if (si2.data != nullptr) BMKillHandle ((GSHandle*) &si2.data);
 				} else {
@@ -447,7 +548,7 @@ static bool FindStoryNavItemForFloor (const GS::Array<API_NavigatorItem>& storyI
 
 	// ---------- Стратегия A: story settings + имя (если передан список из View Map — редко совпадает) ----------
 	API_StoryInfo storyInfo = {};
-	bool haveStoryInfo = (ACAPI_ProjectSetting_GetStorySettings (&storyInfo) == NoError);
+	bool haveStoryInfo = (API_CALL (ACAPI_ProjectSetting_GetStorySettings, &storyInfo) == NoError);
 	if (haveStoryInfo && storyInfo.data != nullptr) {
 		API_StoryType* stData = reinterpret_cast<API_StoryType*> (*storyInfo.data);
 		short first  = storyInfo.firstStory;
@@ -463,7 +564,7 @@ static bool FindStoryNavItemForFloor (const GS::Array<API_NavigatorItem>& storyI
 		if (!targetStoryName.IsEmpty ()) {
 			for (UIndex i = 0; i < storyItems.GetSize (); i++) {
 				API_NavigatorItem fi = {};
-				if (ACAPI_Navigator_GetNavigatorItem (&storyItems[i].guid, &fi) == NoError) {
+				if (API_CALL (ACAPI_Navigator_GetNavigatorItem, &storyItems[i].guid, &fi) == NoError) {
 					GS::UniString navName (fi.uName);
 					if (navName == targetStoryName) {
 						outGuid = storyItems[i].guid;
@@ -473,7 +574,7 @@ static bool FindStoryNavItemForFloor (const GS::Array<API_NavigatorItem>& storyI
 			}
 			for (UIndex i = 0; i < storyItems.GetSize (); i++) {
 				API_NavigatorItem fi = {};
-				if (ACAPI_Navigator_GetNavigatorItem (&storyItems[i].guid, &fi) == NoError) {
+				if (API_CALL (ACAPI_Navigator_GetNavigatorItem, &storyItems[i].guid, &fi) == NoError) {
 					GS::UniString navName (fi.uName);
 					if (navName.Contains (targetStoryName)) {
 						outGuid = storyItems[i].guid;
@@ -518,7 +619,7 @@ static bool FindStoryForSelection (const GS::Array<API_NavigatorItem>& items,
 static bool GetCurrentViewNavigatorItem (API_Guid& outGuid)
 {
 	API_DatabaseInfo currentDb = {};
-	if (ACAPI_Database_GetCurrentDatabase (&currentDb) != NoError)
+	if (API_CALL (ACAPI_Database_GetCurrentDatabase, &currentDb) != NoError)
 		return false;
 	API_NavigatorItemTypeID itemType = API_UndefinedNavItem;
 	switch (currentDb.typeID) {
@@ -536,7 +637,7 @@ static bool GetCurrentViewNavigatorItem (API_Guid& outGuid)
 	navItem.itemType = itemType;
 	navItem.db = currentDb;
 	GS::Array<API_NavigatorItem> items;
-	if (ACAPI_Navigator_SearchNavigatorItem (&navItem, &items) != NoError || items.IsEmpty ())
+	if (API_CALL (ACAPI_Navigator_SearchNavigatorItem, &navItem, &items) != NoError || items.IsEmpty ())
 		return false;
 	// Сначала ищем точное совпадение по databaseUnId (текущий активный вид)
 	for (UIndex i = 0; i < items.GetSize (); i++) {
@@ -560,7 +661,7 @@ static bool GetCurrentViewNavigatorItem (API_Guid& outGuid)
 static bool GetProjectMapItemForCurrentView (API_Guid& outGuid)
 {
 	API_DatabaseInfo currentDb = {};
-	if (ACAPI_Database_GetCurrentDatabase (&currentDb) != NoError)
+	if (API_CALL (ACAPI_Database_GetCurrentDatabase, &currentDb) != NoError)
 		return false;
 	API_NavigatorItemTypeID itemType = API_UndefinedNavItem;
 	switch (currentDb.typeID) {
@@ -578,7 +679,7 @@ static bool GetProjectMapItemForCurrentView (API_Guid& outGuid)
 	navItem.itemType = itemType;
 	navItem.db = currentDb;
 	GS::Array<API_NavigatorItem> items;
-	if (ACAPI_Navigator_SearchNavigatorItem (&navItem, &items) != NoError || items.IsEmpty ())
+	if (API_CALL (ACAPI_Navigator_SearchNavigatorItem, &navItem, &items) != NoError || items.IsEmpty ())
 		return false;
 	// Сначала ищем точное совпадение по databaseUnId (текущий активный вид)
 	for (UIndex i = 0; i < items.GetSize (); i++) {
@@ -606,7 +707,7 @@ static bool GetMarqueeBounds (API_Box& outBox)
 {
 	API_SelectionInfo selectionInfo = {};
 	GS::Array<API_Neig> selNeigs;
-	if (ACAPI_Selection_Get (&selectionInfo, &selNeigs, true) != NoError)
+	if (API_CALL (ACAPI_Selection_Get, &selectionInfo, &selNeigs, true) != NoError)
 		return false;
 	const bool isMarquee = (selectionInfo.typeID == API_MarqueePoly ||
 		selectionInfo.typeID == API_MarqueeHorBox ||
@@ -668,7 +769,7 @@ static bool GetSelectionBoundsWithMargin (API_Box& outBox)
 {
 	API_SelectionInfo selectionInfo = {};
 	GS::Array<API_Neig> selNeigs;
-	if (ACAPI_Selection_Get (&selectionInfo, &selNeigs, true) != NoError)
+	if (API_CALL (ACAPI_Selection_Get, &selectionInfo, &selNeigs, true) != NoError)
 		return false;
 	BMKillHandle ((GSHandle*)&selectionInfo.marquee.coords);
 	if (selectionInfo.typeID == API_SelEmpty || selNeigs.IsEmpty ())
@@ -678,10 +779,10 @@ static bool GetSelectionBoundsWithMargin (API_Box& outBox)
 	for (UIndex i = 0; i < selNeigs.GetSize () && i < static_cast<UIndex>(selectionInfo.sel_nElemEdit); i++) {
 		API_Elem_Head elemHead = {};
 		elemHead.guid = selNeigs[i].guid;
-		if (ACAPI_Element_GetHeader (&elemHead) != NoError)
+		if (API_CALL (ACAPI_Element_GetHeader, &elemHead) != NoError)
 			continue;
 		API_Box3D bounds = {};
-		if (ACAPI_Element_CalcBounds (&elemHead, &bounds) != NoError)
+		if (API_CALL (ACAPI_Element_CalcBounds, &elemHead, &bounds) != NoError)
 			continue;
 		if (first) {
 			xMin = bounds.xMin;
@@ -714,7 +815,7 @@ static GS::HashSet<API_AttributeIndex> GetLayersOfSelection ()
 	GS::HashSet<API_AttributeIndex> layers;
 	API_SelectionInfo selectionInfo = {};
 	GS::Array<API_Neig> selNeigs;
-	if (ACAPI_Selection_Get (&selectionInfo, &selNeigs, true) != NoError)
+	if (API_CALL (ACAPI_Selection_Get, &selectionInfo, &selNeigs, true) != NoError)
 		return layers;
 	BMKillHandle ((GSHandle*)&selectionInfo.marquee.coords);
 	if (selectionInfo.typeID == API_SelEmpty || selNeigs.IsEmpty ())
@@ -722,7 +823,7 @@ static GS::HashSet<API_AttributeIndex> GetLayersOfSelection ()
 	for (UIndex i = 0; i < selNeigs.GetSize () && i < static_cast<UIndex>(selectionInfo.sel_nElemEdit); i++) {
 		API_Element elem = {};
 		elem.header.guid = selNeigs[i].guid;
-		if (ACAPI_Element_Get (&elem) == NoError)
+		if (API_CALL (ACAPI_Element_Get, &elem) == NoError)
 			layers.Add (elem.header.layer);
 	}
 	return layers;
@@ -752,13 +853,13 @@ static bool CreateLayerCombForSelection (const GS::HashSet<API_AttributeIndex>&
 	API_Attr_Head existing = {};
 	existing.typeID = API_LayerCombID;
 	CHCopyC (kTempLayerCombName, existing.name);
-	if (ACAPI_Attribute_Search (&existing) == NoError)
-		ACAPI_Attribute_Delete (existing);
+	if (API_CALL (ACAPI_Attribute_Search, &existing) == NoError)
+		API_CALL (ACAPI_Attribute_Delete, existing);
 	GS::Array<API_Attribute> layerCombs;
-	if (ACAPI_Attribute_GetAttributesByType (API_LayerCombID, layerCombs) != NoError || layerCombs.IsEmpty ())
+	if (API_CALL (ACAPI_Attribute_GetAttributesByType, API_LayerCombID, layerCombs) != NoError || layerCombs.IsEmpty ())
 		return false;
 	API_AttributeDef defs = {};
-	if (ACAPI_Attribute_GetDef (API_LayerCombID, layerCombs[0].header.index, &defs) != NoError || defs.layer_statItems == nullptr)
+	if (API_CALL (ACAPI_Attribute_GetDef, API_LayerCombID, layerCombs[0].header.index, &defs) != NoError || defs.layer_statItems == nullptr)
 		return false;
 	GS::HashTable<API_AttributeIndex, API_LayerStat>* newStats = new GS::HashTable<API_AttributeIndex, API_LayerStat> ();
 	for (auto it = defs.layer_statItems->BeginPairs (); it != nullptr; ++it) {
@@ -779,7 +880,7 @@ static bool CreateLayerCombForSelection (const GS::HashSet<API_AttributeIndex>&
 	attrib.header.typeID = API_LayerCombID;
 	strcpy (attrib.layerComb.head.name, kTempLayerCombName);
 	attrib.layerComb.lNumb = static_cast<Int32> (newStats->GetSize ());
-	GSErrCode err = ACAPI_Attribute_Create (&attrib, &defs);
+	GSErrCode err = API_CALL (ACAPI_Attribute_Create, &attrib, &defs);
 	ACAPI_DisposeAttrDefsHdls (&defs);
 	if (err != NoError)
 		return false;
@@ -799,7 +900,7 @@ static API_Guid CloneViewMapViewToTemp (const API_Guid& viewMapViewGuid, GS::Uni
 	API_NavigatorItem viewItem = {};
 	viewItem.guid = viewMapViewGuid;
 	viewItem.mapId = API_PublicViewMap;
-	if (ACAPI_Navigator_GetNavigatorItem (&viewMapViewGuid, &viewItem) != NoError)
+	if (API_CALL (ACAPI_Navigator_GetNavigatorItem, &viewMapViewGuid, &viewItem) != NoError)
 		return APINULLGuid;
 
 	GS::UniString originalName = GS::UniString (viewItem.uName);
@@ -811,36 +912,36 @@ static API_Guid CloneViewMapViewToTemp (const API_Guid& viewMapViewGuid, GS::Uni
 	// временно переключив текущую базу на базу этого вида.
 	API_Guid sourceGuid = {};
 	API_DatabaseInfo prevDb = {};
-	if (ACAPI_Database_GetCurrentDatabase (&prevDb) != NoError)
+	if (API_CALL (ACAPI_Database_GetCurrentDatabase, &prevDb) != NoError)
 		return APINULLGuid;
 
 	API_DatabaseInfo targetDb = viewItem.db;
-	if (ACAPI_Database_ChangeCurrentDatabase (&targetDb) != NoError) {
-		ACAPI_Database_ChangeCurrentDatabase (&prevDb);
+	if (API_CALL (ACAPI_Database_ChangeCurrentDatabase, &targetDb) != NoError) {
+		API_CALL (ACAPI_Database_ChangeCurrentDatabase, &prevDb);
 		return APINULLGuid;
 	}
 
 	bool gotSource = GetProjectMapItemForCurrentView (sourceGuid);
 
 	// Возвращаемся в исходную базу независимо от результата
-	ACAPI_Database_ChangeCurrentDatabase (&prevDb);
+	API_CALL (ACAPI_Database_ChangeCurrentDatabase, &prevDb);
 
 	if (!gotSource || sourceGuid == APINULLGuid)
 		return APINULLGuid;
 
 	API_NavigatorSet viewSet = {};
 	viewSet.mapId = API_PublicViewMap;
-	if (ACAPI_Navigator_GetNavigatorSet (&viewSet) != NoError)
+	if (API_CALL (ACAPI_Navigator_GetNavigatorSet, &viewSet) != NoError)
 		return APINULLGuid;
 	API_NavigatorItem rootItem = {};
 	rootItem.guid = viewSet.rootGuid;
 	rootItem.mapId = API_PublicViewMap;
 	GS::Array<API_NavigatorItem> rootChildren;
-	if (ACAPI_Navigator_GetNavigatorChildrenItems (&rootItem, &rootChildren) != NoError || rootChildren.IsEmpty ())
+	if (API_CALL (ACAPI_Navigator_GetNavigatorChildrenItems, &rootItem, &rootChildren) != NoError || rootChildren.IsEmpty ())
 		return APINULLGuid;
 	API_Guid parentGuid = rootChildren[0].guid;
 	API_Guid clonedGuid = {};
-	if (ACAPI_Navigator_CloneProjectMapItemToViewMap (&sourceGuid, &parentGuid, &clonedGuid) != NoError || clonedGuid == APINULLGuid)
+	if (API_CALL (ACAPI_Navigator_CloneProjectMapItemToViewMap, &sourceGuid, &parentGuid, &clonedGuid) != NoError || clonedGuid == APINULLGuid)
 		return APINULLGuid;
 
 	// Копируем zoom, масштаб и комбинацию слоёв из исходного вида в клон
@@ -848,19 +949,19 @@ static API_Guid CloneViewMapViewToTemp (const API_Guid& viewMapViewGuid, GS::Uni
 	API_NavigatorItem origNavItem = {};
 	origNavItem.guid = viewMapViewGuid;
 	origNavItem.mapId = API_PublicViewMap;
-	if (ACAPI_Navigator_GetNavigatorView (&origNavItem, &origView) == NoError) {
+	if (API_CALL (ACAPI_Navigator_GetNavigatorView, &origNavItem, &origView) == NoError) {
 		API_NavigatorItem clonedNavItem = {};
 		clonedNavItem.guid = clonedGuid;
 		clonedNavItem.mapId = API_PublicViewMap;
 		API_NavigatorView cloneView = {};
-		if (ACAPI_Navigator_GetNavigatorView (&clonedNavItem, &cloneView) == NoError) {
+		if (API_CALL (ACAPI_Navigator_GetNavigatorView, &clonedNavItem, &cloneView) == NoError) {
 			cloneView.zoom = origView.zoom;
 			cloneView.saveZoom = origView.saveZoom;
 			cloneView.drawingScale = origView.drawingScale;
 			cloneView.saveDScale = origView.saveDScale;
 			CHCopyC (origView.layerCombination, cloneView.layerCombination);
 			cloneView.saveLaySet = origView.saveLaySet;
-			ACAPI_Navigator_ChangeNavigatorView (&clonedNavItem, &cloneView);
+			API_CALL (ACAPI_Navigator_ChangeNavigatorView, &clonedNavItem, &cloneView);
 			if (cloneView.layerStats != nullptr) {
 				delete cloneView.layerStats;
 				cloneView.layerStats = nullptr;
@@ -874,10 +975,10 @@ static API_Guid CloneViewMapViewToTemp (const API_Guid& viewMapViewGuid, GS::Uni
 
 	// Имя клона: temp_<имя>
 	API_NavigatorItem clonedNavItem = {};
-	if (ACAPI_Navigator_GetNavigatorItem (&clonedGuid, &clonedNavItem) == NoError) {
+	if (API_CALL (ACAPI_Navigator_GetNavigatorItem, &clonedGuid, &clonedNavItem) == NoError) {
 		clonedNavItem.customName = true;
 		GS::ucscpy (clonedNavItem.uName, outCloneName.ToUStr ());
-		ACAPI_Navigator_ChangeNavigatorItem (&clonedNavItem);
+		API_CALL (ACAPI_Navigator_ChangeNavigatorItem, &clonedNavItem);
 	}
 	return clonedGuid;
 }
@@ -895,17 +996,17 @@ static API_Guid CloneViewToViewMapWithLayerFilter (const GS::HashSet<API_Attribu
 		return APINULLGuid;
 	API_NavigatorSet viewSet = {};
 	viewSet.mapId = API_PublicViewMap;
-	if (ACAPI_Navigator_GetNavigatorSet (&viewSet) != NoError)
+	if (API_CALL (ACAPI_Navigator_GetNavigatorSet, &viewSet) != NoError)
 		return APINULLGuid;
 	API_NavigatorItem rootItem = {};
 	rootItem.guid = viewSet.rootGuid;
 	rootItem.mapId = API_PublicViewMap;
 	GS::Array<API_NavigatorItem> rootChildren;
-	if (ACAPI_Navigator_GetNavigatorChildrenItems (&rootItem, &rootChildren) != NoError || rootChildren.IsEmpty ())
+	if (API_CALL (ACAPI_Navigator_GetNavigatorChildrenItems, &rootItem, &rootChildren) != NoError || rootChildren.IsEmpty ())
 		return APINULLGuid;
 	API_Guid parentGuid = rootChildren[0].guid;
 	API_Guid clonedGuid = {};
-	if (ACAPI_Navigator_CloneProjectMapItemToViewMap (&sourceGuid, &parentGuid, &clonedGuid) != NoError || clonedGuid == APINULLGuid)
+	if (API_CALL (ACAPI_Navigator_CloneProjectMapItemToViewMap, &sourceGuid, &parentGuid, &clonedGuid) != NoError || clonedGuid == APINULLGuid)
 		return APINULLGuid;
 	if (selectedLayers.IsEmpty ()) {
 		if (zoomBox != nullptr) {
@@ -913,7 +1014,7 @@ static API_Guid CloneViewToViewMapWithLayerFilter (const GS::HashSet<API_Attribu
 			clonedNavItem.guid = clonedGuid;
 			clonedNavItem.mapId = API_PublicViewMap;
 			API_NavigatorView navView = {};
-			if (ACAPI_Navigator_GetNavigatorView (&clonedNavItem, &navView) == NoError) {
+			if (API_CALL (ACAPI_Navigator_GetNavigatorView, &clonedNavItem, &navView) == NoError) {
 				if (navView.layerStats != nullptr) {
 					delete navView.layerStats;
 					navView.layerStats = nullptr;
@@ -922,16 +1023,16 @@ static API_Guid CloneViewToViewMapWithLayerFilter (const GS::HashSet<API_Attribu
 				navView.saveZoom = true;
 				navView.drawingScale = drawingScale;
 				navView.saveDScale = true;
-				ACAPI_Navigator_ChangeNavigatorView (&clonedNavItem, &navView);
+				API_CALL (ACAPI_Navigator_ChangeNavigatorView, &clonedNavItem, &navView);
 			}
 		}
 		// Присваиваем имя вида даже когда не создаём отдельную комбинацию слоёв (режим «по рамке» и т.п.).
 		if (!customViewName.IsEmpty ()) {
 			API_NavigatorItem clonedNavItem = {};
-			if (ACAPI_Navigator_GetNavigatorItem (&clonedGuid, &clonedNavItem) == NoError) {
+			if (API_CALL (ACAPI_Navigator_GetNavigatorItem, &clonedGuid, &clonedNavItem) == NoError) {
 				clonedNavItem.customName = true;
 				GS::ucscpy (clonedNavItem.uName, customViewName.ToUStr ());
-				ACAPI_Navigator_ChangeNavigatorItem (&clonedNavItem);
+				API_CALL (ACAPI_Navigator_ChangeNavigatorItem, &clonedNavItem);
 			}
 		}
 		return clonedGuid;
@@ -943,7 +1044,7 @@ static API_Guid CloneViewToViewMapWithLayerFilter (const GS::HashSet<API_Attribu
 	clonedNavItem.guid = clonedGuid;
 	clonedNavItem.mapId = API_PublicViewMap;
 	API_NavigatorView navView = {};
-	if (ACAPI_Navigator_GetNavigatorView (&clonedNavItem, &navView) != NoError) {
+	if (API_CALL (ACAPI_Navigator_GetNavigatorView, &clonedNavItem, &navView) != NoError) {
 		if (navView.layerStats != nullptr) { delete navView.layerStats; navView.layerStats = nullptr; }
 		return clonedGuid;
 	}
@@ -959,12 +1060,12 @@ static API_Guid CloneViewToViewMapWithLayerFilter (const GS::HashSet<API_Attribu
 		navView.zoom = *zoomBox;
 		navView.saveZoom = true;
 	}
-	ACAPI_Navigator_ChangeNavigatorView (&clonedNavItem, &navView);
+	API_CALL (ACAPI_Navigator_ChangeNavigatorView, &clonedNavItem, &navView);
 	if (!customViewName.IsEmpty ()) {
-		if (ACAPI_Navigator_GetNavigatorItem (&clonedGuid, &clonedNavItem) == NoError) {
+		if (API_CALL (ACAPI_Navigator_GetNavigatorItem, &clonedGuid, &clonedNavItem) == NoError) {
 			clonedNavItem.customName = true;
 			GS::ucscpy (clonedNavItem.uName, customViewName.ToUStr ());
-			ACAPI_Navigator_ChangeNavigatorItem (&clonedNavItem);
+			API_CALL (ACAPI_Navigator_ChangeNavigatorItem, &clonedNavItem);
 		}
 	}
 	return clonedGuid;
@@ -978,7 +1079,7 @@ static bool ApplyLayerCombToView (const API_Guid& viewGuid, const char* layerCom
 	API_NavigatorItem navItem = {};
 	navItem.guid = viewGuid;
 	API_NavigatorView navView = {};
-	if (ACAPI_Navigator_GetNavigatorView (&navItem, &navView) != NoError)
+	if (API_CALL (ACAPI_Navigator_GetNavigatorView, &navItem, &navView) != NoError)
 		return false;
 	if (navView.layerStats != nullptr) {
 		delete navView.layerStats;
@@ -986,7 +1087,7 @@ static bool ApplyLayerCombToView (const API_Guid& viewGuid, const char* layerCom
 	}
 	CHCopyC (layerCombName, navView.layerCombination);
 	navView.saveLaySet = true;
-	return (ACAPI_Navigator_ChangeNavigatorView (&navItem, &navView) == NoError);
+	return (API_CALL (ACAPI_Navigator_ChangeNavigatorView, &navItem, &navView) == NoError);
 }
 
 static void RestoreViewLayerState (ViewLayerState& state)
@@ -994,12 +1095,12 @@ static void RestoreViewLayerState (ViewLayerState& state)
 	API_NavigatorItem navItem = {};
 	navItem.guid = state.viewGuid;
 	API_NavigatorView navView = {};
-	if (ACAPI_Navigator_GetNavigatorView (&navItem, &navView) != NoError)
+	if (API_CALL (ACAPI_Navigator_GetNavigatorView, &navItem, &navView) != NoError)
 		return;
 	navView.layerStats = state.layerStatsCopy;
 	CHCopyC (state.layerCombination, navView.layerCombination);
 	navView.saveLaySet = state.saveLaySet;
-	ACAPI_Navigator_ChangeNavigatorView (&navItem, &navView);
+	API_CALL (ACAPI_Navigator_ChangeNavigatorView, &navItem, &navView);
 	if (state.layerStatsCopy != nullptr) {
 		delete state.layerStatsCopy;
 		state.layerStatsCopy = nullptr;
@@ -1007,77 +1108,18 @@ static void RestoreViewLayerState (ViewLayerState& state)
 }
 
 // -----------------------------------------------------------------------------
-// Вычислить прямоугольник области сетки в мм (left, bottom, width, height от левого нижнего угла листа).
-// Макет: layoutInfo; сетка gridRows×gridCols, зазор gridGapMm; область startRow, startCol, spanRows, spanCols.
+// Лист макета для расчётов размещения (Src/Core/PlacementMath): размер и поля в мм
 // -----------------------------------------------------------------------------
-static void GetGridRegionRect (const API_LayoutInfo& layoutInfo,
-	Int32 gridRows, Int32 gridCols, double gridGapMm,
-	Int32 startRow, Int32 startCol, Int32 spanRows, Int32 spanCols,
-	double& outLeftMm, double& outBottomMm, double& outWidthMm, double& outHeightMm)
+static PlacementMath::Sheet ToSheet (const API_LayoutInfo& layoutInfo)
 {
-	const double availW = layoutInfo.sizeX - layoutInfo.leftMargin - layoutInfo.rightMargin;
-	const double availH = layoutInfo.sizeY - layoutInfo.topMargin - layoutInfo.bottomMargin;
-	if (gridCols < 1) gridCols = 1;
-	if (gridRows < 1) gridRows = 1;
-	const double gap = gridGapMm > 0 ? gridGapMm : 0;
-	const double cellW = (availW - (gridCols - 1) * gap) / gridCols;
-	const double cellH = (availH - (gridRows - 1) * gap) / gridRows;
-	outLeftMm   = layoutInfo.leftMargin + startCol * (cellW + gap);
-	// В HTML передаётся regionStartRow уже как индекс ряда от низа листа (0 = нижний ряд).
-	if (spanRows < 1) spanRows = 1;
-	if (spanRows > gridRows) spanRows = gridRows;
-	Int32 rowFromBottom = (startRow >= 0 && startRow < gridRows) ? startRow : 0;
-	outBottomMm = layoutInfo.bottomMargin + rowFromBottom * (cellH + gap);
-	outWidthMm  = spanCols * cellW + (spanCols > 1 ? (spanCols - 1) * gap : 0);
-	outHeightMm = spanRows * cellH + (spanRows > 1 ? (spanRows - 1) * gap : 0);
-}
-
-// -----------------------------------------------------------------------------
-// Вычислить позицию вида на макете по точке привязки (как было до экспериментов с pos).
-// layoutInfo — параметры макета (sizeX, sizeY, margins в мм); pos в метрах.
-// outAnchor и outPos — куда на макете привязать выбранный угол/центр чертежа.
-// -----------------------------------------------------------------------------
-static void GetDrawingPositionForAnchor (const API_LayoutInfo& layoutInfo, PlaceParams::Anchor anchor, API_AnchorID& outAnchor, API_Coord& outPos)
-{
-	const double MM_TO_M = 1.0 / 1000.0;
-	const double left   = layoutInfo.leftMargin * MM_TO_M;
-	const double right  = (layoutInfo.sizeX - layoutInfo.rightMargin) * MM_TO_M;
-	const double top    = (layoutInfo.sizeY - layoutInfo.topMargin) * MM_TO_M;
-	const double bottom = layoutInfo.bottomMargin * MM_TO_M;
-	const double cx = left + (right - left) * 0.5;
-	const double cy = bottom + (top - bottom) * 0.5;
-	switch (anchor) {
-		case PlaceParams::Anchor::LeftBottom:
-			outAnchor = APIAnc_LB;
-			outPos.x = left;
-			outPos.y = bottom;
-			break;
-		case PlaceParams::Anchor::LeftTop:
-			outAnchor = APIAnc_LT;
-			outPos.x = left;
-			outPos.y = top;
-			break;
-		case PlaceParams::Anchor::RightTop:
-			outAnchor = APIAnc_RT;
-			outPos.x = right;
-			outPos.y = top;
-			break;
-		case PlaceParams::Anchor::RightBottom:
-			outAnchor = APIAnc_RB;
-			outPos.x = right;
-			outPos.y = bottom;
-			break;
-		case PlaceParams::Anchor::Middle:
-			outAnchor = APIAnc_MM;
-			outPos.x = cx;
-			outPos.y = cy;
-			break;
-		default:
-			outAnchor = APIAnc_LB;
-			outPos.x = left;
-			outPos.y = bottom;
-			break;
-	}
+	PlacementMath::Sheet sheet;
+	sheet.sizeX = layoutInfo.sizeX;
+	sheet.sizeY = layoutInfo.sizeY;
+	sheet.leftMargin = layoutInfo.leftMargin;
+	sheet.rightMargin = layoutInfo.rightMargin;
+	sheet.topMargin = layoutInfo.topMargin;
+	sheet.bottomMargin = layoutInfo.bottomMargin;
+	return sheet;
 }
 
 // -----------------------------------------------------------------------------
@@ -1092,8 +1134,9 @@ static void GetDrawingPositionForAnchor (const API_LayoutInfo& layoutInfo, Place
 // -----------------------------------------------------------------------------
 static bool DoPlaceLinkedDrawingOnLayout (API_DatabaseUnId chosenLayoutId, const PlaceParams& params)
 {
+	TRACE_SPAN ("DoPlaceLinkedDrawingOnLayout", "layout");
 	API_DatabaseInfo currentDb = {};
-	if (ACAPI_Database_GetCurrentDatabase (&currentDb) != NoError)
+	if (API_CALL (ACAPI_Database_GetCurrentDatabase, &currentDb) != NoError)
 		return false;
 	if (currentDb.typeID == APIWind_3DModelID) {
 		ACAPI_WriteReport ("Чтобы разместить вид из 3D, создайте Документ из 3D (меню Archicad), откройте его и нажмите Разместить в макете.", true);
@@ -1111,39 +1154,33 @@ static bool DoPlaceLinkedDrawingOnLayout (API_DatabaseUnId chosenLayoutId, const
 	API_LayoutInfo layoutInfo = {};
 	BNZeroMemory (&layoutInfo, sizeof (layoutInfo));
 	API_DatabaseUnId layoutDbId = chosenLayoutId;
-	GSErrCode layoutSetsErr = ACAPI_Navigator_GetLayoutSets (&layoutInfo, &layoutDbId, nullptr);
+	GSErrCode layoutSetsErr = API_CALL (ACAPI_Navigator_GetLayoutSets, &layoutInfo, &layoutDbId, nullptr);
 	if (layoutSetsErr != NoError && layoutInfo.customData != nullptr) {
 		delete layoutInfo.customData;
 		layoutInfo.customData = nullptr;
 	}
 	// Fallback: если размеры не получены (например, макет не текущее окно), переключаемся на макет и запрашиваем снова
 	if (layoutInfo.sizeX < 1.0 || layoutInfo.sizeY < 1.0) {
+		TRACE_SPAN ("database switch", "layout");
 		API_DatabaseInfo layoutDb = {};
 		layoutDb.databaseUnId = chosenLayoutId;
 		layoutDb.typeID = APIWind_LayoutID;
-		if (ACAPI_Database_ChangeCurrentDatabase (&layoutDb) == NoError) {
+		if (API_CALL (ACAPI_Database_ChangeCurrentDatabase, &layoutDb) == NoError) {
 			BNZeroMemory (&layoutInfo, sizeof (layoutInfo));
-			if (ACAPI_Navigator_GetLayoutSets (&layoutInfo, nullptr, nullptr) == NoError && layoutInfo.sizeX >= 1.0 && layoutInfo.sizeY >= 1.0) {
-				ACAPI_WriteReport ("ToLayout: размер макета получен после переключения на макет.", false);
+			if (API_CALL (ACAPI_Navigator_GetLayoutSets, &layoutInfo, nullptr, nullptr) == NoError && layoutInfo.sizeX >= 1.0 && layoutInfo.sizeY >= 1.0) {
+				LOG_INFO ("ToLayout: размер макета получен после переключения на макет.");
 			}
-			ACAPI_Database_ChangeCurrentDatabase (&currentDb);
+			API_CALL (ACAPI_Database_ChangeCurrentDatabase, &currentDb);
 			if (layoutInfo.customData != nullptr) {
 				delete layoutInfo.customData;
 				layoutInfo.customData = nullptr;
 			}
 		}
 	}
-	// Некоторые версии/контексты возвращают размеры в метрах (0.21 x 0.297); API указывает мм — приводим к мм при необходимости
-	if (layoutInfo.sizeX > 0.001 && layoutInfo.sizeX < 100.0 && layoutInfo.sizeY > 0.001 && layoutInfo.sizeY < 100.0) {
-		layoutInfo.sizeX *= 1000.0;
-		layoutInfo.sizeY *= 1000.0;
-		layoutInfo.leftMargin *= 1000.0;
-		layoutInfo.rightMargin *= 1000.0;
-		layoutInfo.topMargin *= 1000.0;
-		layoutInfo.bottomMargin *= 1000.0;
-		ACAPI_WriteReport ("ToLayout: размеры макета переведены из метров в мм.", false);
-	}
-	if (params.useGridRegion && (layoutInfo.sizeX < 1.0 || layoutInfo.sizeY < 1.0)) {
+	PlacementMath::Sheet sheet = ToSheet (layoutInfo);
+	if (PlacementMath::NormalizeToMillimeters (sheet))
+		LOG_INFO ("ToLayout: размеры макета переведены из метров в мм.");
+	if (params.useGridRegion && (sheet.sizeX < 1.0 || sheet.sizeY < 1.0)) {
 		ACAPI_WriteReport ("LayoutHelper: не удалось получить размер выбранного макета (GetLayoutSets).", true);
 		return false;
 	}
@@ -1155,22 +1192,19 @@ static bool DoPlaceLinkedDrawingOnLayout (API_DatabaseUnId chosenLayoutId, const
 		navItem.guid = params.placeViewGuid;
 		navItem.mapId = API_PublicViewMap;
 		API_NavigatorView navView = {};
-		if (ACAPI_Navigator_GetNavigatorView (&navItem, &navView) == NoError) {
+		if (API_CALL (ACAPI_Navigator_GetNavigatorView, &navItem, &navView) == NoError) {
 			zoomBox = navView.zoom;
 			hasZoomBox = (navView.zoom.xMax > navView.zoom.xMin + 1e-6 && navView.zoom.yMax > navView.zoom.yMin + 1e-6);
 
 			// Лог текущих параметров вида, который размещаем (масштаб, комбинация слоёв, zoom)
-			char msg[512];
-			std::snprintf (msg, sizeof (msg),
-				"ToLayout view: guid=%s, dScale=%d saveD=%d, layComb='%s' saveLay=%d, zoom=[%.3f..%.3f]x[%.3f..%.3f]",
-				APIGuidToString (params.placeViewGuid).ToCStr ().Get (),
+			LOG_DEBUG ("ToLayout view: guid=%s, dScale=%d saveD=%d, layComb='%s' saveLay=%d, zoom=[%.3f..%.3f]x[%.3f..%.3f]",
+				APIGuidToString (params.placeViewGuid).ToCStr (CC_UTF8).Get (),
 				navView.drawingScale,
 				navView.saveDScale ? 1 : 0,
 				navView.layerCombination,
 				navView.saveLaySet ? 1 : 0,
 				navView.zoom.xMin, navView.zoom.xMax,
 				navView.zoom.yMin, navView.zoom.yMax);
-			ACAPI_WriteReport (msg, false);
 
 			if (navView.layerStats != nullptr) {
 				delete navView.layerStats;
@@ -1193,7 +1227,7 @@ static bool DoPlaceLinkedDrawingOnLayout (API_DatabaseUnId chosenLayoutId, const
 			navItem.guid = currentViewGuid;
 			navItem.mapId = API_PublicViewMap;
 			API_NavigatorView navView = {};
-			if (ACAPI_Navigator_GetNavigatorView (&navItem, &navView) == NoError) {
+			if (API_CALL (ACAPI_Navigator_GetNavigatorView, &navItem, &navView) == NoError) {
 				zoomBox = navView.zoom;
 				hasZoomBox = (navView.zoom.xMax > navView.zoom.xMin + 1e-6 && navView.zoom.yMax > navView.zoom.yMin + 1e-6);
 				// Читаем масштаб из навигатора вида, если он сохранён
@@ -1213,7 +1247,7 @@ static bool DoPlaceLinkedDrawingOnLayout (API_DatabaseUnId chosenLayoutId, const
 		navItem.guid = params.placeViewGuid;
 		navItem.mapId = API_PublicViewMap;
 		API_NavigatorView navView = {};
-		if (ACAPI_Navigator_GetNavigatorView (&navItem, &navView) == NoError) {
+		if (API_CALL (ACAPI_Navigator_GetNavigatorView, &navItem, &navView) == NoError) {
 			if (navView.saveDScale)
 				currentScale = static_cast<double> (navView.drawingScale);
 			viewScaleBeforeFit = currentScale;
@@ -1223,54 +1257,43 @@ static bool DoPlaceLinkedDrawingOnLayout (API_DatabaseUnId chosenLayoutId, const
 			}
 		}
 	}
-	double regionWmm = 0, regionHmm = 0;
-	double regionLeftMm = 0, regionBottomMm = 0;
+	PlacementMath::Rect region;
 	if (params.useGridRegion && params.gridRows > 0 && params.gridCols > 0) {
-		GetGridRegionRect (layoutInfo,
+		region = PlacementMath::GridRegionRect (sheet,
 			params.gridRows, params.gridCols, params.gridGapMm,
-			params.regionStartRow, params.regionStartCol, params.regionSpanRows, params.regionSpanCols,
-			regionLeftMm, regionBottomMm, regionWmm, regionHmm);
+			params.regionStartRow, params.regionStartCol, params.regionSpanRows, params.regionSpanCols);
 	}
+	const double regionWmm = region.width, regionHmm = region.height;
+	const double regionLeftMm = region.left, regionBottomMm = region.bottom;
 	const bool fitToRegion = params.useGridRegion && regionWmm > 1.0 && regionHmm > 1.0;
 	// Подгон: «Расположить» — по листу (fitScaleToLayout), «Организация» — по сектору (fitToRegion)
 	const bool wantFit = (params.fitScaleToLayout || fitToRegion) && hasZoomBox;
-	if (wantFit && (layoutInfo.sizeX < 1.0 || layoutInfo.sizeY < 1.0)) {
-		ACAPI_WriteReport ("ToLayout: подгон масштаба пропущен — размер макета неизвестен (sizeX/sizeY).", false);
+	if (wantFit && (sheet.sizeX < 1.0 || sheet.sizeY < 1.0)) {
+		LOG_WARN ("ToLayout: подгон масштаба пропущен — размер макета неизвестен (sizeX/sizeY).");
 	}
 	// При размещении в сектор — тот же принцип, что «Подогнать масштаб» в палитре «Расположить в макете»: подгонка по области (здесь область = сектор), размещение по точке (LB сектора, якорь LB).
 	if (wantFit) {
-		double extentW = zoomBox.xMax - zoomBox.xMin;
-		double extentH = zoomBox.yMax - zoomBox.yMin;
-		if (extentW > 1e-6 && extentH > 1e-6) {
-			double availWmm = layoutInfo.sizeX - layoutInfo.leftMargin - layoutInfo.rightMargin;
-			double availHmm = layoutInfo.sizeY - layoutInfo.topMargin - layoutInfo.bottomMargin;
-			if (fitToRegion) {
-				availWmm = regionWmm;
-				availHmm = regionHmm;
-			}
-			if (availWmm > 1.0 && availHmm > 1.0) {
-				double scaleW = extentW * 1000.0 / availWmm;
-				double scaleH = extentH * 1000.0 / availHmm;
-				// Масштаб определяется требованием, чтобы и по ширине, и по высоте вид поместился в область:
-				// размер = extent * 1000 / scale, поэтому нужен scale >= max(scaleW, scaleH).
-				double fitScale = (scaleW > scaleH) ? scaleW : scaleH;
-				if (fitScale < 1.0) fitScale = 1.0;
-				if (fitScale > 10000.0) fitScale = 10000.0;
-				currentScale = fitScale;
-
-				// Диагностика расчёта масштаба для размещения
-				char msg[512];
-				std::snprintf (msg, sizeof (msg),
-					"ToLayout scale: layout size=%.1f x %.1f mm, margins L=%.1f R=%.1f T=%.1f B=%.1f, avail=%.1f x %.1f mm, "
-					"extent=%.3f x %.3f model, scaleW=%.1f, scaleH=%.1f, chosenScale=%.1f (fitToRegion=%s)",
-					layoutInfo.sizeX, layoutInfo.sizeY,
-					layoutInfo.leftMargin, layoutInfo.rightMargin, layoutInfo.topMargin, layoutInfo.bottomMargin,
-					availWmm, availHmm,
-					extentW, extentH,
-					scaleW, scaleH, currentScale,
-					fitToRegion ? "true" : "false");
-				ACAPI_WriteReport (msg, false);
-			}
+		const double extentW = zoomBox.xMax - zoomBox.xMin;
+		const double extentH = zoomBox.yMax - zoomBox.yMin;
+		double availWmm = sheet.sizeX - sheet.leftMargin - sheet.rightMargin;
+		double availHmm = sheet.sizeY - sheet.topMargin - sheet.bottomMargin;
+		if (fitToRegion) {
+			availWmm = regionWmm;
+			availHmm = regionHmm;
+		}
+		PlacementMath::FitResult fit;
+		if (PlacementMath::FitScale (extentW, extentH, availWmm, availHmm, fit)) {
+			currentScale = fit.scale;
+
+			// Диагностика расчёта масштаба для размещения
+			LOG_DEBUG ("ToLayout scale: layout size=%.1f x %.1f mm, margins L=%.1f R=%.1f T=%.1f B=%.1f, avail=%.1f x %.1f mm, "
+				"extent=%.3f x %.3f model, scaleW=%.1f, scaleH=%.1f, chosenScale=%.1f (fitToRegion=%s)",
+				sheet.sizeX, sheet.sizeY,
+				sheet.leftMargin, sheet.rightMargin, sheet.topMargin, sheet.bottomMargin,
+				availWmm, availHmm,
+				extentW, extentH,
+				fit.scaleW, fit.scaleH, currentScale,
+				fitToRegion ? "true" : "false");
 		}
 	}
 	GS::UniString drawingName = params.drawingName.IsEmpty () ? GS::UniString ("Новый вид") : params.drawingName;
@@ -1283,7 +1306,7 @@ static bool DoPlaceLinkedDrawingOnLayout (API_DatabaseUnId chosenLayoutId, const
 			API_NavigatorItem navItem = {};
 			navItem.guid = params.placeViewGuid;
 			navItem.mapId = API_PublicViewMap;
-			if (ACAPI_Navigator_GetNavigatorItem (&params.placeViewGuid, &navItem) == NoError)
+			if (API_CALL (ACAPI_Navigator_GetNavigatorItem, &params.placeViewGuid, &navItem) == NoError)
 				drawingName = GS::UniString (navItem.uName);
 		}
 	} else {
@@ -1291,6 +1314,7 @@ static bool DoPlaceLinkedDrawingOnLayout (API_DatabaseUnId chosenLayoutId, const
 		GS::HashSet<API_AttributeIndex> selectedLayers;
 		if (!params.useMarqueeAsBoundary)
 			selectedLayers = GetLayersOfSelection ();
+		TRACE_SPAN ("clone view", "layout");
 		if (!selectedLayers.IsEmpty ()) {
 			viewGuidForDrawing = CloneViewToViewMapWithLayerFilter (
 				selectedLayers, static_cast<Int32> (currentScale), drawingName,
@@ -1317,7 +1341,7 @@ static bool DoPlaceLinkedDrawingOnLayout (API_DatabaseUnId chosenLayoutId, const
 		navItem.guid = viewGuidForDrawing;
 		navItem.mapId = API_PublicViewMap;
 		API_NavigatorView navView = {};
-		if (ACAPI_Navigator_GetNavigatorView (&navItem, &navView) == NoError) {
+		if (API_CALL (ACAPI_Navigator_GetNavigatorView, &navItem, &navView) == NoError) {
 			zoomBox = navView.zoom;
 			extentW = zoomBox.xMax - zoomBox.xMin;
 			extentH = zoomBox.yMax - zoomBox.yMin;
@@ -1333,17 +1357,12 @@ static bool DoPlaceLinkedDrawingOnLayout (API_DatabaseUnId chosenLayoutId, const
 	const double sizeH_m = sizeMmH * 0.001;
 
 	// Лог размеров чертежа на макете
-	{
-		char msg[512];
-		std::snprintf (msg, sizeof (msg),
-			"ToLayout drawing: extent=%.3f x %.3f model, scale=%.1f, frame=%.1f x %.1f mm (%.3f x %.3f m), placeByGuid=%s",
-			extentW, extentH,
-			currentScale,
-			sizeMmW, sizeMmH,
-			sizeW_m, sizeH_m,
-			placeByGuid ? "true" : "false");
-		ACAPI_WriteReport (msg, false);
-	}
+	LOG_DEBUG ("ToLayout drawing: extent=%.3f x %.3f model, scale=%.1f, frame=%.1f x %.1f mm (%.3f x %.3f m), placeByGuid=%s",
+		extentW, extentH,
+		currentScale,
+		sizeMmW, sizeMmH,
+		sizeW_m, sizeH_m,
+		placeByGuid ? "true" : "false");
 
 	API_AnchorID anchorId = APIAnc_LB;
 	API_Coord drawPos = { 0.0, 0.0 };
@@ -1354,51 +1373,25 @@ static bool DoPlaceLinkedDrawingOnLayout (API_DatabaseUnId chosenLayoutId, const
 		anchorId = APIAnc_LB;
 
 		// Лог параметров сетки и выбранного сектора
-		char msg[512];
-		std::snprintf (msg, sizeof (msg),
-			"ToLayout grid: rows=%d, cols=%d, gap=%.1f mm, region row=%d col=%d span=%d x %d, "
+		LOG_DEBUG ("ToLayout grid: rows=%d, cols=%d, gap=%.1f mm, region row=%d col=%d span=%d x %d, "
 			"regionRect=left=%.1f bottom=%.1f size=%.1f x %.1f mm, anchor=LB, pos=(%.3f, %.3f)m",
 			params.gridRows, params.gridCols, params.gridGapMm,
 			params.regionStartRow, params.regionStartCol, params.regionSpanRows, params.regionSpanCols,
 			regionLeftMm, regionBottomMm, regionWmm, regionHmm,
 			drawPos.x, drawPos.y);
-		ACAPI_WriteReport (msg, false);
 	} else {
-		GetDrawingPositionForAnchor (layoutInfo, params.anchorPosition, anchorId, drawPos);
-		switch (params.anchorPosition) {
-			case PlaceParams::Anchor::LeftTop:
-				drawPos.y -= sizeH_m;
-				anchorId = APIAnc_LB;
-				break;
-			case PlaceParams::Anchor::Middle:
-				drawPos.x -= sizeW_m * 0.5;
-				drawPos.y -= sizeH_m * 0.5;
-				anchorId = APIAnc_LB;
-				break;
-			case PlaceParams::Anchor::RightTop:
-				drawPos.x -= sizeW_m;
-				drawPos.y -= sizeH_m;
-				anchorId = APIAnc_LB;
-				break;
-			case PlaceParams::Anchor::RightBottom:
-				drawPos.x -= sizeW_m;
-				anchorId = APIAnc_LB;
-				break;
-			default:
-				break;
-		}
+		// Якорь на листе пересчитывается в левый нижний угол чертежа
+		const PlacementMath::Point origin = PlacementMath::DrawingOrigin (sheet, params.anchorPosition, sizeW_m, sizeH_m);
+		drawPos.x = origin.x;
+		drawPos.y = origin.y;
+		anchorId = APIAnc_LB;
 	}
 
 	// Общий лог финальной точки размещения и якоря (для обычного режима якорей по листу)
-	{
-		char msg[512];
-		std::snprintf (msg, sizeof (msg),
-			"ToLayout place: useGridRegion=%s, anchorId=%d, pos=(%.3f, %.3f)m",
-			(params.useGridRegion ? "true" : "false"),
-			static_cast<int> (anchorId),
-			drawPos.x, drawPos.y);
-		ACAPI_WriteReport (msg, false);
-	}
+	LOG_DEBUG ("ToLayout place: useGridRegion=%s, anchorId=%d, pos=(%.3f, %.3f)m",
+		(params.useGridRegion ? "true" : "false"),
+		static_cast<int> (anchorId),
+		drawPos.x, drawPos.y);
 	if (layoutInfo.customData != nullptr) {
 		delete layoutInfo.customData;
 		layoutInfo.customData = nullptr;
@@ -1407,7 +1400,7 @@ static bool DoPlaceLinkedDrawingOnLayout (API_DatabaseUnId chosenLayoutId, const
 	// Система координат макета: начало в левом нижнем углу листа, pos в метрах
 	API_Element element = {};
 	element.header.type = API_DrawingID;
-	GSErrCode err = ACAPI_Element_GetDefaults (&element, nullptr);
+	GSErrCode err = API_CALL (ACAPI_Element_GetDefaults, &element, nullptr);
 	if (err != NoError)
 		return false;
 	
@@ -1426,28 +1419,24 @@ static bool DoPlaceLinkedDrawingOnLayout (API_DatabaseUnId chosenLayoutId, const
 	element.drawing.isCutWithFrame = false;
 
 	// Лог параметров размещения Drawing
-	{
-		char msg[512];
-		std::snprintf (msg, sizeof (msg),
-			"ToLayout Drawing params: viewScale=%.1f, targetScale=%.1f, ratio=%.4f",
-			viewScaleBeforeFit, currentScale, ratio);
-		ACAPI_WriteReport (msg, false);
-	}
+	LOG_DEBUG ("ToLayout Drawing params: viewScale=%.1f, targetScale=%.1f, ratio=%.4f",
+		viewScaleBeforeFit, currentScale, ratio);
 
 	err = ACAPI_CallUndoableCommand ("Place view on layout", [&] () -> GSErrCode {
+		TRACE_SPAN ("undo: Place view on layout", "undo");
 		API_DatabaseInfo layoutDb = {};
 		layoutDb.databaseUnId = chosenLayoutId;
 		layoutDb.typeID = APIWind_LayoutID;
-		GSErrCode e = ACAPI_Database_ChangeCurrentDatabase (&layoutDb);
+		GSErrCode e = API_CALL (ACAPI_Database_ChangeCurrentDatabase, &layoutDb);
 		if (e != NoError)
 			return e;
 		API_ElementMemo memo = {};
-		GSErrCode createErr = ACAPI_Element_Create (&element, &memo);
+		GSErrCode createErr = API_CALL (ACAPI_Element_Create, &element, &memo);
 		if (createErr != NoError) {
-			ACAPI_Database_ChangeCurrentDatabase (&currentDb);
+			API_CALL (ACAPI_Database_ChangeCurrentDatabase, &currentDb);
 			return createErr;
 		}
-		ACAPI_Database_ChangeCurrentDatabase (&currentDb);
+		API_CALL (ACAPI_Database_ChangeCurrentDatabase, &currentDb);
 		return createErr;
 	});
 
@@ -1464,6 +1453,8 @@ static bool DoPlaceLinkedDrawingOnLayout (API_DatabaseUnId chosenLayoutId, const
 // -----------------------------------------------------------------------------
 bool PlaceSelectionOnLayoutWithParams (const PlaceParams& params)
 {
+	API_OPERATION ("placement");
+	TRACE_SPAN ("PlaceSelectionOnLayout", "layout");
 	API_DatabaseUnId targetLayoutId = {};
 
 	if (params.masterLayoutIndex >= 0) {
@@ -1477,13 +1468,13 @@ bool PlaceSelectionOnLayoutWithParams (const PlaceParams& params)
 		GS::Array<API_DatabaseUnId> layoutIdsBefore;
 		{
 			GS::Array<API_DatabaseUnId> dbIds;
-			if (ACAPI_Database_GetLayoutDatabases (nullptr, &dbIds) == NoError)
+			if (API_CALL (ACAPI_Database_GetLayoutDatabases, nullptr, &dbIds) == NoError)
 				layoutIdsBefore = dbIds;
 		}
 		API_LayoutInfo layoutInfo = {};
 		BNZeroMemory (&layoutInfo, sizeof (layoutInfo));
 		API_DatabaseUnId masterId = masters[params.masterLayoutIndex].databaseUnId;
-		if (ACAPI_Navigator_GetLayoutSets (&layoutInfo, &masterId) != NoError) {
+		if (API_CALL (ACAPI_Navigator_GetLayoutSets, &layoutInfo, &masterId) != NoError) {
 			ACAPI_WriteReport ("LayoutHelper: GetLayoutSets (master) failed", true);
 			return false;
 		}
@@ -1499,14 +1490,15 @@ bool PlaceSelectionOnLayoutWithParams (const PlaceParams& params)
 			layoutInfo.customData = nullptr;
 		}
 
-		GSErrCode crErr = ACAPI_Navigator_CreateLayout (&layoutInfo, &masterId, nullptr);
+		GSErrCode crErr = API_CALL (ACAPI_Navigator_CreateLayout, &layoutInfo, &masterId, nullptr);
+		InvalidateLayoutCache ();
 		if (crErr != NoError) {
 			ACAPI_WriteReport ("LayoutHelper: CreateLayout failed", true);
 			return false;
 		}
 		// Ищем созданный макет: тот, которого не было в списке до создания
 		GS::Array<API_DatabaseUnId> layoutIdsAfter;
-		if (ACAPI_Database_GetLayoutDatabases (nullptr, &layoutIdsAfter) != NoError) {
+		if (API_CALL (ACAPI_Database_GetLayoutDatabases, nullptr, &layoutIdsAfter) != NoError) {
 			ACAPI_WriteReport ("LayoutHelper: не удалось получить список макетов", true);
 			return false;
 		}
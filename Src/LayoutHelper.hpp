@@ -4,6 +4,7 @@
 #include "APIEnvir.h"
 #include "ACAPinc.h"
 #include "GSRoot.hpp"
+#include "PlacementMath.hpp"
 
 namespace LayoutHelper {
 
@@ -29,6 +30,15 @@ namespace LayoutHelper {
 	/** Список папок макетов (уникальные папки из имен макетов) */
 	GS::Array<LayoutFolderItem> GetLayoutFolders ();
 
+	/** Группа макетов для дерева палитры: папка (часть имени до '/') и индексы в списке макетов */
+	struct LayoutGroup {
+		GS::UniString groupName;  // "Без папки" для макетов без '/'
+		GS::Array<UIndex> layoutIndices;
+	};
+
+	/** Макеты, сгруппированные по папкам; группы — в порядке первого появления */
+	GS::Array<LayoutGroup> GetLayoutGroups (const GS::Array<LayoutItem>& layouts);
+
 	/** Список мастер-макетов (шаблоны: Титульный лист, Обложка) */
 	GS::Array<MasterLayoutItem> GetMasterLayoutList ();
 
@@ -43,19 +53,27 @@ namespace LayoutHelper {
 	/** Список видов из View Map, которые можно разместить на макете (планы, разрезы, фасады, детали, Документы из 3D) */
 	GS::Array<PlaceableViewItem> GetPlaceableViews ();
 
+	/**
+	 * Кеш на время одного запроса (ACAPI.Batch): пока жив хотя бы один объект,
+	 * списки макетов, шаблонов и видов читаются из проекта один раз.
+	 * Вложенные области разделяют кеш; создание макета сбрасывает его.
+	 */
+	class RequestCacheScope {
+	public:
+		RequestCacheScope ();
+		~RequestCacheScope ();
+
+		RequestCacheScope (const RequestCacheScope&) = delete;
+		RequestCacheScope& operator= (const RequestCacheScope&) = delete;
+	};
+
 	/** Текущий масштаб вида (100 = 1:100). Возвращает 100 при ошибке. */
 	double GetCurrentDrawingScale ();
 
 	/** Параметры размещения из палитры */
 	struct PlaceParams {
-		/** Точка привязки вида на макете: углы + центр */
-		enum class Anchor {
-			LeftBottom = 0,  // LB
-			LeftTop,         // LT
-			RightTop,        // RT
-			RightBottom,     // RB
-			Middle           // MM (центр)
-		};
+		/** Точка привязки вида на макете: углы + центр (Src/Core/PlacementMath) */
+		using Anchor = PlacementMath::Anchor;
 		Int32 masterLayoutIndex;    // индекс шаблона (0-based), -1 = использовать существующий layoutIndex
 		Int32 layoutIndex;          // индекс существующего макета (если masterLayoutIndex < 0)
 		GS::UniString layoutName;   // имя для нового макета
@@ -1,5 +1,6 @@
 #include "LicenseManager.hpp"
 #include "APICommon.h"
+#include "Logger.hpp"
 
 #ifdef GS_WIN
 #include <Windows.h>
@@ -481,45 +482,21 @@ void LicenseManager::WriteLicenseLog(LicenseStatus status, const LicenseData& li
 }
 
 // =============================================================================
-// Записать общий лог в файл (для отладки)
+// Записать общий лог (для отладки): через журнал дополнения, без открытия файла на сообщение
 // =============================================================================
 
 void LicenseManager::WriteLog(const GS::UniString& message)
 {
-	// Логи пишем в AppData\Local\LandscapeHelper
-	GS::UniString userDataDir = GetUserDataDirectory();
-	if (userDataDir.IsEmpty()) {
-		return;
-	}
-	
-	GS::UniString logPath = userDataDir;
-	logPath += "\\license.log";
-
-	// Открываем файл для добавления (append mode)
-#ifdef GS_WIN
-	FILE* fp = _wfopen(logPath.ToUStr().Get(), L"a");
-#else
-	FILE* fp = fopen(logPath.ToCStr().Get(), "a");
-#endif
-	
-	if (fp == nullptr) {
-		return;
-	}
-
-	GS::UniString currentDate = GetCurrentDate();
-	GS::UniString logLine = GS::UniString("[") + currentDate + GS::UniString("] ") + message + GS::UniString("\n");
+	LOG_INFO("[License] %s", message.ToCStr(CC_UTF8).Get());
+}
 
-	// Конвертируем UniString в UTF-8 для записи
-#ifdef GS_WIN
-	// На Windows используем UTF-16 напрямую
-	fputws(logLine.ToUStr().Get(), fp);
-#else
-	// На других платформах конвертируем в UTF-8
-	GS::UniString utf8Line = logLine;
-	fputs(utf8Line.ToCStr().Get(), fp);
-#endif
+// =============================================================================
+// Каталог логов (для диагностических файлов рядом с license.log)
+// =============================================================================
 
-	fclose(fp);
+GS::UniString LicenseManager::GetLogDirectory()
+{
+	return GetUserDataDirectory();
 }
 
 // =============================================================================
@@ -50,9 +50,12 @@ public:
 	// Записать лог проверки лицензии
 	static void WriteLicenseLog(LicenseStatus status, const LicenseData& licenseData);
 	
-	// Записать общий лог в файл (для отладки)
+	// Записать общий лог (для отладки) — в tolayout.log через Logger
 	static void WriteLog(const GS::UniString& message);
 
+	// Каталог логов (там же license.log); пустая строка, если недоступен
+	static GS::UniString GetLogDirectory();
+
 	// Демо-режим: проверить, активен ли демо-период (22 дня или 22 запуска)
 	// Возвращает true если демо активен, false если истек
 	static bool CheckDemoPeriod(DemoData& demoData);
@@ -0,0 +1,350 @@
+#include "Logger.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdarg>
+#include <cstdio>
+#include <cstring>
+#include <ctime>
+#include <memory>
+#include <mutex>
+#include <thread>
+
+namespace Logger {
+
+// ---------------- Кольцевой буфер: много писателей, один читатель ----------------
+// Каждая ячейка хранит номер очереди: pos — свободна для записи с позиции pos,
+// pos + 1 — заполнена и ждёт фонового писателя. Писатели занимают позицию одним CAS,
+// читатель освобождает ячейку для следующего круга (pos + BufferCapacity).
+struct Slot {
+    std::atomic<UInt64> sequence;
+    Level               level;
+    UInt64              timeUs;     // системное время, микросекунды от эпохи
+    char                text[MessageCapacity];
+};
+
+struct Ring {
+    std::unique_ptr<Slot[]> slots;
+    std::atomic<UInt64>     head { 0 };     // следующая позиция для записи
+    std::atomic<UInt64>     tail { 0 };     // следующая позиция для чтения (меняет только писатель файла)
+    std::atomic<UInt64>     dropped { 0 };
+
+    Ring () : slots (new Slot[BufferCapacity])
+    {
+        for (UInt32 i = 0; i < BufferCapacity; ++i)
+            slots[i].sequence.store (i, std::memory_order_relaxed);
+    }
+};
+
+static Ring& GetRing ()
+{
+    static Ring ring;
+    return ring;
+}
+
+// ---------------- Фоновый писатель ----------------
+static std::mutex               s_mutex;
+static std::condition_variable  s_wake;
+static std::condition_variable  s_drained;
+static std::thread              s_thread;
+static bool                     s_running = false;
+static bool                     s_stopping = false;
+static GS::UniString            s_directory;
+
+static const std::chrono::milliseconds WriterPeriod (250);
+
+static GS::UniString LogPath (UInt32 rotation)
+{
+    if (rotation == 0)
+        return s_directory + "\\tolayout.log";
+    return s_directory + GS::UniString::Printf ("\\tolayout.%u.log", static_cast<unsigned> (rotation));
+}
+
+static std::FILE* OpenForAppend (const GS::UniString& path)
+{
+#ifdef GS_WIN
+    return _wfopen (path.ToUStr ().Get (), L"ab");
+#else
+    return std::fopen (path.ToCStr (CC_UTF8).Get (), "ab");
+#endif
+}
+
+static void RemoveFile (const GS::UniString& path)
+{
+#ifdef GS_WIN
+    _wremove (path.ToUStr ().Get ());
+#else
+    std::remove (path.ToCStr (CC_UTF8).Get ());
+#endif
+}
+
+static void RenameFile (const GS::UniString& from, const GS::UniString& to)
+{
+#ifdef GS_WIN
+    _wrename (from.ToUStr ().Get (), to.ToUStr ().Get ());
+#else
+    std::rename (from.ToCStr (CC_UTF8).Get (), to.ToCStr (CC_UTF8).Get ());
+#endif
+}
+
+// Состояние файла — только в потоке писателя
+struct LogFile {
+    std::FILE*  file = nullptr;
+    UInt64      size = 0;
+
+    void Open ()
+    {
+        if (s_directory.IsEmpty ())
+            return;
+        file = OpenForAppend (LogPath (0));
+        if (file != nullptr) {
+            std::fseek (file, 0, SEEK_END);
+            const long position = std::ftell (file);
+            size = position > 0 ? static_cast<UInt64> (position) : 0;
+        }
+    }
+
+    void Close ()
+    {
+        if (file != nullptr)
+            std::fclose (file);
+        file = nullptr;
+        size = 0;
+    }
+
+    // tolayout.log -> tolayout.1.log -> ... -> tolayout.N.log (самый старый удаляется)
+    void Rotate ()
+    {
+        Close ();
+        RemoveFile (LogPath (RotatedFiles));
+        for (UInt32 i = RotatedFiles; i > 1; --i)
+            RenameFile (LogPath (i - 1), LogPath (i));
+        RenameFile (LogPath (0), LogPath (1));
+        Open ();
+    }
+
+    void Append (const char* line, std::size_t length)
+    {
+        if (file == nullptr)
+            return;
+        if (size + length > MaxFileBytes && size > 0) {
+            Rotate ();
+            if (file == nullptr)
+                return;
+        }
+        std::fwrite (line, 1, length, file);
+        size += length;
+    }
+};
+
+static const char* LevelName (Level level)
+{
+    switch (level) {
+        case Level::Trace: return "TRACE";
+        case Level::Debug: return "DEBUG";
+        case Level::Info:  return "INFO ";
+        case Level::Warn:  return "WARN ";
+        case Level::Error: return "ERROR";
+        default:           return "?    ";
+    }
+}
+
+static std::size_t FormatTime (UInt64 timeUs, char* buffer, std::size_t capacity)
+{
+    const std::time_t seconds = static_cast<std::time_t> (timeUs / 1000000);
+    std::tm local = {};
+#ifdef GS_WIN
+    localtime_s (&local, &seconds);
+#else
+    localtime_r (&seconds, &local);
+#endif
+    const std::size_t length = std::strftime (buffer, capacity, "%Y-%m-%d %H:%M:%S", &local);
+    const int written = std::snprintf (buffer + length, capacity - length, ".%03u", static_cast<unsigned> ((timeUs / 1000) % 1000));
+    return length + (written > 0 ? static_cast<std::size_t> (written) : 0);
+}
+
+// Выбрать из буфера всё заполненное подряд и дописать в файл
+static void Drain (LogFile& logFile, UInt64& reportedDropped)
+{
+    Ring& ring = GetRing ();
+    UInt64 tail = ring.tail.load (std::memory_order_relaxed);
+    char line[MessageCapacity + 64];
+
+    for (;;) {
+        Slot& slot = ring.slots[static_cast<std::size_t> (tail % BufferCapacity)];
+        if (slot.sequence.load (std::memory_order_acquire) != tail + 1)
+            break;
+        std::size_t length = FormatTime (slot.timeUs, line, sizeof (line));
+        const int written = std::snprintf (line + length, sizeof (line) - length, " %s %s\n", LevelName (slot.level), slot.text);
+        if (written > 0)
+            length += std::min (static_cast<std::size_t> (written), sizeof (line) - length - 1);
+        logFile.Append (line, length);
+        slot.sequence.store (tail + BufferCapacity, std::memory_order_release);
+        ++tail;
+        ring.tail.store (tail, std::memory_order_release);
+    }
+
+    const UInt64 dropped = ring.dropped.load (std::memory_order_relaxed);
+    if (dropped != reportedDropped) {
+        const int written = std::snprintf (line, sizeof (line), "[Logger] буфер переполнен, отброшено сообщений: %llu\n",
+            static_cast<unsigned long long> (dropped - reportedDropped));
+        if (written > 0)
+            logFile.Append (line, static_cast<std::size_t> (written));
+        reportedDropped = dropped;
+    }
+
+    if (logFile.file != nullptr)
+        std::fflush (logFile.file);
+}
+
+static void WriterLoop ()
+{
+    LogFile logFile;
+    logFile.Open ();
+    UInt64 reportedDropped = GetRing ().dropped.load (std::memory_order_relaxed);
+
+    std::unique_lock<std::mutex> lock (s_mutex);
+    while (!s_stopping) {
+        s_wake.wait_for (lock, WriterPeriod);
+        lock.unlock ();
+        Drain (logFile, reportedDropped);
+        lock.lock ();
+        s_drained.notify_all ();
+    }
+    lock.unlock ();
+
+    Drain (logFile, reportedDropped);
+    logFile.Close ();
+}
+
+void Start (const GS::UniString& directory)
+{
+    std::lock_guard<std::mutex> lock (s_mutex);
+    if (s_running)
+        return;
+    s_directory = directory;
+    s_stopping = false;
+    s_running = true;
+    s_thread = std::thread (WriterLoop);
+}
+
+void Stop ()
+{
+    {
+        std::lock_guard<std::mutex> lock (s_mutex);
+        if (!s_running)
+            return;
+        s_stopping = true;
+    }
+    s_wake.notify_one ();
+    s_thread.join ();
+
+    std::lock_guard<std::mutex> lock (s_mutex);
+    s_running = false;
+    s_drained.notify_all ();
+}
+
+void Flush ()
+{
+    Ring& ring = GetRing ();
+    const UInt64 target = ring.head.load (std::memory_order_acquire);
+    std::unique_lock<std::mutex> lock (s_mutex);
+    if (!s_running)
+        return;
+    s_wake.notify_one ();
+    s_drained.wait (lock, [&] () {
+        return !s_running || s_stopping || ring.tail.load (std::memory_order_acquire) >= target;
+    });
+}
+
+// ---------------- Запись сообщения ----------------
+void Write (Level level, const char* format, ...)
+{
+    Ring& ring = GetRing ();
+    UInt64 position = ring.head.load (std::memory_order_relaxed);
+    Slot* slot = nullptr;
+    for (;;) {
+        slot = &ring.slots[static_cast<std::size_t> (position % BufferCapacity)];
+        const UInt64 sequence = slot->sequence.load (std::memory_order_acquire);
+        const Int64 diff = static_cast<Int64> (sequence - position);
+        if (diff == 0) {
+            if (ring.head.compare_exchange_weak (position, position + 1, std::memory_order_relaxed))
+                break;
+        } else if (diff < 0) {
+            // Писатель файла отстал на целый круг — не ждём его на вызывающем потоке
+            ring.dropped.fetch_add (1, std::memory_order_relaxed);
+            return;
+        } else {
+            position = ring.head.load (std::memory_order_relaxed);
+        }
+    }
+
+    slot->level = level;
+    slot->timeUs = static_cast<UInt64> (std::chrono::duration_cast<std::chrono::microseconds> (
+        std::chrono::system_clock::now ().time_since_epoch ()).count ());
+
+    va_list args;
+    va_start (args, format);
+    const int written = std::vsnprintf (slot->text, MessageCapacity, format, args);
+    va_end (args);
+
+    // Обрезанное сообщение не должно заканчиваться половиной символа UTF-8
+    if (written >= static_cast<int> (MessageCapacity)) {
+        // text[MessageCapacity - 1] — терминатор vsnprintf; ищем начало последнего символа
+        const std::size_t length = MessageCapacity - 1;
+        std::size_t lead = length - 1;
+        while (lead > 0 && (static_cast<unsigned char> (slot->text[lead]) & 0xC0) == 0x80)
+            --lead;
+        const unsigned char leadByte = static_cast<unsigned char> (slot->text[lead]);
+        const std::size_t sequence = (leadByte < 0x80) ? 1 : (leadByte >= 0xF0) ? 4 : (leadByte >= 0xE0) ? 3 : 2;
+        if (lead + sequence > length)
+            slot->text[lead] = '\0';
+    } else if (written < 0) {
+        slot->text[0] = '\0';
+    }
+
+    slot->sequence.store (position + 1, std::memory_order_release);
+
+    // Писатель спит WriterPeriod; при всплеске сообщений будим его раньше, чем буфер заполнится
+    if (level >= Level::Warn || (position + 1) % (BufferCapacity / 4) == 0)
+        s_wake.notify_one ();
+}
+
+UInt64 GetDroppedCount ()
+{
+    return GetRing ().dropped.load (std::memory_order_relaxed);
+}
+
+// ---------------- Сводка операции ----------------
+static UInt64 SteadyNowUs ()
+{
+    return static_cast<UInt64> (std::chrono::duration_cast<std::chrono::microseconds> (
+        std::chrono::steady_clock::now ().time_since_epoch ()).count ());
+}
+
+OperationSummary::OperationSummary (const char* operation) :
+    operation (operation),
+    startUs (SteadyNowUs ())
+{
+}
+
+OperationSummary::~OperationSummary ()
+{
+    const double elapsedMs = (SteadyNowUs () - startUs) / 1000.0;
+    LOG_INFO ("[%s] успешно: %u, ошибок: %u, %.1f мс", operation,
+        static_cast<unsigned> (succeeded), static_cast<unsigned> (failed), elapsedMs);
+
+#ifdef DEBUG_UI_LOGS
+    const bool toReport = true;
+#else
+    const bool toReport = (failed > 0);
+#endif
+    if (toReport) {
+        ACAPI_WriteReport ("%s: обработано %u, ошибок %u (подробности в tolayout.log)", failed > 0, operation,
+            static_cast<unsigned> (succeeded + failed), static_cast<unsigned> (failed));
+    }
+}
+
+} // namespace Logger
@@ -0,0 +1,111 @@
+#ifndef LOGGER_HPP
+#define LOGGER_HPP
+
+#include "APIEnvir.h"
+#include "ACAPinc.h"
+#include "GSRoot.hpp"
+
+// Журнал дополнения: уровни, отсекаемые при компиляции, кольцевой буфер без блокировок
+// и фоновая запись в tolayout.log с ротацией. Вызов LOG_* на горячем пути — форматирование
+// в ячейку буфера, без файловых операций и без окна отчёта.
+//
+//   LOG_DEBUG ("[LayerHelper] Перемещаем %d элементов", count);
+//
+// Окно отчёта Archicad получает не строку на элемент, а одну сводку на операцию (OperationSummary).
+//
+// Порог уровней: TOLAYOUT_LOG_MIN_LEVEL (0 — Trace ... 4 — Error). По умолчанию в отладочной
+// сборке пишется всё начиная с Debug, в рабочей — с Info; вызовы ниже порога вместе с
+// вычислением аргументов исчезают из кода.
+
+#define TOLAYOUT_LOG_LEVEL_TRACE 0
+#define TOLAYOUT_LOG_LEVEL_DEBUG 1
+#define TOLAYOUT_LOG_LEVEL_INFO  2
+#define TOLAYOUT_LOG_LEVEL_WARN  3
+#define TOLAYOUT_LOG_LEVEL_ERROR 4
+
+#ifndef TOLAYOUT_LOG_MIN_LEVEL
+#if defined (DEBUG) || defined (DEBUG_UI_LOGS)
+#define TOLAYOUT_LOG_MIN_LEVEL TOLAYOUT_LOG_LEVEL_DEBUG
+#else
+#define TOLAYOUT_LOG_MIN_LEVEL TOLAYOUT_LOG_LEVEL_INFO
+#endif
+#endif
+
+namespace Logger {
+
+    enum class Level : UInt32 {
+        Trace = TOLAYOUT_LOG_LEVEL_TRACE,
+        Debug = TOLAYOUT_LOG_LEVEL_DEBUG,
+        Info  = TOLAYOUT_LOG_LEVEL_INFO,
+        Warn  = TOLAYOUT_LOG_LEVEL_WARN,
+        Error = TOLAYOUT_LOG_LEVEL_ERROR
+    };
+
+    const UInt32 BufferCapacity = 1 << 12;      // сообщений в очереди; при переполнении новые отбрасываются и считаются
+    const UInt32 MessageCapacity = 384;         // байт UTF-8 на сообщение, длиннее — обрезается
+    const UInt64 MaxFileBytes = 4 << 20;        // размер tolayout.log, после которого он уходит в tolayout.1.log
+    const UInt32 RotatedFiles = 3;              // tolayout.1.log ... tolayout.3.log
+
+    // Запуск фонового писателя: файл directory\tolayout.log. Сообщения до запуска ждут в буфере.
+    void Start (const GS::UniString& directory);
+    // Дописать буфер и остановить писатель (FreeData)
+    void Stop ();
+    // Разбудить писатель и дождаться, пока он запишет всё, что было в буфере на момент вызова
+    void Flush ();
+
+    // Записать сообщение (формат printf, строки UTF-8). Обычно вызывается через LOG_*.
+    void Write (Level level, const char* format, ...);
+
+    // Сколько сообщений отброшено из-за переполнения буфера с момента запуска
+    UInt64 GetDroppedCount ();
+
+    // Сводка операции над множеством элементов: счёт успехов и ошибок вместо строки на элемент.
+    // В деструкторе — одна строка Info в журнал; в окно отчёта — только если были ошибки
+    // (или всегда, при DEBUG_UI_LOGS).
+    class OperationSummary {
+    public:
+        explicit OperationSummary (const char* operation);
+        ~OperationSummary ();
+
+        void Succeeded ()   { ++succeeded; }
+        void Failed ()      { ++failed; }
+
+        OperationSummary (const OperationSummary&) = delete;
+        OperationSummary& operator= (const OperationSummary&) = delete;
+
+    private:
+        const char* operation;
+        UInt32      succeeded = 0;
+        UInt32      failed = 0;
+        UInt64      startUs;
+    };
+
+} // namespace Logger
+
+#if TOLAYOUT_LOG_MIN_LEVEL <= TOLAYOUT_LOG_LEVEL_TRACE
+#define LOG_TRACE(...) Logger::Write (Logger::Level::Trace, __VA_ARGS__)
+#else
+#define LOG_TRACE(...) ((void) 0)
+#endif
+
+#if TOLAYOUT_LOG_MIN_LEVEL <= TOLAYOUT_LOG_LEVEL_DEBUG
+#define LOG_DEBUG(...) Logger::Write (Logger::Level::Debug, __VA_ARGS__)
+#else
+#define LOG_DEBUG(...) ((void) 0)
+#endif
+
+#if TOLAYOUT_LOG_MIN_LEVEL <= TOLAYOUT_LOG_LEVEL_INFO
+#define LOG_INFO(...) Logger::Write (Logger::Level::Info, __VA_ARGS__)
+#else
+#define LOG_INFO(...) ((void) 0)
+#endif
+
+#if TOLAYOUT_LOG_MIN_LEVEL <= TOLAYOUT_LOG_LEVEL_WARN
+#define LOG_WARN(...) Logger::Write (Logger::Level::Warn, __VA_ARGS__)
+#else
+#define LOG_WARN(...) ((void) 0)
+#endif
+
+#define LOG_ERROR(...) Logger::Write (Logger::Level::Error, __VA_ARGS__)
+
+#endif // LOGGER_HPP
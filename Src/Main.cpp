@@ -19,6 +19,13 @@
 #include    "ToLayoutPalette.hpp"
 #include    "OrganizeLayoutsPalette.hpp"
 #include    "LicenseManager.hpp"
+#include    "BridgeStats.hpp"
+#include    "ApiProfiler.hpp"
+#include    "TraceLog.hpp"
+#include    "Logger.hpp"
+#include    "MetricsCache.hpp"
+#include    "GrossMetricsJob.hpp"
+#include    "SeoLossReport.hpp"
 #include	"APICommon.h"
 
 // -----------------------------------------------------------------------------
@@ -51,6 +58,62 @@ static void	ShowOrHideBrowserRepl ()
 	}
 }
 
+// -----------------------------------------------------------------------------
+// Dump bridge call statistics (bridge_stats.json next to license.log)
+// -----------------------------------------------------------------------------
+
+static void DumpBridgeStats ()
+{
+	if (!BridgeStats::IsEnabled ()) {
+		BridgeStats::SetEnabled (true);
+		ACAPI_WriteReport ("Сбор статистики JS-моста включён. Повторите команду, чтобы сохранить отчёт.", true);
+		return;
+	}
+
+	const GS::UniString logDir = LicenseManager::GetLogDirectory ();
+	if (logDir.IsEmpty ()) {
+		ACAPI_WriteReport ("Статистика JS-моста: каталог логов недоступен.", true);
+		return;
+	}
+
+	GS::UniString filePath = logDir;
+	filePath += "\\bridge_stats.json";
+	if (BridgeStats::WriteJson (filePath)) {
+		ACAPI_WriteReport ("Статистика JS-моста сохранена: ", false);
+		ACAPI_WriteReport (filePath.ToCStr ().Get (), false);
+	} else {
+		ACAPI_WriteReport ("Не удалось сохранить статистику JS-моста.", true);
+	}
+}
+
+// -----------------------------------------------------------------------------
+// Export trace spans (tolayout_trace.json, open in ui.perfetto.dev)
+// -----------------------------------------------------------------------------
+
+static void ExportTrace ()
+{
+	if (!TraceLog::IsEnabled ()) {
+		TraceLog::SetEnabled (true);
+		ACAPI_WriteReport ("Трассировка включена. Выполните операции и повторите команду, чтобы сохранить файл.", true);
+		return;
+	}
+
+	const GS::UniString logDir = LicenseManager::GetLogDirectory ();
+	if (logDir.IsEmpty ()) {
+		ACAPI_WriteReport ("Трассировка: каталог логов недоступен.", true);
+		return;
+	}
+
+	GS::UniString filePath = logDir;
+	filePath += "\\tolayout_trace.json";
+	if (TraceLog::WriteChromeTrace (filePath)) {
+		ACAPI_WriteReport ("Трасса сохранена (%u событий): ", false, static_cast<unsigned> (TraceLog::GetEventCount ()));
+		ACAPI_WriteReport (filePath.ToCStr ().Get (), false);
+	} else {
+		ACAPI_WriteReport ("Не удалось сохранить трассу.", true);
+	}
+}
+
 // -----------------------------------------------------------------------------
 // MenuCommandHandler
 //		called to perform the user-asked command
@@ -112,6 +175,18 @@ GSErrCode MenuCommandHandler (const API_MenuParams *menuParams)
 #endif
 					ShowOrHideBrowserRepl();
 					break;
+				case 5:  // "Статистика JS-моста" — первый вызов включает сбор, следующие пишут JSON рядом с license.log
+					DumpBridgeStats();
+					break;
+				case 6:  // "Профиль вызовов API" — рейтинг в окно отчёта сессии
+					ApiProfiler::PrintReport();
+					break;
+				case 7:  // "Трассировка (Chrome trace)" — первый вызов включает запись, следующие выгружают JSON
+					ExportTrace ();
+					break;
+				case 8:  // "Отчёт о потерях SEO (CSV)" — все перекрытия, крыши, оболочки, 3D-сетки и морфы проекта
+					SeoLossReport::RunFromMenu ();
+					break;
 				default:
 #ifdef DEBUG_UI_LOGS
 					ACAPI_WriteReport("[Main] Unknown menu item index: %d", false, (int)menuParams->menuItemRef.itemIndex);
@@ -159,6 +234,11 @@ GSErrCode	RegisterInterface (void)
 	if (DBERROR (err != NoError))
 		return err;
 
+	// Порции отложенного расчёта gross-метрик выполняются как команда дополнения из цикла событий
+	err = GrossMetricsJob::RegisterService ();
+	if (DBERROR (err != NoError))
+		return err;
+
 	return err;
 }		// RegisterInterface
 
@@ -170,6 +250,12 @@ GSErrCode	RegisterInterface (void)
 
 GSErrCode Initialize ()
 {
+    // Журнал пишется фоновым потоком в tolayout.log рядом с license.log
+    Logger::Start (LicenseManager::GetLogDirectory ());
+    // SEO-метрики, посчитанные в прошлых сессиях
+    if (!LicenseManager::GetLogDirectory ().IsEmpty ())
+        MetricsCache::EnablePersistence (LicenseManager::GetLogDirectory () + "\\metrics_cache.bin");
+
     // 0) Проверка лицензии
     LicenseManager::LicenseData licenseData;
     LicenseManager::LicenseStatus licenseStatus = LicenseManager::CheckLicense(licenseData);
@@ -215,6 +301,10 @@ GSErrCode Initialize ()
     if (DBERROR (err != NoError))
         return err;
 
+    err = GrossMetricsJob::InstallHandler ();
+    if (DBERROR (err != NoError))
+        return err;
+
     // 2) Нотификация выбора - регистрируется внутри SelectionDetailsPalette при создании
     // (не нужно регистрировать здесь, так как SelectionDetailsPalette сам подписывается)
 
@@ -241,5 +331,6 @@ GSErrCode Initialize ()
 
 GSErrCode	FreeData (void)
 {
+	Logger::Stop ();
 	return NoError;
 }		// FreeData
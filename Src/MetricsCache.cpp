@@ -0,0 +1,386 @@
+#include "MetricsCache.hpp"
+#include "ApiProfiler.hpp"
+#include "Logger.hpp"
+#include "HashTable.hpp"
+#include "uchar_t.hpp"
+
+#include <cstdio>
+#include <cstring>
+#include <iterator>
+#include <list>
+#include <string>
+
+#include <sys/stat.h>
+#include <sys/types.h>
+
+namespace MetricsCache {
+
+// ---------------- Записи и порядок LRU ----------------
+// Голова списка — самая свежая запись, хвост — первая на вытеснение
+struct Entry {
+    API_Guid            guid = APINULLGuid;
+    Fingerprint         fingerprint;
+    GS::Array<Metric>   metrics;
+    UInt64              bytes = 0;
+};
+
+typedef std::list<Entry> EntryList;
+
+static EntryList                                        s_entries;
+static GS::HashTable<GS::Guid, EntryList::iterator>     s_index;
+static UInt64                                           s_usedBytes = 0;
+static UInt64                                           s_budgetBytes = DefaultBudgetBytes;
+static GS::UniString                                    s_filePath;
+static GS::UniString                                    s_projectKey;       // путь и время изменения файла проекта
+static UInt64                                           s_projectId = 0;    // хеш s_projectKey; 0 — не сохраняется
+
+// Приблизительный объём записи: структура, строки метрик и узлы таблиц
+static UInt64 EstimateBytes (const GS::Array<Metric>& metrics)
+{
+    UInt64 bytes = sizeof (Entry) + 64;
+    for (const Metric& metric : metrics)
+        bytes += sizeof (Metric) + (metric.key.GetLength () + metric.name.GetLength ()) * sizeof (GS::uchar_t);
+    return bytes;
+}
+
+static void Remove (EntryList::iterator it)
+{
+    s_usedBytes -= it->bytes;
+    s_index.Delete (APIGuid2GSGuid (it->guid));
+    s_entries.erase (it);
+}
+
+static void EvictToBudget ()
+{
+    while (s_usedBytes > s_budgetBytes && !s_entries.empty ())
+        Remove (std::prev (s_entries.end ()));
+}
+
+// ---------------- Отпечаток ----------------
+static UInt64 Mix (UInt64 value)
+{
+    value += 0x9E3779B97F4A7C15ULL;
+    value = (value ^ (value >> 30)) * 0xBF58476D1CE4E5B9ULL;
+    value = (value ^ (value >> 27)) * 0x94D049BB133111EBULL;
+    return value ^ (value >> 31);
+}
+
+static UInt64 HashGuid (const API_Guid& guid)
+{
+    UInt64 halves[2];
+    static_assert (sizeof (halves) == sizeof (API_Guid), "API_Guid is 16 bytes");
+    std::memcpy (halves, &guid, sizeof (halves));
+    return Mix (halves[0] ^ Mix (halves[1]));
+}
+
+bool TakeFingerprint (const API_Guid& guid, Fingerprint& fingerprint)
+{
+    API_Elem_Head head = {};
+    head.guid = guid;
+    if (API_CALL (ACAPI_Element_GetHeader, &head) != NoError)
+        return false;
+    fingerprint.project = s_projectId;
+    fingerprint.modiStamp = head.modiStamp;
+    fingerprint.operatorStamps = 0;
+
+    GS::Array<API_Guid> operators;
+    const GSErrCode err = API_CALL (ACAPI_Element_SolidLink_GetOperators, guid, &operators);
+    if (err != NoError && err != APIERR_NO3D)
+        return false;
+
+    // Сумма не зависит от порядка операторов; число операторов входит отдельно
+    UInt64 sum = Mix (operators.GetSize ());
+    for (const API_Guid& oper : operators) {
+        API_Elem_Head operHead = {};
+        operHead.guid = oper;
+        const UInt64 stamp = (API_CALL (ACAPI_Element_GetHeader, &operHead) == NoError) ? operHead.modiStamp : 0;
+        sum += Mix (HashGuid (oper) ^ stamp);
+    }
+    fingerprint.operatorStamps = sum;
+    return true;
+}
+
+// ---------------- Поиск и запись ----------------
+bool Find (const API_Guid& guid, const Fingerprint& fingerprint, GS::Array<Metric>& metrics)
+{
+    EntryList::iterator it;
+    if (!s_index.Get (APIGuid2GSGuid (guid), &it))
+        return false;
+    if (it->fingerprint != fingerprint) {
+        // Элемент или его операторы изменились — запись больше не понадобится
+        Remove (it);
+        return false;
+    }
+    s_entries.splice (s_entries.begin (), s_entries, it);
+    metrics = it->metrics;
+    return true;
+}
+
+void Store (const API_Guid& guid, const Fingerprint& fingerprint, const GS::Array<Metric>& metrics)
+{
+    const GS::Guid key = APIGuid2GSGuid (guid);
+    EntryList::iterator existing;
+    if (s_index.Get (key, &existing))
+        Remove (existing);
+
+    const UInt64 bytes = EstimateBytes (metrics);
+    if (bytes > s_budgetBytes)
+        return;
+
+    Entry entry;
+    entry.guid = guid;
+    entry.fingerprint = fingerprint;
+    entry.metrics = metrics;
+    entry.bytes = bytes;
+    s_entries.push_front (entry);
+    s_index.Add (key, s_entries.begin ());
+    s_usedBytes += bytes;
+    EvictToBudget ();
+}
+
+void SetBudget (UInt64 bytes)
+{
+    s_budgetBytes = bytes;
+    EvictToBudget ();
+}
+
+UInt64 GetUsedBytes ()
+{
+    return s_usedBytes;
+}
+
+UInt32 GetEntryCount ()
+{
+    return static_cast<UInt32> (s_entries.size ());
+}
+
+void Clear ()
+{
+    s_entries.clear ();
+    s_index.Clear ();
+    s_usedBytes = 0;
+}
+
+// ---------------- Идентичность проекта ----------------
+// Путь к файлу проекта и время его изменения: копия файла, другой проект по тому же пути или
+// правка файла в другом сеансе дают другую идентичность. Новый проект и Teamwork — без неё
+static UInt64 HashKey (const GS::UniString& key)
+{
+    const std::string utf8 (key.ToCStr (CC_UTF8).Get ());
+    UInt64 hash = 0xCBF29CE484222325ULL;
+    for (unsigned char c : utf8)
+        hash = (hash ^ c) * 0x100000001B3ULL;
+    return (hash == 0) ? 1 : hash;
+}
+
+static GS::UniString GetProjectKey ()
+{
+    API_ProjectInfo info = {};
+    if (API_CALL (ACAPI_ProjectOperation_Project, &info) != NoError)
+        return GS::UniString ();
+
+    GS::UniString key;
+    if (!info.untitled && !info.teamwork && info.projectPath != nullptr && !info.projectPath->IsEmpty ()) {
+#ifdef GS_WIN
+        struct _stat64 fileStat = {};
+        const bool statOk = _wstat64 (info.projectPath->ToUStr ().Get (), &fileStat) == 0;
+#else
+        struct stat fileStat = {};
+        const bool statOk = stat (info.projectPath->ToCStr (CC_UTF8).Get (), &fileStat) == 0;
+#endif
+        if (statOk)
+            key = *info.projectPath + GS::UniString::Printf ("|%lld", static_cast<long long> (fileStat.st_mtime));
+    }
+    delete info.location;
+    delete info.location_team;
+    delete info.projectPath;
+    delete info.projectName;
+    return key;
+}
+
+// ---------------- Файл кеша ----------------
+//   "TLMC" + uint32 версия + строка идентичности проекта + uint32 число записей, затем записи
+//   от самой старой к самой свежей: API_Guid, uint64 modiStamp, uint64 operatorStamps, uint32 число метрик,
+//   метрика: строка key, строка name, double gross, net, diff; строка — uint32 длина + UTF-8.
+// Версия повышается при любом изменении расчёта метрик: старый файл тогда просто не читается.
+static const char   FileMagic[4] = { 'T', 'L', 'M', 'C' };
+static const UInt32 FileVersion = 2;
+
+static std::FILE* OpenFile (const GS::UniString& path, bool write)
+{
+#ifdef GS_WIN
+    return _wfopen (path.ToUStr ().Get (), write ? L"wb" : L"rb");
+#else
+    return std::fopen (path.ToCStr (CC_UTF8).Get (), write ? "wb" : "rb");
+#endif
+}
+
+class FileWriter {
+public:
+    explicit FileWriter (std::FILE* file) : file (file) {}
+
+    void Put (const void* data, std::size_t size) { ok = ok && std::fwrite (data, 1, size, file) == size; }
+    template <typename T>
+    void Put (const T& value) { Put (&value, sizeof (value)); }
+    void PutString (const GS::UniString& value)
+    {
+        const std::string utf8 (value.ToCStr (CC_UTF8).Get ());
+        Put (static_cast<UInt32> (utf8.size ()));
+        Put (utf8.data (), utf8.size ());
+    }
+
+    bool ok = true;
+
+private:
+    std::FILE* file;
+};
+
+class FileReader {
+public:
+    explicit FileReader (std::FILE* file) : file (file) {}
+
+    void Get (void* data, std::size_t size) { ok = ok && std::fread (data, 1, size, file) == size; }
+    template <typename T>
+    void Get (T& value) { Get (&value, sizeof (value)); }
+    GS::UniString GetString ()
+    {
+        UInt32 length = 0;
+        Get (length);
+        if (!ok || length > (1 << 16)) {
+            ok = false;
+            return GS::UniString ();
+        }
+        std::string utf8 (length, '\0');
+        Get (&utf8[0], length);
+        return ok ? GS::UniString (utf8.c_str (), CC_UTF8) : GS::UniString ();
+    }
+
+    bool ok = true;
+
+private:
+    std::FILE* file;
+};
+
+static void Load ()
+{
+    std::FILE* file = OpenFile (s_filePath, false);
+    if (file == nullptr)
+        return;
+
+    FileReader reader (file);
+    char magic[4] = {};
+    UInt32 version = 0;
+    UInt32 count = 0;
+    reader.Get (magic, sizeof (magic));
+    reader.Get (version);
+    const bool header = reader.ok && std::memcmp (magic, FileMagic, sizeof (magic)) == 0 && version == FileVersion;
+    const bool sameProject = header && reader.GetString () == s_projectKey;
+    reader.Get (count);
+    if (reader.ok && sameProject) {
+        for (UInt32 i = 0; i < count && reader.ok; ++i) {
+            API_Guid guid = APINULLGuid;
+            Fingerprint fingerprint;
+            fingerprint.project = s_projectId;
+            UInt32 metricCount = 0;
+            reader.Get (guid);
+            reader.Get (fingerprint.modiStamp);
+            reader.Get (fingerprint.operatorStamps);
+            reader.Get (metricCount);
+            if (!reader.ok || metricCount > 4096)
+                break;
+
+            GS::Array<Metric> metrics;
+            for (UInt32 m = 0; m < metricCount && reader.ok; ++m) {
+                Metric metric;
+                metric.key = reader.GetString ();
+                metric.name = reader.GetString ();
+                reader.Get (metric.grossValue);
+                reader.Get (metric.netValue);
+                reader.Get (metric.diffValue);
+                metrics.Push (metric);
+            }
+            if (reader.ok)
+                Store (guid, fingerprint, metrics);
+        }
+    }
+    std::fclose (file);
+    LOG_INFO ("[MetricsCache] загружено записей: %u", static_cast<unsigned> (GetEntryCount ()));
+}
+
+// Очистить кеш и привязать его к открытому проекту; файл читается, если записан для него же
+static void BindProject ()
+{
+    Clear ();
+    s_projectKey = GetProjectKey ();
+    s_projectId = s_projectKey.IsEmpty () ? 0 : HashKey (s_projectKey);
+    if (!s_filePath.IsEmpty () && s_projectId != 0)
+        Load ();
+}
+
+void EnablePersistence (const GS::UniString& filePath)
+{
+    s_filePath = filePath;
+    BindProject ();
+}
+
+bool Save ()
+{
+    if (s_filePath.IsEmpty () || s_projectId == 0)
+        return false;
+    std::FILE* file = OpenFile (s_filePath, true);
+    if (file == nullptr)
+        return false;
+
+    FileWriter writer (file);
+    writer.Put (FileMagic, sizeof (FileMagic));
+    writer.Put (FileVersion);
+    writer.PutString (s_projectKey);
+    writer.Put (static_cast<UInt32> (s_entries.size ()));
+    for (EntryList::const_reverse_iterator it = s_entries.crbegin (); it != s_entries.crend (); ++it) {
+        writer.Put (it->guid);
+        writer.Put (it->fingerprint.modiStamp);
+        writer.Put (it->fingerprint.operatorStamps);
+        writer.Put (static_cast<UInt32> (it->metrics.GetSize ()));
+        for (const Metric& metric : it->metrics) {
+            writer.PutString (metric.key);
+            writer.PutString (metric.name);
+            writer.Put (metric.grossValue);
+            writer.Put (metric.netValue);
+            writer.Put (metric.diffValue);
+        }
+    }
+    const bool ok = writer.ok;
+    std::fclose (file);
+    return ok;
+}
+
+void HandleProjectEvent (API_NotifyEventID notifID)
+{
+    switch (notifID) {
+        case APINotify_New:
+        case APINotify_NewAndReset:
+        case APINotify_Open:
+            BindProject ();
+            break;
+        case APINotify_Close:
+        case APINotify_Quit:
+            Clear ();
+            s_projectKey.Clear ();
+            s_projectId = 0;
+            break;
+        case APINotify_Save: {
+            // Записи остаются верными для того же состояния модели; меняется только
+            // идентичность (время файла, путь при «Сохранить как»)
+            s_projectKey = GetProjectKey ();
+            s_projectId = s_projectKey.IsEmpty () ? 0 : HashKey (s_projectKey);
+            for (Entry& entry : s_entries)
+                entry.fingerprint.project = s_projectId;
+            Save ();
+            break;
+        }
+        default:
+            break;
+    }
+}
+
+} // namespace MetricsCache
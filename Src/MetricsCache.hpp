@@ -0,0 +1,61 @@
+#ifndef METRICSCACHE_HPP
+#define METRICSCACHE_HPP
+
+#include "APIEnvir.h"
+#include "ACAPinc.h"
+#include "GSRoot.hpp"
+
+#include "SelectionMetricsHelper.hpp"
+
+// Кеш SEO-метрик элементов. Ключ — GUID элемента, запись действительна, пока не изменились
+// modiStamp самого элемента и modiStamp его SEO-операторов: повторный запрос по неизменённому
+// элементу не создаёт временных копий. Память ограничена бюджетом, вытесняются давно не
+// запрошенные записи (LRU). По желанию кеш сохраняется между сессиями — только для
+// сохранённого (не Teamwork) проекта: идентичность проекта (путь и время изменения файла)
+// входит в отпечаток и в заголовок файла кеша, при смене проекта кеш очищается.
+namespace MetricsCache {
+
+    typedef SelectionMetricsHelper::Metric Metric;
+
+    const UInt64 DefaultBudgetBytes = 16 << 20;
+
+    // Состояние элемента, от которого зависят его метрики
+    struct Fingerprint {
+        UInt64  project = 0;            // идентичность проекта; 0 — без сохранения (новый, Teamwork)
+        UInt64  modiStamp = 0;          // элемент
+        UInt64  operatorStamps = 0;     // GUID и modiStamp SEO-операторов; от порядка не зависит
+
+        bool operator== (const Fingerprint& other) const
+        {
+            return project == other.project && modiStamp == other.modiStamp && operatorStamps == other.operatorStamps;
+        }
+        bool operator!= (const Fingerprint& other) const { return !(*this == other); }
+    };
+
+    // Снять отпечаток через API (заголовок элемента и его операторов); false — элемент не найден
+    bool TakeFingerprint (const API_Guid& guid, Fingerprint& fingerprint);
+
+    // Метрики, сохранённые для этого же отпечатка; при попадании запись становится самой свежей
+    bool Find (const API_Guid& guid, const Fingerprint& fingerprint, GS::Array<Metric>& metrics);
+    void Store (const API_Guid& guid, const Fingerprint& fingerprint, const GS::Array<Metric>& metrics);
+
+    void SetBudget (UInt64 bytes);
+    UInt64 GetUsedBytes ();
+    UInt32 GetEntryCount ();
+    void Clear ();
+
+    // Сохранение между сессиями: записи открытого проекта читаются из filePath, если файл
+    // кеша записан для этого же проекта. Без вызова кеш живёт только в памяти.
+    void EnablePersistence (const GS::UniString& filePath);
+
+    // Записать кеш текущего проекта. Вызывается после сохранения проекта: записи с modiStamp,
+    // которых нет в файле проекта, могли бы совпасть с другими правками в следующем сеансе
+    bool Save ();
+
+    // Реакция на событие проекта (вызывается из общего обработчика BrowserRepl):
+    // открытие/создание — очистить и привязать к новому проекту, сохранение — записать файл
+    void HandleProjectEvent (API_NotifyEventID notifID);
+
+} // namespace MetricsCache
+
+#endif // METRICSCACHE_HPP
@@ -0,0 +1,195 @@
+#include "NameCache.hpp"
+#include "ApiProfiler.hpp"
+
+namespace NameCache {
+
+// ---------------- Пул интернированных строк ----------------
+static GS::Array<GS::UniString>                s_strings;
+static GS::HashTable<GS::UniString, NameHandle> s_handles;
+
+// ---------------- Записи кеша атрибутов ----------------
+// pass — номер прохода, в котором имя последний раз сверялось с API
+struct AttributeEntry {
+    NameHandle handle = EmptyName;
+    UInt32     pass = 0;
+};
+
+static GS::HashTable<UInt64, NameHandle>                     s_typeNames;
+static GS::HashTable<API_AttributeIndex, AttributeEntry>     s_layerNames;
+static GS::HashTable<API_AttributeIndex, AttributeEntry>     s_materialNames;
+static GS::HashTable<NameHandle, API_AttributeIndex>         s_layersByName;
+static UInt32                                                s_layersByNamePass = 0;
+static UInt32                                                s_pass = 1;
+
+static void EnsurePool ()
+{
+    if (s_strings.IsEmpty ()) {
+        s_strings.Push (GS::UniString ());
+        s_handles.Add (GS::UniString (), EmptyName);
+    }
+}
+
+// ---------------- Интернировать строку ----------------
+NameHandle Intern (const GS::UniString& value)
+{
+    EnsurePool ();
+    NameHandle handle = EmptyName;
+    if (s_handles.Get (value, &handle))
+        return handle;
+
+    handle = static_cast<NameHandle> (s_strings.GetSize ());
+    s_strings.Push (value);
+    s_handles.Add (value, handle);
+    return handle;
+}
+
+// ---------------- Строка по хендлу ----------------
+const GS::UniString& GetString (NameHandle handle)
+{
+    EnsurePool ();
+    if (handle >= s_strings.GetSize ())
+        return s_strings[EmptyName];
+    return s_strings[handle];
+}
+
+// ---------------- Имя типа элемента ----------------
+NameHandle GetTypeName (const API_ElemType& type)
+{
+    const UInt64 typeKey = (static_cast<UInt64> (type.typeID) << 32) | static_cast<UInt32> (type.variationID);
+    NameHandle handle = EmptyName;
+    if (s_typeNames.Get (typeKey, &handle))
+        return handle;
+
+    GS::UniString typeName;
+    if (API_CALL (ACAPI_Element_GetElemTypeName, type, typeName) == NoError)
+        handle = Intern (typeName);
+    s_typeNames.Add (typeKey, handle);
+    return handle;
+}
+
+// ---------------- Имя атрибута с перепроверкой раз в проход ----------------
+static NameHandle GetAttributeName (GS::HashTable<API_AttributeIndex, AttributeEntry>& table, API_AttrTypeID typeID, API_AttributeIndex index)
+{
+    AttributeEntry* entry = table.GetPtr (index);
+    if (entry != nullptr && entry->pass == s_pass)
+        return entry->handle;
+
+    API_Attribute attr = {};
+    attr.header.typeID = typeID;
+    attr.header.index = index;
+    const NameHandle handle = (API_CALL (ACAPI_Attribute_Get, &attr) == NoError) ? Intern (GS::UniString (attr.header.name)) : EmptyName;
+
+    if (entry != nullptr) {
+        entry->handle = handle;
+        entry->pass = s_pass;
+    } else {
+        AttributeEntry newEntry;
+        newEntry.handle = handle;
+        newEntry.pass = s_pass;
+        table.Add (index, newEntry);
+    }
+    return handle;
+}
+
+NameHandle GetLayerName (API_AttributeIndex layerIndex)
+{
+    return GetAttributeName (s_layerNames, API_LayerID, layerIndex);
+}
+
+NameHandle GetBuildingMaterialName (API_AttributeIndex materialIndex)
+{
+    return GetAttributeName (s_materialNames, API_BuildingMaterialID, materialIndex);
+}
+
+// ---------------- Обратная таблица: имя слоя -> индекс ----------------
+static void RebuildLayersByName ()
+{
+    s_layersByName.Clear ();
+    s_layersByNamePass = s_pass;
+
+    GS::UInt32 layerCount = 0;
+    if (API_CALL (ACAPI_Attribute_GetNum, API_LayerID, layerCount) != NoError)
+        return;
+
+    for (Int32 i = 1; i <= static_cast<Int32> (layerCount); ++i) {
+        const API_AttributeIndex index = ACAPI_CreateAttributeIndex (i);
+        const NameHandle handle = GetLayerName (index);
+        if (handle != EmptyName && !s_layersByName.ContainsKey (handle))
+            s_layersByName.Add (handle, index);
+    }
+}
+
+API_AttributeIndex FindLayerByName (const GS::UniString& layerName)
+{
+    if (s_layersByNamePass != s_pass)
+        RebuildLayersByName ();
+
+    // Искомое имя не интернируется: неизвестные имена не должны расти в пуле
+    API_AttributeIndex index = APIInvalidAttributeIndex;
+    NameHandle handle = EmptyName;
+    if (s_handles.Get (layerName, &handle))
+        s_layersByName.Get (handle, &index);
+    return index;
+}
+
+// ---------------- Управление актуальностью ----------------
+void BeginPass ()
+{
+    ++s_pass;
+}
+
+void OnLayerChanged (API_AttributeIndex layerIndex, const GS::UniString& layerName)
+{
+    const NameHandle handle = Intern (layerName);
+
+    AttributeEntry entry;
+    entry.handle = handle;
+    entry.pass = s_pass;
+    AttributeEntry* existing = s_layerNames.GetPtr (layerIndex);
+    if (existing != nullptr) {
+        if (existing->handle != handle)
+            s_layersByName.Delete (existing->handle);
+        *existing = entry;
+    } else {
+        s_layerNames.Add (layerIndex, entry);
+    }
+
+    if (s_layersByNamePass == s_pass && !s_layersByName.ContainsKey (handle))
+        s_layersByName.Add (handle, layerIndex);
+}
+
+void InvalidateAttributes ()
+{
+    s_layerNames.Clear ();
+    s_materialNames.Clear ();
+    s_layersByName.Clear ();
+    s_layersByNamePass = 0;
+}
+
+void InvalidateAll ()
+{
+    InvalidateAttributes ();
+    s_typeNames.Clear ();
+    s_handles.Clear ();
+    s_strings.Clear ();
+}
+
+void HandleProjectEvent (API_NotifyEventID notifID)
+{
+    switch (notifID) {
+        case APINotify_New:
+        case APINotify_NewAndReset:
+        case APINotify_Open:
+        case APINotify_Close:
+        case APINotify_Quit:
+            InvalidateAll ();
+            break;
+        case APINotify_ChangeProjectDB:
+            InvalidateAttributes ();
+            break;
+        default:
+            break;
+    }
+}
+
+} // namespace NameCache
@@ -0,0 +1,53 @@
+#ifndef NAMECACHE_HPP
+#define NAMECACHE_HPP
+
+#include "APIEnvir.h"
+#include "ACAPinc.h"
+#include "GSRoot.hpp"
+
+// Общий кеш имён типов элементов, слоёв и строительных материалов.
+// Строки интернируются: каждое имя хранится один раз, наружу выдаётся NameHandle.
+// Хендлы действительны до закрытия проекта.
+namespace NameCache {
+
+    typedef UInt32 NameHandle;
+
+    // Хендл пустой строки (и признак «имя не найдено»)
+    const NameHandle EmptyName = 0;
+
+    // Интернировать строку из ограниченного набора (имя этажа, класса и т.п.). Пул живёт до
+    // закрытия проекта, поэтому почти уникальные строки (ID элементов) сюда не кладутся
+    NameHandle Intern (const GS::UniString& value);
+
+    // Строка по хендлу
+    const GS::UniString& GetString (NameHandle handle);
+
+    // Имя типа элемента (не меняется в течение сессии)
+    NameHandle GetTypeName (const API_ElemType& type);
+
+    // Имя слоя / строительного материала по индексу; EmptyName, если атрибут не найден
+    NameHandle GetLayerName (API_AttributeIndex layerIndex);
+    NameHandle GetBuildingMaterialName (API_AttributeIndex materialIndex);
+
+    // Индекс слоя по имени (обратная таблица); APIInvalidAttributeIndex, если не найден
+    API_AttributeIndex FindLayerByName (const GS::UniString& layerName);
+
+    // Начало очередного прохода (обновление палитры, сбор метрик): имена атрибутов
+    // перепроверяются через API не чаще одного раза за проход
+    void BeginPass ();
+
+    // Слой создан или переименован нами — обновить таблицы без полного сброса
+    void OnLayerChanged (API_AttributeIndex layerIndex, const GS::UniString& layerName);
+
+    // Сброс кеша атрибутов (слои, материалы)
+    void InvalidateAttributes ();
+
+    // Полный сброс, включая пул строк (закрытие / открытие проекта)
+    void InvalidateAll ();
+
+    // Реакция на событие проекта (вызывается из общего обработчика BrowserRepl)
+    void HandleProjectEvent (API_NotifyEventID notifID);
+
+} // namespace NameCache
+
+#endif // NAMECACHE_HPP
@@ -5,6 +5,7 @@
 
 #include "APIEnvir.h"
 #include "ACAPinc.h"	
+#include "ApiProfiler.hpp"
 
 
 GSErrCode PropertyUtils::PropertyToString (const API_Property& property, GS::UniString& propertyValue)
@@ -13,5 +14,5 @@ GSErrCode PropertyUtils::PropertyToString (const API_Property& property, GS::Uni
 		return APIERR_BADPROPERTY;
 	}
 
-	return ACAPI_Property_GetPropertyValueString (property, &propertyValue);
+	return API_CALL (ACAPI_Property_GetPropertyValueString, property, &propertyValue);
 }
\ No newline at end of file
@@ -0,0 +1,60 @@
+#include "QuantityDescriptors.hpp"
+
+#include <initializer_list>
+
+namespace QuantityDescriptors {
+
+static_assert (IsSupported (API_SlabID) && !IsSupported (API_WallID), "TypeTable lookup must work at compile time");
+
+// Типы в порции обычно одни и те же — маску каждого типа добавляем один раз
+static bool Contains (const TypeDescriptor* const* seen, UIndex count, const TypeDescriptor* descriptor)
+{
+    for (UIndex i = 0; i < count; ++i) {
+        if (seen[i] == descriptor)
+            return true;
+    }
+    return false;
+}
+
+bool BuildMask (const GS::Array<API_ElemTypeID>& types, UInt32 quantities, API_QuantitiesMask& mask)
+{
+    ACAPI_ELEMENT_QUANTITIES_MASK_CLEAR (mask);
+
+    const TypeDescriptor*   seen[sizeof (TypeTable) / sizeof (TypeTable[0])] = {};
+    UIndex                  seenCount = 0;
+    bool                    any = false;
+    for (API_ElemTypeID typeID : types) {
+        const TypeDescriptor* descriptor = Find (typeID);
+        if (descriptor == nullptr || Contains (seen, seenCount, descriptor))
+            continue;
+        seen[seenCount++] = descriptor;
+
+        for (Quantity quantity : { TopSurface, TotalSurface, Volume }) {
+            const Field& field = GetField (*descriptor, quantity);
+            if ((quantities & quantity) != 0 && field.setMask != nullptr) {
+                field.setMask (mask);
+                any = true;
+            }
+        }
+        if ((quantities & LayerVolumes) != 0 && descriptor->hasComposites) {
+            ACAPI_ELEMENT_COMPOSITES_QUANTITY_MASK_SET (mask, buildMatIndices);
+            ACAPI_ELEMENT_COMPOSITES_QUANTITY_MASK_SET (mask, volumes);
+            any = true;
+        }
+    }
+    return any;
+}
+
+bool NeedsComposites (const GS::Array<API_ElemTypeID>& types, UInt32 quantities)
+{
+    if ((quantities & LayerVolumes) == 0)
+        return false;
+    for (API_ElemTypeID typeID : types) {
+        const TypeDescriptor* descriptor = Find (typeID);
+        if (descriptor != nullptr && descriptor->hasComposites)
+            return true;
+    }
+    return false;
+}
+
+} // namespace QuantityDescriptors
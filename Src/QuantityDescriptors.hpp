@@ -0,0 +1,105 @@
+#ifndef QUANTITYDESCRIPTORS_HPP
+#define QUANTITYDESCRIPTORS_HPP
+
+#include "APIEnvir.h"
+#include "ACAPinc.h"
+#include "GSRoot.hpp"
+
+// Таблица количеств по типам элементов: какое поле API_ElementQuantity даёт каждую
+// величину и какой бит маски его включает. По таблице строится минимальная маска запроса
+// ACAPI_Element_GetMoreQuantities — Archicad считает только то, что прочитают метрики.
+// Новый тип элемента (стена, колонна, балка) — новая строка в TypeTable.
+namespace QuantityDescriptors {
+
+    // Величины, из которых собираются метрики
+    enum Quantity : UInt32 {
+        TopSurface      = 1 << 0,   // верхняя / опорная поверхность
+        TotalSurface    = 1 << 1,   // нижняя / противоположная поверхность
+        Volume          = 1 << 2,
+        LayerVolumes    = 1 << 3,   // послойные объёмы многослойных конструкций (composites)
+
+        AllQuantities   = TopSurface | TotalSurface | Volume | LayerVolumes
+    };
+
+    typedef double (*FieldReader) (const API_ElementQuantity& quantity);
+    typedef void (*MaskSetter) (API_QuantitiesMask& mask);
+
+    // Поле количества; read == nullptr — у типа такой величины нет
+    struct Field {
+        FieldReader read = nullptr;
+        MaskSetter  setMask = nullptr;
+    };
+
+    struct TypeDescriptor {
+        API_ElemTypeID  typeID;
+        Field           topSurface;
+        Field           totalSurface;
+        Field           volume;
+        bool            hasComposites;
+    };
+
+// Чтение поля quantity.member.field и бит маски для него
+#define TOLAYOUT_QUANTITY_FIELD(member, field) \
+    Field { [] (const API_ElementQuantity& quantity) -> double { return quantity.member.field; }, \
+            [] (API_QuantitiesMask& mask) { ACAPI_ELEMENT_QUANTITY_MASK_SET (mask, member, field); } }
+
+    inline constexpr TypeDescriptor TypeTable[] = {
+        { API_MeshID,  TOLAYOUT_QUANTITY_FIELD (mesh, topSurface),       TOLAYOUT_QUANTITY_FIELD (mesh, bottomSurface),
+                       TOLAYOUT_QUANTITY_FIELD (mesh, volume),           true },
+        { API_SlabID,  TOLAYOUT_QUANTITY_FIELD (slab, topSurface),       TOLAYOUT_QUANTITY_FIELD (slab, bottomSurface),
+                       TOLAYOUT_QUANTITY_FIELD (slab, volume),           true },
+        { API_RoofID,  TOLAYOUT_QUANTITY_FIELD (roof, topSurface),       TOLAYOUT_QUANTITY_FIELD (roof, bottomSurface),
+                       TOLAYOUT_QUANTITY_FIELD (roof, volume),           true },
+        { API_ShellID, TOLAYOUT_QUANTITY_FIELD (shell, referenceSurface), TOLAYOUT_QUANTITY_FIELD (shell, oppositeSurface),
+                       TOLAYOUT_QUANTITY_FIELD (shell, volume),          true },
+        { API_MorphID, TOLAYOUT_QUANTITY_FIELD (morph, surface),         TOLAYOUT_QUANTITY_FIELD (morph, surface),
+                       TOLAYOUT_QUANTITY_FIELD (morph, volume),          true },
+    };
+
+#undef TOLAYOUT_QUANTITY_FIELD
+
+    // Метрика элемента: ключ, подпись и величина, из которой она берётся.
+    // Послойные метрики (layer_<материал>_volume) строятся отдельно из LayerVolumes.
+    struct MetricDescriptor {
+        const char* key;
+        const char* name;
+        Quantity    quantity;
+    };
+
+    inline constexpr MetricDescriptor MetricTable[] = {
+        { "totalArea",  "Площадь",                      TotalSurface },
+        { "topSurface", "Площадь верхней поверхности",  TopSurface },
+        { "volume",     "Объем",                        Volume },
+    };
+
+    constexpr const TypeDescriptor* Find (API_ElemTypeID typeID)
+    {
+        for (const TypeDescriptor& descriptor : TypeTable) {
+            if (descriptor.typeID == typeID)
+                return &descriptor;
+        }
+        return nullptr;
+    }
+
+    constexpr bool IsSupported (API_ElemTypeID typeID)
+    {
+        return Find (typeID) != nullptr;
+    }
+
+    // Поле типа для величины (TopSurface / TotalSurface / Volume)
+    constexpr const Field& GetField (const TypeDescriptor& descriptor, Quantity quantity)
+    {
+        return (quantity == TopSurface) ? descriptor.topSurface
+             : (quantity == TotalSurface) ? descriptor.totalSurface
+             : descriptor.volume;
+    }
+
+    // Маска только под нужные величины этих типов; пустая — запрашивать нечего
+    bool BuildMask (const GS::Array<API_ElemTypeID>& types, UInt32 quantities, API_QuantitiesMask& mask);
+
+    // Нужны ли composites (послойные объёмы) хотя бы одному из типов
+    bool NeedsComposites (const GS::Array<API_ElemTypeID>& types, UInt32 quantities);
+
+} // namespace QuantityDescriptors
+
+#endif // QUANTITYDESCRIPTORS_HPP
@@ -5,6 +5,7 @@
 
 #include "DGBrowser.hpp"
 #include "BrowserRepl.hpp"
+#include "GrossMetricsJob.hpp"
 
 // -------------------- local helpers --------------------
 static GS::UniString LoadSelectionDetailsHtml()
@@ -156,6 +157,27 @@ void SelectionDetailsPalette::UpdateSelectedElementsOnHTML()
 		GetInstance().m_browserCtrl->ExecuteJS("UpdateSelectedElements()");
 }
 
+// Готова очередная порция gross-метрик; палитра забирает её через ACAPI.TakeSeoGrossMetrics
+void SelectionDetailsPalette::NotifySeoGrossMetricsReady()
+{
+	if (!HasInstance() || !GetInstance().IsVisible())
+		return;
+
+	if (GetInstance().m_browserCtrl != nullptr)
+		GetInstance().m_browserCtrl->ExecuteJS("if (typeof OnSeoGrossMetricsReady === 'function') OnSeoGrossMetricsReady()");
+}
+
+// Наблюдаемый элемент или его оператор изменён (SeoWatch): палитра помечает строки устаревшими,
+// пересчёт — по кнопке, через ACAPI.RecomputeStaleSeoMetrics
+void SelectionDetailsPalette::NotifySeoMetricsStale()
+{
+	if (!HasInstance() || !GetInstance().IsVisible())
+		return;
+
+	if (GetInstance().m_browserCtrl != nullptr)
+		GetInstance().m_browserCtrl->ExecuteJS("if (typeof OnSeoMetricsStale === 'function') OnSeoMetricsStale()");
+}
+
 GSErrCode SelectionDetailsPalette::RegisterPaletteControlCallBack()
 {
 	return ACAPI_RegisterModelessWindow(
@@ -194,6 +216,8 @@ void SelectionDetailsPalette::PanelCloseRequested(const DG::PanelCloseRequestEve
 GSErrCode SelectionDetailsPalette::SelectionChangeHandler(const API_Neig* neig)
 {
 	(void)neig; // unused parameter
+	// gross для прежнего выделения больше не нужен
+	GrossMetricsJob::Cancel();
 	if (SelectionDetailsPalette::HasInstance())
 		SelectionDetailsPalette::UpdateSelectedElementsOnHTML();
 	return NoError;
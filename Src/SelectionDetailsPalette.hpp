@@ -22,6 +22,8 @@ public:
 	static void         ShowPalette();
 	static void         HidePalette();
 	static void         UpdateSelectedElementsOnHTML();
+	static void         NotifySeoGrossMetricsReady();
+	static void         NotifySeoMetricsStale();
 	static GSErrCode    RegisterPaletteControlCallBack();
 	static GSErrCode    SelectionChangeHandler(const API_Neig* neig);
 
@@ -0,0 +1,448 @@
+#include "SelectionGroupHelper.hpp"
+#include "SelectionMetricsHelper.hpp"
+#include "PropertyUtils.hpp"
+#include "NameCache.hpp"
+#include "ApiProfiler.hpp"
+
+#include <algorithm>
+#include <vector>
+
+namespace SelectionGroupHelper {
+
+// Максимальное число ключей группировки (тип, ID, слой, этаж + свойства)
+static const UIndex MaxKeyCount = 8;
+
+// ---------------- Составной ключ группы: интернированные значения каждого поля ----------------
+struct GroupTuple {
+    UInt32 parts[MaxKeyCount] = {};
+    UInt32 size = 0;
+
+    bool operator== (const GroupTuple& other) const
+    {
+        if (size != other.size)
+            return false;
+        for (UInt32 i = 0; i < size; ++i) {
+            if (parts[i] != other.parts[i])
+                return false;
+        }
+        return true;
+    }
+
+    ULong GenerateHashValue () const
+    {
+        ULong hash = 2166136261u;
+        for (UInt32 i = 0; i < size; ++i) {
+            hash ^= parts[i];
+            hash *= 16777619u;
+        }
+        return hash;
+    }
+};
+
+// ---------------- Таблица значений одного ключа: строка -> номер ----------------
+class KeyValueTable {
+public:
+    UInt32 Intern (const GS::UniString& value)
+    {
+        UInt32 id = 0;
+        if (m_ids.Get (value, &id))
+            return id;
+        id = static_cast<UInt32> (m_values.GetSize ());
+        m_values.Push (value);
+        m_ids.Add (value, id);
+        return id;
+    }
+
+    const GS::UniString& Get (UInt32 id) const { return m_values[id]; }
+
+private:
+    GS::HashTable<GS::UniString, UInt32> m_ids;
+    GS::Array<GS::UniString>             m_values;
+};
+
+// ---------------- Снимок выделения: GUID, упорядоченные по группам ----------------
+struct Snapshot {
+    UInt32              id = 0;
+    GS::Array<API_Guid> guids;         // GUID всех элементов, сгруппированные подряд
+    GS::Array<UInt32>   groupOffsets;  // начало каждой группы в guids (+ конец последней)
+};
+
+static Snapshot s_snapshot;
+static UInt32   s_nextSnapshotId = 1;
+
+// ---------------- Имена этажей по floorInd ----------------
+static GS::HashTable<short, GS::UniString> GetStoryNames ()
+{
+    GS::HashTable<short, GS::UniString> names;
+    API_StoryInfo storyInfo = {};
+    if (API_CALL (ACAPI_ProjectSetting_GetStorySettings, &storyInfo) != NoError || storyInfo.data == nullptr)
+        return names;
+
+    const API_StoryType* stories = reinterpret_cast<API_StoryType*> (*storyInfo.data);
+    for (short i = 0; i <= storyInfo.lastStory - storyInfo.firstStory; ++i) {
+        names.Add (stories[i].index, GS::UniString (stories[i].uName));
+    }
+    BMKillHandle ((GSHandle*) &storyInfo.data);
+    return names;
+}
+
+// ---------------- Значение свойства элемента в виде строки ----------------
+static GS::UniString GetPropertyValueString (const API_Guid& elemGuid, const API_Guid& propertyGuid)
+{
+    GS::Array<API_Guid> definitions;
+    definitions.Push (propertyGuid);
+    GS::Array<API_Property> properties;
+    if (API_CALL (ACAPI_Element_GetPropertyValuesByGuid, elemGuid, definitions, properties) != NoError || properties.IsEmpty ())
+        return GS::UniString ();
+
+    GS::UniString value;
+    if (PropertyUtils::PropertyToString (properties[0], value) != NoError)
+        return GS::UniString ();
+    return value;
+}
+
+// ---------------- Разбор ключа группировки ----------------
+bool ParseKeySpec (const GS::UniString& str, KeySpec& spec)
+{
+    spec = KeySpec ();
+    if (str == "type") {
+        spec.kind = KeyKind::Type;
+    } else if (str == "id") {
+        spec.kind = KeyKind::ID;
+    } else if (str == "layer") {
+        spec.kind = KeyKind::Layer;
+    } else if (str == "story") {
+        spec.kind = KeyKind::Story;
+    } else if (str.BeginsWith ("property:")) {
+        const GS::UniString guidStr = str.GetSubstring (9, str.GetLength () - 9);
+        spec.kind = KeyKind::Property;
+        spec.propertyGuid = APIGuidFromString (guidStr.ToCStr ().Get ());
+        if (spec.propertyGuid == APINULLGuid)
+            return false;
+    } else {
+        return false;
+    }
+    return true;
+}
+
+// ---------------- Разбор колонки сортировки ----------------
+SortSpec ParseSortSpec (const GS::UniString& column, const GS::UniString& direction, const GS::Array<GS::UniString>& keyNames)
+{
+    SortSpec spec;
+    spec.ascending = (direction != "desc");
+    if (column.IsEmpty ()) {
+        spec.column = SortColumn::None;
+    } else if (column == "count") {
+        spec.column = SortColumn::Count;
+    } else if (column == "area") {
+        spec.column = SortColumn::Area;
+    } else if (column == "volume") {
+        spec.column = SortColumn::Volume;
+    } else {
+        for (UIndex i = 0; i < keyNames.GetSize (); ++i) {
+            if (keyNames[i] == column) {
+                spec.column = SortColumn::Key;
+                spec.keyIndex = i;
+                break;
+            }
+        }
+    }
+    return spec;
+}
+
+// ---------------- Сортировка строк таблицы ----------------
+static void SortRows (GS::Array<GroupRow>& rows, const SortSpec& sortSpec)
+{
+    if (sortSpec.column == SortColumn::None || rows.GetSize () < 2)
+        return;
+
+    // Ключи сравнения без учёта регистра считаем один раз на строку, а не на сравнение
+    GS::Array<GS::UniString> textKeys;
+    if (sortSpec.column == SortColumn::Key) {
+        for (const GroupRow& row : rows) {
+            textKeys.Push (sortSpec.keyIndex < row.keyValues.GetSize () ? row.keyValues[sortSpec.keyIndex].ToLowerCase () : GS::UniString ());
+        }
+    }
+
+    std::vector<UIndex> order (rows.GetSize ());
+    for (UIndex i = 0; i < rows.GetSize (); ++i)
+        order[i] = i;
+
+    auto numericValue = [&] (UIndex i) -> double {
+        switch (sortSpec.column) {
+            case SortColumn::Count:  return static_cast<double> (rows[i].count);
+            case SortColumn::Area:   return rows[i].area;
+            case SortColumn::Volume: return rows[i].volume;
+            default:                 return 0.0;
+        }
+    };
+
+    std::stable_sort (order.begin (), order.end (), [&] (UIndex a, UIndex b) {
+        if (sortSpec.column == SortColumn::Key) {
+            if (textKeys[a] == textKeys[b])
+                return false;
+            return sortSpec.ascending ? (textKeys[a] < textKeys[b]) : (textKeys[b] < textKeys[a]);
+        }
+        const double va = numericValue (a);
+        const double vb = numericValue (b);
+        return sortSpec.ascending ? (va < vb) : (vb < va);
+    });
+
+    GS::Array<GroupRow> sorted;
+    sorted.SetCapacity (rows.GetSize ());
+    for (UIndex i : order)
+        sorted.Push (rows[i]);
+    rows = sorted;
+}
+
+// ---------------- Ключ, требующий запроса к каждому элементу (не только заголовка) ----------------
+static bool IsPerElementKey (const KeySpec& spec)
+{
+    return spec.kind == KeyKind::ID || spec.kind == KeyKind::Property;
+}
+
+// ---------------- Результат хеш-группировки набора элементов ----------------
+struct Grouping {
+    GS::Array<KeyValueTable>  valueTables;  // интернированные значения каждого ключа
+    GS::Array<GroupTuple>     groupTuples;
+    GS::Array<UInt32>         groupCounts;
+    GS::Array<UInt32>         elemGroups;   // индекс группы для каждого элемента
+    GS::Array<API_Guid>       elemGuids;
+    GS::Array<API_ElemTypeID> elemTypes;
+};
+
+// Группирует элементы по ключам; ключи с resolve[k] == false не запрашиваются (пустое значение)
+static void GroupElements (const GS::Array<API_Guid>& source, const GS::Array<KeySpec>& keys, const GS::Array<bool>& resolve, Grouping& out)
+{
+    const UInt32 keyCount = static_cast<UInt32> (keys.GetSize () < MaxKeyCount ? keys.GetSize () : MaxKeyCount);
+
+    // Значения ключей интернируются: API запрашивается один раз на уникальный тип/слой/этаж
+    // (имена типов и слоёв — из общего NameCache)
+    GS::HashTable<NameCache::NameHandle, UInt32> nameIds[MaxKeyCount];
+    GS::HashTable<short, UInt32>              storyIds;
+    GS::HashTable<short, GS::UniString>       storyNames;
+    out.valueTables.Clear ();
+    for (UInt32 k = 0; k < keyCount; ++k) {
+        out.valueTables.Push (KeyValueTable ());
+        if (resolve[k] && keys[k].kind == KeyKind::Story && storyNames.IsEmpty ())
+            storyNames = GetStoryNames ();
+    }
+
+    GS::HashTable<GroupTuple, UInt32> groupIds;
+    out.elemGroups.SetCapacity (source.GetSize ());
+    out.elemGuids.SetCapacity (source.GetSize ());
+    out.elemTypes.SetCapacity (source.GetSize ());
+
+    for (const API_Guid& guid : source) {
+        API_Elem_Head elemHead = {};
+        elemHead.guid = guid;
+        if (API_CALL (ACAPI_Element_GetHeader, &elemHead) != NoError)
+            continue;
+
+        GroupTuple tuple;
+        tuple.size = keyCount;
+        for (UInt32 k = 0; k < keyCount; ++k) {
+            UInt32 valueId = 0;
+            KeyValueTable& valueTable = out.valueTables[k];
+            if (!resolve[k]) {
+                tuple.parts[k] = valueTable.Intern (GS::UniString ());
+                continue;
+            }
+            switch (keys[k].kind) {
+                case KeyKind::Type: {
+                    const NameCache::NameHandle typeName = NameCache::GetTypeName (elemHead.type);
+                    if (!nameIds[k].Get (typeName, &valueId)) {
+                        valueId = valueTable.Intern (NameCache::GetString (typeName));
+                        nameIds[k].Add (typeName, valueId);
+                    }
+                    break;
+                }
+                case KeyKind::ID: {
+                    GS::UniString elemID;
+                    API_CALL (ACAPI_Element_GetElementInfoString, &elemHead.guid, &elemID);
+                    valueId = valueTable.Intern (elemID);
+                    break;
+                }
+                case KeyKind::Layer: {
+                    const NameCache::NameHandle layerName = NameCache::GetLayerName (elemHead.layer);
+                    if (!nameIds[k].Get (layerName, &valueId)) {
+                        valueId = valueTable.Intern (layerName != NameCache::EmptyName ? NameCache::GetString (layerName) : GS::UniString ("Unknown"));
+                        nameIds[k].Add (layerName, valueId);
+                    }
+                    break;
+                }
+                case KeyKind::Story: {
+                    if (!storyIds.Get (elemHead.floorInd, &valueId)) {
+                        GS::UniString storyName;
+                        if (!storyNames.Get (elemHead.floorInd, &storyName))
+                            storyName = GS::UniString::Printf ("%d", (int) elemHead.floorInd);
+                        valueId = valueTable.Intern (storyName);
+                        storyIds.Add (elemHead.floorInd, valueId);
+                    }
+                    break;
+                }
+                case KeyKind::Property:
+                    valueId = valueTable.Intern (GetPropertyValueString (elemHead.guid, keys[k].propertyGuid));
+                    break;
+            }
+            tuple.parts[k] = valueId;
+        }
+
+        UInt32 groupIndex = 0;
+        if (!groupIds.Get (tuple, &groupIndex)) {
+            groupIndex = static_cast<UInt32> (out.groupTuples.GetSize ());
+            groupIds.Add (tuple, groupIndex);
+            out.groupTuples.Push (tuple);
+            out.groupCounts.Push (0);
+        }
+        out.groupCounts[groupIndex]++;
+        out.elemGroups.Push (groupIndex);
+        out.elemGuids.Push (elemHead.guid);
+        out.elemTypes.Push (elemHead.type.typeID);
+    }
+}
+
+// ---------------- Группировка текущего выделения ----------------
+GroupsResult GetSelectionGroups (const GS::Array<KeySpec>& keys, const SortSpec& sortSpec, bool withSums, UInt32 summaryThreshold)
+{
+    API_OPERATION ("grouping");
+    GroupsResult result;
+
+    API_SelectionInfo selectionInfo = {};
+    GS::Array<API_Neig> selNeigs;
+    API_CALL (ACAPI_Selection_Get, &selectionInfo, &selNeigs, false, false);
+    BMKillHandle ((GSHandle*) &selectionInfo.marquee.coords);
+
+    GS::Array<API_Guid> selectedGuids;
+    selectedGuids.SetCapacity (selNeigs.GetSize ());
+    for (const API_Neig& neig : selNeigs)
+        selectedGuids.Push (neig.guid);
+
+    // Сводный режим: для большого выделения считаем только ключи из заголовка элемента,
+    // ID и свойства откладываются до раскрытия группы (GetGroupDetails)
+    result.summary = (summaryThreshold > 0 && selectedGuids.GetSize () > summaryThreshold);
+    const UInt32 keyCount = static_cast<UInt32> (keys.GetSize () < MaxKeyCount ? keys.GetSize () : MaxKeyCount);
+    GS::Array<bool> resolve;
+    for (UInt32 k = 0; k < keyCount; ++k) {
+        const bool resolved = !(result.summary && IsPerElementKey (keys[k]));
+        resolve.Push (resolved);
+        result.keyResolved.Push (resolved);
+    }
+    if (result.summary)
+        withSums = false;
+
+    NameCache::BeginPass ();
+    Grouping grouping;
+    GroupElements (selectedGuids, keys, resolve, grouping);
+    const GS::Array<GroupTuple>&     groupTuples = grouping.groupTuples;
+    const GS::Array<UInt32>&         groupCounts = grouping.groupCounts;
+    const GS::Array<UInt32>&         elemGroups = grouping.elemGroups;
+    const GS::Array<API_Guid>&       elemGuids = grouping.elemGuids;
+    const GS::Array<API_ElemTypeID>& elemTypes = grouping.elemTypes;
+    const GS::Array<KeyValueTable>&  valueTables = grouping.valueTables;
+
+    // Раскладываем GUID по группам подряд (counting sort): один массив на весь снимок
+    const UInt32 groupCount = static_cast<UInt32> (groupTuples.GetSize ());
+    Snapshot snapshot;
+    snapshot.id = s_nextSnapshotId++;
+    snapshot.groupOffsets.SetCapacity (groupCount + 1);
+    UInt32 offset = 0;
+    for (UInt32 g = 0; g < groupCount; ++g) {
+        snapshot.groupOffsets.Push (offset);
+        offset += groupCounts[g];
+    }
+    snapshot.groupOffsets.Push (offset);
+
+    GS::Array<UInt32> cursor = snapshot.groupOffsets;
+    snapshot.guids.SetSize (elemGuids.GetSize ());
+    for (UIndex i = 0; i < elemGuids.GetSize (); ++i) {
+        snapshot.guids[cursor[elemGroups[i]]++] = elemGuids[i];
+    }
+
+    // Суммы площади и объёма — одним пакетным запросом количеств по всему выделению
+    GS::Array<double> groupAreas;
+    GS::Array<double> groupVolumes;
+    for (UInt32 g = 0; g < groupCount; ++g) {
+        groupAreas.Push (0.0);
+        groupVolumes.Push (0.0);
+    }
+    if (withSums && !elemGuids.IsEmpty ()) {
+        GS::Array<SelectionMetricsHelper::AreaVolume> values;
+        if (SelectionMetricsHelper::CollectAreaVolume (elemGuids, elemTypes, values) == NoError) {
+            for (UIndex i = 0; i < values.GetSize () && i < elemGroups.GetSize (); ++i) {
+                groupAreas[elemGroups[i]] += values[i].area;
+                groupVolumes[elemGroups[i]] += values[i].volume;
+            }
+            result.hasSums = true;
+        }
+    }
+
+    result.snapshotId = snapshot.id;
+    result.totalElements = static_cast<UInt32> (elemGuids.GetSize ());
+    result.rows.SetCapacity (groupCount);
+    for (UInt32 g = 0; g < groupCount; ++g) {
+        GroupRow row;
+        row.groupIndex = g;
+        row.count = groupCounts[g];
+        row.area = groupAreas[g];
+        row.volume = groupVolumes[g];
+        for (UInt32 k = 0; k < keyCount; ++k)
+            row.keyValues.Push (valueTables[k].Get (groupTuples[g].parts[k]));
+        result.rows.Push (row);
+    }
+    SortRows (result.rows, sortSpec);
+
+    s_snapshot = snapshot;
+    return result;
+}
+
+// ---------------- Отложенные ключи для элементов одной группы ----------------
+GS::Array<GroupRow> GetGroupDetails (UInt32 snapshotId, UInt32 groupIndex, const GS::Array<KeySpec>& keys)
+{
+    API_OPERATION ("grouping");
+    GS::Array<GroupRow> rows;
+    const GS::Array<API_Guid> guids = GetGroupGuids (snapshotId, groupIndex);
+    if (guids.IsEmpty () || keys.IsEmpty ())
+        return rows;
+
+    GS::Array<bool> resolve;
+    for (UIndex k = 0; k < keys.GetSize (); ++k)
+        resolve.Push (true);
+
+    NameCache::BeginPass ();
+    Grouping grouping;
+    GroupElements (guids, keys, resolve, grouping);
+
+    const UInt32 keyCount = static_cast<UInt32> (grouping.valueTables.GetSize ());
+    for (UIndex g = 0; g < grouping.groupTuples.GetSize (); ++g) {
+        GroupRow row;
+        row.groupIndex = static_cast<UInt32> (g);
+        row.count = grouping.groupCounts[g];
+        for (UInt32 k = 0; k < keyCount; ++k)
+            row.keyValues.Push (grouping.valueTables[k].Get (grouping.groupTuples[g].parts[k]));
+        rows.Push (row);
+    }
+
+    SortSpec byKey;
+    byKey.column = SortColumn::Key;
+    byKey.keyIndex = 0;
+    SortRows (rows, byKey);
+    return rows;
+}
+
+// ---------------- GUID элементов группы ----------------
+GS::Array<API_Guid> GetGroupGuids (UInt32 snapshotId, UInt32 groupIndex)
+{
+    GS::Array<API_Guid> guids;
+    if (snapshotId != s_snapshot.id || groupIndex + 1 >= s_snapshot.groupOffsets.GetSize ())
+        return guids;
+
+    const UInt32 begin = s_snapshot.groupOffsets[groupIndex];
+    const UInt32 end = s_snapshot.groupOffsets[groupIndex + 1];
+    guids.SetCapacity (end - begin);
+    for (UInt32 i = begin; i < end; ++i)
+        guids.Push (s_snapshot.guids[i]);
+    return guids;
+}
+
+} // namespace SelectionGroupHelper
@@ -0,0 +1,68 @@
+#ifndef SELECTIONGROUPHELPER_HPP
+#define SELECTIONGROUPHELPER_HPP
+
+#include "APIEnvir.h"
+#include "ACAPinc.h"
+#include "GSRoot.hpp"
+
+namespace SelectionGroupHelper {
+
+    // Поле, по которому группируются выделенные элементы
+    enum class KeyKind { Type, ID, Layer, Story, Property };
+
+    struct KeySpec {
+        KeyKind  kind = KeyKind::Type;
+        API_Guid propertyGuid = APINULLGuid;  // только для KeyKind::Property
+    };
+
+    // Колонка сортировки: один из ключей группировки либо числовая колонка
+    enum class SortColumn { None, Key, Count, Area, Volume };
+
+    struct SortSpec {
+        SortColumn column = SortColumn::None;
+        UIndex     keyIndex = 0;     // индекс в массиве ключей (для SortColumn::Key)
+        bool       ascending = true;
+    };
+
+    // Строка таблицы: значения ключей, количество и суммы по группе
+    struct GroupRow {
+        UInt32                   groupIndex = 0;  // индекс группы в снимке (для ленивой выдачи GUID)
+        GS::Array<GS::UniString> keyValues;
+        UInt32                   count = 0;
+        double                   area = 0.0;
+        double                   volume = 0.0;
+    };
+
+    struct GroupsResult {
+        UInt32              snapshotId = 0;     // идентификатор снимка выделения
+        UInt32              totalElements = 0;
+        bool                hasSums = false;
+        bool                summary = false;    // сводный режим: ID и свойства не запрашивались
+        GS::Array<bool>     keyResolved;        // false — значения ключа отложены до раскрытия группы
+        GS::Array<GroupRow> rows;
+    };
+
+    // Порог сводного режима по умолчанию (число выделенных элементов)
+    const UInt32 DefaultSummaryThreshold = 5000;
+
+    // Сгруппировать текущее выделение по ключам (хеш-группировка на стороне C++).
+    // Если элементов больше summaryThreshold (0 — без ограничения), группировка идёт
+    // только по данным заголовка (тип, слой, этаж), без ID, свойств и сумм.
+    GroupsResult GetSelectionGroups (const GS::Array<KeySpec>& keys, const SortSpec& sortSpec, bool withSums,
+                                     UInt32 summaryThreshold = DefaultSummaryThreshold);
+
+    // Разбивка одной группы снимка по отложенным ключам (ID, свойства) — для раскрытой строки
+    GS::Array<GroupRow> GetGroupDetails (UInt32 snapshotId, UInt32 groupIndex, const GS::Array<KeySpec>& keys);
+
+    // GUID элементов группы из последнего снимка; пустой массив, если снимок устарел
+    GS::Array<API_Guid> GetGroupGuids (UInt32 snapshotId, UInt32 groupIndex);
+
+    // Разбор ключа из палитры: "type", "id", "layer", "story", "property:<guid>"
+    bool ParseKeySpec (const GS::UniString& str, KeySpec& spec);
+
+    // Разбор колонки сортировки: имя ключа из keys, "count", "area" или "volume"
+    SortSpec ParseSortSpec (const GS::UniString& column, const GS::UniString& direction, const GS::Array<GS::UniString>& keyNames);
+
+} // namespace SelectionGroupHelper
+
+#endif // SELECTIONGROUPHELPER_HPP
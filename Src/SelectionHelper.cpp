@@ -1,60 +1,69 @@
 #include "SelectionHelper.hpp"
+#include "GuidCodec.hpp"
+#include "ApiProfiler.hpp"
+
+#include <utility>
 
 namespace SelectionHelper {
 
 // ---------------- Получить список выделенных элементов ----------------
-GS::Array<ElementInfo> GetSelectedElements ()
+SelectedElements GetSelectedElements ()
 {
     API_SelectionInfo selectionInfo = {};
     GS::Array<API_Neig> selNeigs;
-    ACAPI_Selection_Get(&selectionInfo, &selNeigs, false, false);
+    API_CALL(ACAPI_Selection_Get, &selectionInfo, &selNeigs, false, false);
     BMKillHandle((GSHandle*)&selectionInfo.marquee.coords);
 
-    GS::Array<ElementInfo> selectedElements;
+    SelectedElements selected;
+    selected.records.SetCapacity(selNeigs.GetSize());
+    selected.elemIDs.SetCapacity(selNeigs.GetSize() + 1);
+    selected.elemIDs.Push(GS::UniString());
+
+    // Имена типов и слоёв берутся из общего кеша: API вызывается один раз на уникальное имя
+    NameCache::BeginPass();
 
     for (const API_Neig& neig : selNeigs) {
         API_Elem_Head elemHead = {};
         elemHead.guid = neig.guid;
-        if (ACAPI_Element_GetHeader(&elemHead) != NoError)
+        if (API_CALL(ACAPI_Element_GetHeader, &elemHead) != NoError)
             continue;
 
-        ElementInfo elemInfo;
-        elemInfo.guidStr = APIGuidToString(elemHead.guid);
-
-        GS::UniString typeName;
-        if (ACAPI_Element_GetElemTypeName(elemHead.type, typeName) == NoError)
-            elemInfo.typeName = typeName;
+        ElementRecord record;
+        record.guid = elemHead.guid;
+        record.typeName = NameCache::GetTypeName(elemHead.type);
+        record.layerName = NameCache::GetLayerName(elemHead.layer);
 
         GS::UniString elemID;
-        if (ACAPI_Element_GetElementInfoString(&elemHead.guid, &elemID) == NoError)
-            elemInfo.elemID = elemID;
-
-        // Получить информацию о слое
-        API_Attribute layerAttr = {};
-        layerAttr.header.typeID = API_LayerID;
-        layerAttr.header.index = elemHead.layer;
-        if (ACAPI_Attribute_Get(&layerAttr) == NoError) {
-            elemInfo.layerName = layerAttr.header.name;
+        if (API_CALL(ACAPI_Element_GetElementInfoString, &elemHead.guid, &elemID) == NoError && !elemID.IsEmpty()) {
+            // ID почти всегда уникальны — поиск повторов стоил бы дороже, чем лишняя строка
+            record.elemID = static_cast<UInt32>(selected.elemIDs.GetSize());
+            selected.elemIDs.Push(std::move(elemID));
         }
 
-        selectedElements.Push(elemInfo);
+        selected.records.Push(record);
     }
 
-    return selectedElements;
+    return selected;
 }
 
 // ---------------- Изменить выделение ----------------
 void ModifySelection (const GS::UniString& elemGuidStr, SelectionModification modification)
 {
-    API_Guid guid = APIGuidFromString(elemGuidStr.ToCStr().Get());
-    if (guid == APINULLGuid)
+    // Строка GUID или упакованный блок из нескольких GUID (GuidCodec)
+    GS::Array<API_Guid> guids;
+    GuidCodec::AppendGuids(elemGuidStr, guids);
+    if (guids.IsEmpty())
         return;
 
-    API_Neig neig(guid);
+    GS::Array<API_Neig> neigs;
+    neigs.SetCapacity(guids.GetSize());
+    for (const API_Guid& guid : guids)
+        neigs.Push(API_Neig(guid));
+
     if (modification == AddToSelection) {
-        ACAPI_Selection_Select({ neig }, true);   // добавить
+        API_CALL(ACAPI_Selection_Select, neigs, true);   // добавить
     } else {
-        ACAPI_Selection_Select({ neig }, false);  // убрать
+        API_CALL(ACAPI_Selection_Select, neigs, false);  // убрать
     }
 }
 
@@ -65,7 +74,7 @@ bool ChangeSelectedElementsID (const GS::UniString& baseID)
 
     API_SelectionInfo selectionInfo = {};
     GS::Array<API_Neig> selNeigs;
-    ACAPI_Selection_Get(&selectionInfo, &selNeigs, false, false);
+    API_CALL(ACAPI_Selection_Get, &selectionInfo, &selNeigs, false, false);
     BMKillHandle((GSHandle*)&selectionInfo.marquee.coords);
 
     if (selNeigs.IsEmpty()) return false;
@@ -77,7 +86,7 @@ bool ChangeSelectedElementsID (const GS::UniString& baseID)
             GS::UniString newID = baseID;
 
             // Изменяем ID элемента с помощью правильной функции API
-            if (ACAPI_Element_ChangeElementInfoString(&selNeigs[i].guid, &newID) != NoError) {
+            if (API_CALL(ACAPI_Element_ChangeElementInfoString, &selNeigs[i].guid, &newID) != NoError) {
                 // Если не удалось изменить ID, пропускаем элемент
                 continue;
             }
@@ -102,12 +111,12 @@ ApplyCheckedSelectionResult ApplyCheckedSelection (const GS::Array<API_Guid>& gu
     // Очищаем текущее выделение: получаем все выделенные элементы и удаляем их
     API_SelectionInfo selectionInfo = {};
     GS::Array<API_Neig> selNeigs;
-    ACAPI_Selection_Get(&selectionInfo, &selNeigs, false, false);
+    API_CALL(ACAPI_Selection_Get, &selectionInfo, &selNeigs, false, false);
     BMKillHandle((GSHandle*)&selectionInfo.marquee.coords);
     
     // Удаляем все текущие выделенные элементы
     if (!selNeigs.IsEmpty()) {
-        ACAPI_Selection_Select(selNeigs, false);
+        API_CALL(ACAPI_Selection_Select, selNeigs, false);
     }
 
     // Преобразуем GUID в API_Neig и собираем в массив
@@ -118,7 +127,7 @@ ApplyCheckedSelectionResult ApplyCheckedSelection (const GS::Array<API_Guid>& gu
         // Проверяем, существует ли элемент
         API_Elem_Head elemHead = {};
         elemHead.guid = guids[i];
-        if (ACAPI_Element_GetHeader(&elemHead) == NoError) {
+        if (API_CALL(ACAPI_Element_GetHeader, &elemHead) == NoError) {
             neigs.Push(neig);
         }
     }
@@ -128,7 +137,7 @@ ApplyCheckedSelectionResult ApplyCheckedSelection (const GS::Array<API_Guid>& gu
     }
 
     // Выделяем все элементы одним батчем
-    ACAPI_Selection_Select(neigs, true);
+    API_CALL(ACAPI_Selection_Select, neigs, true);
     result.applied = static_cast<UInt32>(neigs.GetSize());
 
     return result;
@@ -148,7 +157,7 @@ UpdateElementsIdResult UpdateElementsID (const GS::Array<API_Guid>& guids, const
     GSErrCode err = ACAPI_CallUndoableCommand("Change Elements ID", [&]() -> GSErrCode {
         for (UIndex i = 0; i < guids.GetSize(); ++i) {
             GS::UniString id = newID;
-            if (ACAPI_Element_ChangeElementInfoString(&guids[i], &id) == NoError) {
+            if (API_CALL(ACAPI_Element_ChangeElementInfoString, &guids[i], &id) == NoError) {
                 result.updated++;
             }
         }
@@ -4,22 +4,35 @@
 #include "APIEnvir.h"
 #include "ACAPinc.h"
 #include "GSRoot.hpp"
+#include "NameCache.hpp"
 
 namespace SelectionHelper {
 
     enum SelectionModification { RemoveFromSelection, AddToSelection };
 
-    struct ElementInfo {
-        GS::UniString guidStr;   // GUID элемента в строковом виде
-        GS::UniString typeName;  // Человекочитаемое имя типа (Объект, Лампа, Колонна...)
-        GS::UniString elemID;    // Имя/ID из Archicad
-        GS::UniString layerName; // Имя слоя элемента
+    // Компактная запись о выделенном элементе (28 байт). Имена типов и слоёв хранятся один раз
+    // в NameCache; ID элементов почти все разные, поэтому они живут в таблице запроса
+    // (SelectedElements::elemIDs), а не в общем пуле. В текст (в т.ч. GUID) запись переводится
+    // только на границе JS-моста
+    struct ElementRecord {
+        API_Guid              guid = APINULLGuid;
+        NameCache::NameHandle typeName = NameCache::EmptyName;   // Человекочитаемое имя типа (Объект, Лампа, Колонна...)
+        NameCache::NameHandle layerName = NameCache::EmptyName;  // Имя слоя элемента
+        UInt32                elemID = 0;                        // Индекс ID в SelectedElements::elemIDs (0 — пустой)
     };
 
-    // Получить список выделенных элементов
-    GS::Array<ElementInfo> GetSelectedElements ();
+    // Выделение: записи и таблица ID этого запроса (освобождается вместе с результатом)
+    struct SelectedElements {
+        GS::Array<ElementRecord>  records;
+        GS::Array<GS::UniString>  elemIDs;
 
-    // Добавить или удалить элемент по GUID
+        const GS::UniString& GetElemID (const ElementRecord& record) const { return elemIDs[record.elemID]; }
+    };
+
+    // Получить список выделенных элементов (непрерывный массив записей)
+    SelectedElements GetSelectedElements ();
+
+    // Добавить или удалить элемент по GUID (строка GUID или упакованный блок GuidCodec)
     void ModifySelection (const GS::UniString& elemGuidStr, SelectionModification modification);
 
     // Изменить ID всех выделенных элементов
@@ -1,6 +1,19 @@
 #include "SelectionMetricsHelper.hpp"
-
+#include "NameCache.hpp"
+#include "ApiProfiler.hpp"
+#include "TraceLog.hpp"
+#include "LayerVolumes.hpp"
+#include "HashTable.hpp"
+#include "Logger.hpp"
+#include "MetricsCache.hpp"
+#include "QuantityDescriptors.hpp"
+#include "SeoLinks.hpp"
+
+#include <algorithm>
+#include <chrono>
 #include <cmath>
+#include <iterator>
+#include <vector>
 
 namespace {
 
@@ -8,7 +21,7 @@ API_Guid GetFirstSelectedGuid()
 {
 	API_SelectionInfo selectionInfo = {};
 	GS::Array<API_Neig> selNeigs;
-	if (ACAPI_Selection_Get(&selectionInfo, &selNeigs, false, false) == NoError && !selNeigs.IsEmpty()) {
+	if (API_CALL(ACAPI_Selection_Get, &selectionInfo, &selNeigs, false, false) == NoError && !selNeigs.IsEmpty()) {
 		const API_Guid guid = selNeigs[0].guid;
 		BMKillHandle(reinterpret_cast<GSHandle*>(&selectionInfo.marquee.coords));
 		return guid;
@@ -26,212 +39,181 @@ struct QuantitySnapshot {
 	bool	hasTotalSurface = false;
 	bool	hasVolume = false;
 
-	struct LayerComp {
-		API_AttributeIndex	buildMatIndex = APIInvalidAttributeIndex;
-		double				area = 0.0;
-		double				volume = 0.0;
-	};
+	std::vector<LayerVolumes::Component>	layerComps;		// послойные данные (для многослойных конструкций)
+
+	bool Has(QuantityDescriptors::Quantity quantity) const
+	{
+		return (quantity == QuantityDescriptors::TopSurface) ? hasTopSurface
+			: (quantity == QuantityDescriptors::TotalSurface) ? hasTotalSurface
+			: hasVolume;
+	}
 
-	GS::Array<LayerComp>	layerComps;		// послойные данные (для многослойных конструкций)
-	bool					hasLayerComps = false;
+	double Get(QuantityDescriptors::Quantity quantity) const
+	{
+		return (quantity == QuantityDescriptors::TopSurface) ? topSurface
+			: (quantity == QuantityDescriptors::TotalSurface) ? totalSurface
+			: volume;
+	}
 };
 
-static GSErrCode GetQuantities(const API_Element& element, QuantitySnapshot& snapshot)
-{
-	API_ElementQuantity quantity = {};
+// Запрашиваем количества порциями: один вызов API на порцию вместо вызова на элемент
+const UIndex QuantityChunkSize = 2000;
 
-	GS::Array<API_CompositeQuantity>			composites;
-	GS::Array<API_ElemPartQuantity>			elemPartQuantities;
-	GS::Array<API_ElemPartCompositeQuantity>	elemPartComposites;
+// Значения берутся из полей, заданных для типа в QuantityDescriptors::TypeTable
+static QuantitySnapshot ToSnapshot(API_ElemTypeID typeID, const API_ElementQuantity& quantity,
+	const GS::Array<API_CompositeQuantity>& composites)
+{
+	QuantitySnapshot snapshot;
+	if (const QuantityDescriptors::TypeDescriptor* descriptor = QuantityDescriptors::Find(typeID)) {
+		snapshot.hasTopSurface = (descriptor->topSurface.read != nullptr);
+		snapshot.hasTotalSurface = (descriptor->totalSurface.read != nullptr);
+		snapshot.hasVolume = (descriptor->volume.read != nullptr);
+		snapshot.topSurface = snapshot.hasTopSurface ? descriptor->topSurface.read(quantity) : 0.0;
+		snapshot.totalSurface = snapshot.hasTotalSurface ? descriptor->totalSurface.read(quantity) : 0.0;
+		snapshot.volume = snapshot.hasVolume ? descriptor->volume.read(quantity) : 0.0;
+	}
 
-	GS::Array<API_Quantities> quantities;
-	GS::Array<API_Guid>		elemGuids;
+	// послойные значения (для многослойных конструкций)
+	snapshot.layerComps.reserve(composites.GetSize());
+	for (const API_CompositeQuantity& comp : composites) {
+		LayerVolumes::Component layer;
+		layer.material = comp.buildMatIndices.ToInt32_Deprecated();
+		layer.volume = comp.volumes;
+		snapshot.layerComps.push_back(layer);
+	}
+	return snapshot;
+}
 
-	quantities.Push(API_Quantities());
-	quantities[0].elements = &quantity;
-	quantities[0].composites = &composites;
-	quantities[0].elemPartQuantities = &elemPartQuantities;
-	quantities[0].elemPartComposites = &elemPartComposites;
-	elemGuids.Push(element.header.guid);
+// Пакетный запрос количеств: snapshots[i] соответствует guids[i]. Маска — только под величины
+// quantities (QuantityDescriptors::Quantity), composites запрашиваются, лишь если нужны послойные объёмы
+static GSErrCode GetQuantitiesBatch(const GS::Array<API_Guid>& guids, const GS::Array<API_ElemTypeID>& types,
+	UInt32 quantities, GS::Array<QuantitySnapshot>& snapshots)
+{
+	TRACE_SPAN("quantities batch", "metrics");
+	snapshots.Clear();
+	snapshots.SetCapacity(guids.GetSize());
 
 	API_QuantityPar params = {};
 	params.minOpeningSize = 0.0;	// минимальный размер отверстий (0 = без отсечения)
 
 	API_QuantitiesMask mask;
-	ACAPI_ELEMENT_QUANTITIES_MASK_SETFULL(mask);
-
-	GSErrCode err = ACAPI_Element_GetMoreQuantities(&elemGuids, &params, &quantities, &mask);
-	if (err != NoError) {
-		return err;
+	if (!QuantityDescriptors::BuildMask(types, quantities, mask)) {
+		for (UIndex i = 0; i < guids.GetSize(); ++i) {
+			snapshots.Push(QuantitySnapshot());
+		}
+		return NoError;
 	}
+	const bool withComposites = QuantityDescriptors::NeedsComposites(types, quantities);
+
+	for (UIndex chunkStart = 0; chunkStart < guids.GetSize(); chunkStart += QuantityChunkSize) {
+		const UIndex chunkEnd = (chunkStart + QuantityChunkSize < guids.GetSize()) ? chunkStart + QuantityChunkSize : guids.GetSize();
+
+		GS::Array<API_Guid>							chunkGuids;
+		GS::Array<API_ElementQuantity>				elementQuantities;
+		GS::Array<GS::Array<API_CompositeQuantity>>	composites;
+		GS::Array<API_Quantities>					chunkQuantities;
+		chunkGuids.SetCapacity(chunkEnd - chunkStart);
+		for (UIndex i = chunkStart; i < chunkEnd; ++i) {
+			chunkGuids.Push(guids[i]);
+			elementQuantities.Push(API_ElementQuantity());
+			composites.Push(GS::Array<API_CompositeQuantity>());
+		}
+		// указатели берём после заполнения массивов, чтобы они не сместились при росте
+		for (UIndex i = 0; i < chunkGuids.GetSize(); ++i) {
+			API_Quantities q = {};
+			q.elements = &elementQuantities[i];
+			q.composites = withComposites ? &composites[i] : nullptr;
+			chunkQuantities.Push(q);
+		}
 
-	switch (element.header.type.typeID) {
-	case API_MeshID:
-		snapshot.topSurface = quantity.mesh.topSurface;
-		snapshot.totalSurface = quantity.mesh.bottomSurface;
-		snapshot.volume = quantity.mesh.volume;
-		snapshot.hasTopSurface = true;
-		snapshot.hasTotalSurface = true;
-		snapshot.hasVolume = true;
-		break;
-	case API_SlabID:
-		snapshot.topSurface = quantity.slab.topSurface;
-		snapshot.totalSurface = quantity.slab.bottomSurface;
-		snapshot.volume = quantity.slab.volume;
-		snapshot.hasTopSurface = true;
-		snapshot.hasTotalSurface = true;
-		snapshot.hasVolume = true;
-		break;
-	case API_RoofID:
-		snapshot.topSurface = quantity.roof.topSurface;
-		snapshot.totalSurface = quantity.roof.bottomSurface;
-		snapshot.volume = quantity.roof.volume;
-		snapshot.hasTopSurface = true;
-		snapshot.hasTotalSurface = true;
-		snapshot.hasVolume = true;
-		break;
-	case API_ShellID:
-		snapshot.topSurface = quantity.shell.referenceSurface;
-		snapshot.totalSurface = quantity.shell.oppositeSurface;
-		snapshot.volume = quantity.shell.volume;
-		snapshot.hasTopSurface = true;
-		snapshot.hasTotalSurface = true;
-		snapshot.hasVolume = true;
-		break;
-	case API_MorphID:
-		snapshot.topSurface = quantity.morph.surface;
-		snapshot.totalSurface = quantity.morph.surface;
-		snapshot.volume = quantity.morph.volume;
-		snapshot.hasTopSurface = true;
-		snapshot.hasTotalSurface = true;
-		snapshot.hasVolume = true;
-		break;
-	default:
-		break;
-	}
+		GSErrCode err = API_CALL(ACAPI_Element_GetMoreQuantities, &chunkGuids, &params, &chunkQuantities, &mask);
+		if (err != NoError) {
+			return err;
+		}
 
-	// послойные значения (для многослойных конструкций)
-	for (const API_CompositeQuantity& comp : composites) {
-		QuantitySnapshot::LayerComp layer;
-		layer.buildMatIndex = comp.buildMatIndices;
-		layer.area = comp.projectedArea;
-		layer.volume = comp.volumes;
-		snapshot.layerComps.Push(layer);
+		for (UIndex i = 0; i < chunkGuids.GetSize(); ++i) {
+			const API_ElemTypeID typeID = (chunkStart + i < types.GetSize()) ? types[chunkStart + i] : API_ZombieElemID;
+			snapshots.Push(ToSnapshot(typeID, elementQuantities[i], composites[i]));
+		}
 	}
-	snapshot.hasLayerComps = !snapshot.layerComps.IsEmpty();
 
 	return NoError;
 }
 
-static void AppendMetric(GS::Array<SelectionMetricsHelper::Metric>& dest, const GS::UniString& key,
-	const GS::UniString& name, double grossValue, double netValue)
+static double DiffWithoutNoise(double grossValue, double netValue)
 {
 	// Порог отсечения шума: около 0.0005 м³ (третьего знака)
 	const double eps = 0.0005;
 
+	const double rawDiff = std::fabs(grossValue - netValue);
+	return (rawDiff < eps) ? 0.0 : rawDiff;
+}
+
+static void AppendMetric(GS::Array<SelectionMetricsHelper::Metric>& dest, const GS::UniString& key,
+	const GS::UniString& name, double grossValue, double netValue)
+{
 	SelectionMetricsHelper::Metric metric;
 	metric.key = key;
 	metric.name = name;
 	metric.grossValue = grossValue;
 	metric.netValue = netValue;
-	const double rawDiff = std::fabs(grossValue - netValue);
-	metric.diffValue = (rawDiff < eps) ? 0.0 : rawDiff;
+	metric.diffValue = DiffWithoutNoise(grossValue, netValue);
 	dest.Push(metric);
 }
 
+// Ключ и подпись послойной метрики; строятся один раз на материал, пока его имя не изменилось
+struct LayerMetricLabel {
+	NameCache::NameHandle	materialName = NameCache::EmptyName;
+	GS::UniString			key;
+	GS::UniString			name;
+};
+
+static const LayerMetricLabel& GetLayerMetricLabel(Int32 material)
+{
+	static GS::HashTable<Int32, LayerMetricLabel> labels;
+
+	const NameCache::NameHandle matHandle = NameCache::GetBuildingMaterialName(ACAPI_CreateAttributeIndex(material));
+	const LayerMetricLabel* label = labels.GetPtr(material);
+	if (label != nullptr && label->materialName == matHandle) {
+		return *label;
+	}
+
+	LayerMetricLabel fresh;
+	fresh.materialName = matHandle;
+	// По слоям считаем только объёмы (площади оставляем на уровне всего элемента)
+	fresh.key = GS::UniString::Printf("layer_%d_volume", (int)material);
+	fresh.name = "Слой ";
+	if (matHandle != NameCache::EmptyName) {
+		fresh.name.Append(NameCache::GetString(matHandle));
+	} else {
+		fresh.name.Append("Материал ");
+		fresh.name.Append(GS::UniString::Printf("#%d", (int)material));
+	}
+	fresh.name.Append(" – Объем");
+	labels.Put(material, fresh);
+	return *labels.GetPtr(material);
+}
+
 // Добавить метрики по слоям (для многослойных конструкций)
 static void AppendLayerMetrics(GS::Array<SelectionMetricsHelper::Metric>& dest,
 	const QuantitySnapshot& grossSnapshot,
 	const QuantitySnapshot& netSnapshot)
 {
-	if (!grossSnapshot.hasLayerComps && !netSnapshot.hasLayerComps) {
+	if (grossSnapshot.layerComps.empty() && netSnapshot.layerComps.empty()) {
 		return;
 	}
 
-	GS::Array<API_AttributeIndex> allIndices;
-	auto addIndex = [&allIndices](API_AttributeIndex idx) {
-		if (!idx.IsPositive()) {
-			return;
-		}
-		for (UIndex i = 0; i < allIndices.GetSize(); ++i) {
-			if (allIndices[i] == idx) {
-				return;
-			}
-		}
-		allIndices.Push(idx);
-	};
-
-	for (const auto& lc : grossSnapshot.layerComps) {
-		addIndex(lc.buildMatIndex);
-	}
-	for (const auto& lc : netSnapshot.layerComps) {
-		addIndex(lc.buildMatIndex);
-	}
-
-	// Сначала посчитаем суммарные "сырые" объёмы по всем слоям
-	double grossRawTotal = 0.0;
-	double netRawTotal = 0.0;
-	for (const auto& lc : grossSnapshot.layerComps) {
-		grossRawTotal += lc.volume;
-	}
-	for (const auto& lc : netSnapshot.layerComps) {
-		netRawTotal += lc.volume;
-	}
-
-	for (API_AttributeIndex idx : allIndices) {
-		double grossRaw = 0.0;
-		double netRaw = 0.0;
-
-		for (const auto& lc : grossSnapshot.layerComps) {
-			if (lc.buildMatIndex == idx) {
-				grossRaw += lc.volume;
-			}
-		}
-		for (const auto& lc : netSnapshot.layerComps) {
-			if (lc.buildMatIndex == idx) {
-				netRaw += lc.volume;
-			}
-		}
-
-		// Нормализуем послойные объёмы так, чтобы их сумма совпадала
-		// с общим объёмом элемента (до/после SEO)
-		double grossVolume = grossRaw;
-		double netVolume = netRaw;
-
-		if (grossRawTotal > 0.0 && grossSnapshot.hasVolume && grossSnapshot.volume > 0.0) {
-			const double k = grossSnapshot.volume / grossRawTotal;
-			grossVolume = grossRaw * k;
-		}
-		if (netRawTotal > 0.0 && netSnapshot.hasVolume && netSnapshot.volume > 0.0) {
-			const double k = netSnapshot.volume / netRawTotal;
-			netVolume = netRaw * k;
-		}
-
-		if (grossVolume == 0.0 && netVolume == 0.0) {
-			continue;
-		}
-
-		API_Attribute attr = {};
-		attr.header.typeID = API_BuildingMaterialID;
-		attr.header.index = idx;
-		GS::UniString matName("Материал ");
-		matName.Append(GS::UniString::Printf("#%d", (int)idx.ToInt32_Deprecated()));
-		if (ACAPI_Attribute_Get(&attr) == NoError) {
-			matName = attr.header.name;
-		}
-
-		GS::UniString keyBase = GS::UniString::Printf("layer_%d_", (int)idx.ToInt32_Deprecated());
+	// Распределение объёмов по материалам — Src/Core/LayerVolumes; накопитель общий на проход,
+	// его таблица не перевыделяется от элемента к элементу
+	static LayerVolumes::Aggregator aggregator;
+	aggregator.Reset();
+	aggregator.Add(grossSnapshot.layerComps, grossSnapshot.hasVolume ? grossSnapshot.volume : 0.0,
+		netSnapshot.layerComps, netSnapshot.hasVolume ? netSnapshot.volume : 0.0);
 
-		// По слоям считаем только объёмы (площади оставляем на уровне всего элемента)
-		if (grossVolume != 0.0 || netVolume != 0.0) {
-			GS::UniString key = keyBase;
-			key.Append("volume");
-			GS::UniString name("Слой ");
-			name.Append(matName);
-			name.Append(" – Объем");
-			AppendMetric(dest, key, name, grossVolume, netVolume);
-		}
-	}
+	aggregator.ForEach([&](const LayerVolumes::MaterialVolume& volume) {
+		const LayerMetricLabel& label = GetLayerMetricLabel(volume.material);
+		AppendMetric(dest, label.key, label.name, volume.grossVolume, volume.netVolume);
+	});
 }
 
 static GSErrCode DetachSeoLinks(const API_Guid& guid)
@@ -241,7 +223,7 @@ static GSErrCode DetachSeoLinks(const API_Guid& guid)
 	}
 
 	GS::Array<API_Guid> operators;
-	GSErrCode err = ACAPI_Element_SolidLink_GetOperators(guid, &operators);
+	GSErrCode err = API_CALL(ACAPI_Element_SolidLink_GetOperators, guid, &operators);
 	if (err == APIERR_NO3D) {
 		return NoError;
 	}
@@ -250,131 +232,632 @@ static GSErrCode DetachSeoLinks(const API_Guid& guid)
 	}
 
 	for (const API_Guid& oper : operators) {
-		ACAPI_Element_SolidLink_Remove(guid, oper);
+		API_CALL(ACAPI_Element_SolidLink_Remove, guid, oper);
 	}
 	return NoError;
 }
 
-class TemporaryElementCopy {
+// Временные копии элементов для расчёта без SEO; удаляются все одним вызовом
+class TemporaryElementCopies {
 public:
-	explicit TemporaryElementCopy(const API_Element& sourceElement)
-		: m_sourceElement(sourceElement)
-	{
-	}
+	TemporaryElementCopies() = default;
+	TemporaryElementCopies(const TemporaryElementCopies&) = delete;
+	TemporaryElementCopies& operator=(const TemporaryElementCopies&) = delete;
 
-	GSErrCode Create()
+	GSErrCode Add(const API_Element& sourceElement, API_Guid& copyGuid)
 	{
-		if (m_sourceElement.header.guid == APINULLGuid) {
+		copyGuid = APINULLGuid;
+		if (sourceElement.header.guid == APINULLGuid) {
 			return APIERR_BADGUID;
 		}
 
 		API_ElementMemo memo = {};
-		GSErrCode memoErr = ACAPI_Element_GetMemo(m_sourceElement.header.guid, &memo);
+		GSErrCode memoErr = API_CALL(ACAPI_Element_GetMemo, sourceElement.header.guid, &memo);
 		if (memoErr != NoError && memoErr != APIERR_BADID) {
 			return memoErr;
 		}
 
-		API_Element copyElement = m_sourceElement;
+		API_Element copyElement = sourceElement;
 		copyElement.header.guid = APINULLGuid;
 
-		GSErrCode createErr = ACAPI_Element_Create(&copyElement, (memoErr == NoError) ? &memo : nullptr);
+		GSErrCode createErr = API_CALL(ACAPI_Element_Create, &copyElement, (memoErr == NoError) ? &memo : nullptr);
 		ACAPI_DisposeElemMemoHdls(&memo);
 		if (createErr != NoError) {
 			return createErr;
 		}
 
-		m_copyGuid = copyElement.header.guid;
-		DetachSeoLinks(m_copyGuid);
+		copyGuid = copyElement.header.guid;
+		m_copyGuids.Push(copyGuid);
 		return NoError;
 	}
 
+	// Снять SEO-связи со всех созданных копий (API удаляет связи только по одной паре)
+	void DetachAllSeoLinks()
+	{
+		for (const API_Guid& copyGuid : m_copyGuids) {
+			DetachSeoLinks(copyGuid);
+		}
+	}
+
 	GSErrCode Destroy()
 	{
-		if (m_copyGuid == APINULLGuid) {
+		if (m_copyGuids.IsEmpty()) {
 			return NoError;
 		}
-		GS::Array<API_Guid> guids;
-		guids.Push(m_copyGuid);
-		GSErrCode deleteErr = ACAPI_Element_Delete(guids);
-		m_copyGuid = APINULLGuid;
+		GSErrCode deleteErr = API_CALL(ACAPI_Element_Delete, m_copyGuids);
+		m_copyGuids.Clear();
 		return deleteErr;
 	}
 
-	API_Guid GetGuid() const { return m_copyGuid; }
-
-	~TemporaryElementCopy()
+	~TemporaryElementCopies()
 	{
 		Destroy();
 	}
 
 private:
-	API_Element	m_sourceElement = {};
-	API_Guid	m_copyGuid = APINULLGuid;
+	GS::Array<API_Guid>	m_copyGuids;
 };
 
-static GSErrCode GetGrossQuantitiesViaCopy(const API_Element& sourceElement, QuantitySnapshot& snapshot)
+// gross — количества копий без SEO в одной undo-команде, по фазам: создать все копии,
+// снять связи со всех, один пакетный запрос количеств, одно удаление.
+// grossMeasured[i] — gross элемента действительно снят с копии; где копию создать или измерить
+// не удалось, в grossSnapshots остаётся net, но это не результат, а неизвестность
+static bool s_creatingTemporaryCopies = false;
+static bool s_insideCallerCommand = false;	// RunInOneUndoStep: копии — в команде вызывающего
+
+static GSErrCode GetGrossQuantitiesViaCopies(const GS::Array<API_Element>& elements,
+	const GS::Array<QuantitySnapshot>& netSnapshots, GS::Array<QuantitySnapshot>& grossSnapshots,
+	GS::Array<bool>& grossMeasured)
 {
-	return ACAPI_CallUndoableCommand("SelectionMetrics_TemporaryCopy", [&]() -> GSErrCode {
-		TemporaryElementCopy tempCopy(sourceElement);
-		GSErrCode createErr = tempCopy.Create();
-		if (createErr != NoError) {
-			return createErr;
+	grossSnapshots = netSnapshots;
+	grossMeasured.Clear();
+	grossMeasured.SetCapacity(elements.GetSize());
+	for (UIndex i = 0; i < elements.GetSize(); ++i) {
+		grossMeasured.Push(false);
+	}
+	const bool wasCreating = s_creatingTemporaryCopies;
+	s_creatingTemporaryCopies = true;
+	const auto computeGross = [&]() -> GSErrCode {
+		TRACE_SPAN("undo: temporary copies", "undo");
+		TemporaryElementCopies copies;
+		GS::Array<API_Guid>			copyGuids;
+		GS::Array<API_ElemTypeID>	copyTypes;
+		GS::Array<UIndex>			sourceIndices;
+		{
+			TRACE_SPAN("create copies", "metrics");
+			for (UIndex i = 0; i < elements.GetSize(); ++i) {
+				API_Guid copyGuid;
+				if (copies.Add(elements[i], copyGuid) == NoError) {
+					copyGuids.Push(copyGuid);
+					copyTypes.Push(elements[i].header.type.typeID);
+					sourceIndices.Push(i);
+				}
+			}
+		}
+		if (copyGuids.IsEmpty()) {
+			return APIERR_GENERAL;
+		}
+		{
+			TRACE_SPAN("detach SEO links", "metrics");
+			copies.DetachAllSeoLinks();
 		}
 
-		API_Element copyElement = sourceElement;
-		copyElement.header.guid = tempCopy.GetGuid();
-
-		GSErrCode qtyErr = GetQuantities(copyElement, snapshot);
-		GSErrCode destroyErr = tempCopy.Destroy();
+		GS::Array<QuantitySnapshot> copySnapshots;
+		GSErrCode qtyErr = GetQuantitiesBatch(copyGuids, copyTypes, QuantityDescriptors::AllQuantities, copySnapshots);
+		GSErrCode destroyErr;
+		{
+			TRACE_SPAN("delete copies", "metrics");
+			destroyErr = copies.Destroy();
+		}
 		if (destroyErr != NoError) {
 			return destroyErr;
 		}
+		if (qtyErr == NoError) {
+			for (UIndex i = 0; i < sourceIndices.GetSize() && i < copySnapshots.GetSize(); ++i) {
+				grossSnapshots[sourceIndices[i]] = copySnapshots[i];
+				grossMeasured[sourceIndices[i]] = true;
+			}
+		}
 		return qtyErr;
-	});
+	};
+	const GSErrCode err = s_insideCallerCommand ? computeGross() :
+		ACAPI_CallUndoableCommand("SelectionMetrics_TemporaryCopy", computeGross);
+	s_creatingTemporaryCopies = wasCreating;
+	return err;
+}
+
+static GS::Array<SelectionMetricsHelper::Metric> BuildMetrics(const QuantitySnapshot& grossSnapshot,
+	const QuantitySnapshot& netSnapshot)
+{
+	GS::Array<SelectionMetricsHelper::Metric> metrics;
+
+	// Порядок и подписи — QuantityDescriptors::MetricTable
+	for (const QuantityDescriptors::MetricDescriptor& descriptor : QuantityDescriptors::MetricTable) {
+		if (netSnapshot.Has(descriptor.quantity) || grossSnapshot.Has(descriptor.quantity)) {
+			AppendMetric(metrics, descriptor.key, descriptor.name,
+				grossSnapshot.Get(descriptor.quantity), netSnapshot.Get(descriptor.quantity));
+		}
+	}
+
+	// Дополнительно: послойные метрики для многослойных конструкций
+	AppendLayerMetrics(metrics, grossSnapshot, netSnapshot);
+
+	return metrics;
+}
+
+// Прежний путь для сравнения: undo-команда с копией на каждый элемент
+static void GetGrossQuantitiesPerElement(const GS::Array<API_Element>& elements,
+	const GS::Array<QuantitySnapshot>& netSnapshots, GS::Array<QuantitySnapshot>& grossSnapshots,
+	GS::Array<bool>& grossMeasured)
+{
+	grossSnapshots = netSnapshots;
+	grossMeasured.Clear();
+	grossMeasured.SetCapacity(elements.GetSize());
+	for (UIndex i = 0; i < elements.GetSize(); ++i) {
+		GS::Array<API_Element> element;
+		GS::Array<QuantitySnapshot> elementNet;
+		GS::Array<QuantitySnapshot> elementGross;
+		GS::Array<bool> elementMeasured;
+		element.Push(elements[i]);
+		elementNet.Push(netSnapshots[i]);
+		GetGrossQuantitiesViaCopies(element, elementNet, elementGross, elementMeasured);
+		grossMeasured.Push(elementMeasured[0]);
+		if (elementMeasured[0]) {
+			grossSnapshots[i] = elementGross[0];
+		}
+	}
+}
+
+// gross неизвестен: значения не нули, а пропуск — палитра показывает «…», кеш их не хранит
+static void MarkGrossPending(GS::Array<SelectionMetricsHelper::Metric>& metrics)
+{
+	for (SelectionMetricsHelper::Metric& metric : metrics) {
+		metric.grossValue = 0.0;
+		metric.diffValue = 0.0;
+		metric.grossPending = true;
+	}
+}
+
+// Метрики элементов, которых нет в кеше: net — один пакетный запрос, gross — второй по временным копиям.
+// Элементы, у которых gross снять не удалось, возвращаются с grossPending (grossMeasured[i] = false);
+// copiedCount — сколько элементов ушло на временные копии. false — количества получить не удалось
+static bool ComputeMetrics(const GS::Array<API_Element>& elements, SelectionMetricsHelper::GrossMode grossMode,
+	GS::Array<GS::Array<SelectionMetricsHelper::Metric>>& metrics, GS::Array<bool>& grossMeasured, double& grossMs,
+	UInt32& copiedCount)
+{
+	GS::Array<API_Guid>			guids;
+	GS::Array<API_ElemTypeID>	types;
+	guids.SetCapacity(elements.GetSize());
+	types.SetCapacity(elements.GetSize());
+	for (const API_Element& element : elements) {
+		guids.Push(element.header.guid);
+		types.Push(element.header.type.typeID);
+	}
+
+	GS::Array<QuantitySnapshot> netSnapshots;
+	if (GetQuantitiesBatch(guids, types, QuantityDescriptors::AllQuantities, netSnapshots) != NoError) {
+		return false;
+	}
+
+	// Копии нужны только элементам с SEO-операторами или с непрочитанными связями (связи читаются
+	// через API для каждого элемента, без хранимого графа); у остальных gross совпадает с net.
+	// Отбор одинаков для обоих режимов — сравнение в GetSelectionSeoTotals мерит только способ копирования
+	const std::chrono::steady_clock::time_point grossStart = std::chrono::steady_clock::now();
+	GS::Array<QuantitySnapshot> grossSnapshots = netSnapshots;
+	grossMeasured.Clear();
+	grossMeasured.SetCapacity(elements.GetSize());
+	GS::Array<API_Element>		linkedElements;
+	GS::Array<QuantitySnapshot>	linkedNet;
+	GS::Array<UIndex>			linkedIndices;
+	for (UIndex i = 0; i < elements.GetSize(); ++i) {
+		if (SeoLinks::MayHaveOperators(elements[i].header.guid)) {
+			linkedElements.Push(elements[i]);
+			linkedNet.Push(netSnapshots[i]);
+			linkedIndices.Push(i);
+		}
+		grossMeasured.Push(true);
+	}
+	copiedCount = linkedElements.GetSize();
+
+	if (!linkedElements.IsEmpty()) {
+		GS::Array<QuantitySnapshot> linkedGross;
+		GS::Array<bool>				linkedMeasured;
+		if (grossMode == SelectionMetricsHelper::GrossMode::PerElement) {
+			GetGrossQuantitiesPerElement(linkedElements, linkedNet, linkedGross, linkedMeasured);
+		} else {
+			GetGrossQuantitiesViaCopies(linkedElements, linkedNet, linkedGross, linkedMeasured);
+		}
+		for (UIndex i = 0; i < linkedIndices.GetSize(); ++i) {
+			grossMeasured[linkedIndices[i]] = linkedMeasured[i];
+			if (linkedMeasured[i]) {
+				grossSnapshots[linkedIndices[i]] = linkedGross[i];
+			}
+		}
+	}
+	grossMs = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - grossStart).count();
+	LOG_INFO("[SelectionMetrics] gross %s: %u элементов, копий %u, %.1f мс",
+		(grossMode == SelectionMetricsHelper::GrossMode::PerElement) ? "по элементу" : "пакетом",
+		(unsigned)elements.GetSize(), (unsigned)copiedCount, grossMs);
+
+	metrics.Clear();
+	metrics.SetCapacity(elements.GetSize());
+	UIndex unmeasuredCount = 0;
+	for (UIndex i = 0; i < elements.GetSize(); ++i) {
+		metrics.Push(BuildMetrics(grossSnapshots[i], netSnapshots[i]));
+		if (!grossMeasured[i]) {
+			MarkGrossPending(metrics[i]);
+			++unmeasuredCount;
+		}
+	}
+	if (unmeasuredCount > 0) {
+		LOG_WARN("[SelectionMetrics] gross не снят для %u из %u элементов", (unsigned)unmeasuredCount,
+			(unsigned)elements.GetSize());
+	}
+	return true;
+}
+
+// Метрики набора элементов: из кеша, если элемент и его SEO-операторы не менялись, остальные — пакетом
+static SelectionMetricsHelper::SelectionMetrics CollectForElements(const GS::Array<API_Element>& elements,
+	SelectionMetricsHelper::GrossMode grossMode, bool useCache)
+{
+	SelectionMetricsHelper::SelectionMetrics result;
+	if (elements.IsEmpty()) {
+		return result;
+	}
+
+	NameCache::BeginPass();
+
+	GS::Array<SelectionMetricsHelper::ElementMetrics>	collected;
+	GS::Array<bool>										resolved;
+	GS::Array<API_Element>								pendingElements;
+	GS::Array<UIndex>									pendingIndices;
+	for (UIndex i = 0; i < elements.GetSize(); ++i) {
+		SelectionMetricsHelper::ElementMetrics elementMetrics;
+		elementMetrics.guid = elements[i].header.guid;
+		elementMetrics.typeID = elements[i].header.type.typeID;
+
+		MetricsCache::Fingerprint fingerprint;
+		const bool cached = useCache
+			&& MetricsCache::TakeFingerprint(elementMetrics.guid, fingerprint)
+			&& MetricsCache::Find(elementMetrics.guid, fingerprint, elementMetrics.metrics);
+		if (!cached) {
+			pendingElements.Push(elements[i]);
+			pendingIndices.Push(i);
+		}
+		collected.Push(elementMetrics);
+		resolved.Push(cached);
+	}
+
+	if (!pendingElements.IsEmpty()) {
+		GS::Array<GS::Array<SelectionMetricsHelper::Metric>> computed;
+		GS::Array<bool> grossMeasured;
+		if (ComputeMetrics(pendingElements, grossMode, computed, grossMeasured, result.grossMs, result.copiedCount)) {
+			for (UIndex i = 0; i < pendingIndices.GetSize(); ++i) {
+				SelectionMetricsHelper::ElementMetrics& elementMetrics = collected[pendingIndices[i]];
+				elementMetrics.metrics = computed[i];
+				resolved[pendingIndices[i]] = true;
+
+				// В кеш — только снятый gross: иначе неизвестность сохранилась бы как «потерь нет».
+				// Отпечаток — после расчёта: временные копии не должны делать запись устаревшей сразу
+				MetricsCache::Fingerprint fingerprint;
+				if (useCache && grossMeasured[i] && MetricsCache::TakeFingerprint(elementMetrics.guid, fingerprint)) {
+					MetricsCache::Store(elementMetrics.guid, fingerprint, elementMetrics.metrics);
+				}
+			}
+		}
+	}
+
+	// Суммы по ключу метрики в порядке первого появления; разница — по суммам, а не сумма разниц
+	GS::HashTable<GS::UniString, UIndex> totalIndexByKey;
+	result.elements.SetCapacity(collected.GetSize());
+	for (UIndex i = 0; i < collected.GetSize(); ++i) {
+		if (!resolved[i]) {
+			continue;
+		}
+		const SelectionMetricsHelper::ElementMetrics& elementMetrics = collected[i];
+		for (const SelectionMetricsHelper::Metric& metric : elementMetrics.metrics) {
+			UIndex totalIndex;
+			if (!totalIndexByKey.Get(metric.key, &totalIndex)) {
+				totalIndex = result.totals.GetSize();
+				totalIndexByKey.Add(metric.key, totalIndex);
+				SelectionMetricsHelper::Metric total;
+				total.key = metric.key;
+				total.name = metric.name;
+				result.totals.Push(total);
+			}
+			result.totals[totalIndex].grossValue += metric.grossValue;
+			result.totals[totalIndex].netValue += metric.netValue;
+			result.totals[totalIndex].grossPending = result.totals[totalIndex].grossPending || metric.grossPending;
+		}
+		result.elements.Push(elementMetrics);
+	}
+	// Сумма с неизвестным слагаемым тоже неизвестна
+	for (SelectionMetricsHelper::Metric& total : result.totals) {
+		if (total.grossPending) {
+			total.grossValue = 0.0;
+			total.diffValue = 0.0;
+		} else {
+			total.diffValue = DiffWithoutNoise(total.grossValue, total.netValue);
+		}
+	}
+
+	return result;
+}
+
+// Площадь для сумм по группам — верхняя (опорная) поверхность
+static SelectionMetricsHelper::AreaVolume ToAreaVolume(API_ElemTypeID typeID, const API_ElementQuantity& quantity)
+{
+	SelectionMetricsHelper::AreaVolume value;
+	if (const QuantityDescriptors::TypeDescriptor* descriptor = QuantityDescriptors::Find(typeID)) {
+		if (descriptor->topSurface.read != nullptr) {
+			value.area = descriptor->topSurface.read(quantity);
+		}
+		if (descriptor->volume.read != nullptr) {
+			value.volume = descriptor->volume.read(quantity);
+		}
+	}
+	return value;
+}
+
+// Повторы замера маски: берётся лучший, чтобы не мерить прогрев кешей Archicad
+const UInt32 MaskBenchmarkRuns = 3;
+
+// Время одного запроса количеств с заданной маской (полный набор выходных массивов, как до
+// QuantityDescriptors, — при полной маске; только нужные — при минимальной)
+static double TimeQuantityRequest(const GS::Array<API_Guid>& guids, API_QuantitiesMask& mask, bool fullOutputs)
+{
+	GS::Array<API_Guid>									requestGuids = guids;
+	GS::Array<API_ElementQuantity>						elementQuantities;
+	GS::Array<GS::Array<API_CompositeQuantity>>			composites;
+	GS::Array<GS::Array<API_ElemPartQuantity>>			elemPartQuantities;
+	GS::Array<GS::Array<API_ElemPartCompositeQuantity>>	elemPartComposites;
+	GS::Array<API_Quantities>							quantities;
+	for (UIndex i = 0; i < guids.GetSize(); ++i) {
+		elementQuantities.Push(API_ElementQuantity());
+		composites.Push(GS::Array<API_CompositeQuantity>());
+		elemPartQuantities.Push(GS::Array<API_ElemPartQuantity>());
+		elemPartComposites.Push(GS::Array<API_ElemPartCompositeQuantity>());
+	}
+	for (UIndex i = 0; i < guids.GetSize(); ++i) {
+		API_Quantities q = {};
+		q.elements = &elementQuantities[i];
+		q.composites = &composites[i];
+		if (fullOutputs) {
+			q.elemPartQuantities = &elemPartQuantities[i];
+			q.elemPartComposites = &elemPartComposites[i];
+		}
+		quantities.Push(q);
+	}
+
+	API_QuantityPar params = {};
+	params.minOpeningSize = 0.0;
+
+	const std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+	API_CALL(ACAPI_Element_GetMoreQuantities, &requestGuids, &params, &quantities, &mask);
+	return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
 }
 
 } // namespace
 
+GS::Array<SelectionMetricsHelper::MaskBenchmarkRow> SelectionMetricsHelper::BenchmarkQuantityMasks()
+{
+	API_OPERATION("metrics");
+	TRACE_SPAN("BenchmarkQuantityMasks", "metrics");
+
+	API_SelectionInfo selectionInfo = {};
+	GS::Array<API_Neig> selNeigs;
+	API_CALL(ACAPI_Selection_Get, &selectionInfo, &selNeigs, false, false);
+	BMKillHandle(reinterpret_cast<GSHandle*>(&selectionInfo.marquee.coords));
+
+	NameCache::BeginPass();
+
+	// Один проход по выделению: каждый элемент раскладывается в строку своего типа
+	constexpr UIndex TypeCount = static_cast<UIndex>(std::size(QuantityDescriptors::TypeTable));
+	GS::Array<API_Guid> guidsByType[TypeCount];
+	for (const API_Neig& neig : selNeigs) {
+		API_Elem_Head head = {};
+		head.guid = neig.guid;
+		if (API_CALL(ACAPI_Element_GetHeader, &head) != NoError) {
+			continue;
+		}
+		const QuantityDescriptors::TypeDescriptor* descriptor = QuantityDescriptors::Find(head.type.typeID);
+		if (descriptor != nullptr) {
+			guidsByType[descriptor - QuantityDescriptors::TypeTable].Push(neig.guid);
+		}
+	}
+
+	GS::Array<MaskBenchmarkRow> rows;
+	for (UIndex t = 0; t < TypeCount; ++t) {
+		const QuantityDescriptors::TypeDescriptor& descriptor = QuantityDescriptors::TypeTable[t];
+		const GS::Array<API_Guid>& guids = guidsByType[t];
+		if (guids.IsEmpty()) {
+			continue;
+		}
+		GS::Array<API_ElemTypeID> types;
+		types.SetCapacity(guids.GetSize());
+		for (UIndex i = 0; i < guids.GetSize(); ++i) {
+			types.Push(descriptor.typeID);
+		}
+
+		MaskBenchmarkRow row;
+		row.typeName = NameCache::GetString(NameCache::GetTypeName(API_ElemType(descriptor.typeID)));
+		row.elementCount = guids.GetSize();
+
+		API_QuantitiesMask fullMask;
+		ACAPI_ELEMENT_QUANTITIES_MASK_SETFULL(fullMask);
+		API_QuantitiesMask minimalMask;
+		QuantityDescriptors::BuildMask(types, QuantityDescriptors::AllQuantities, minimalMask);
+
+		for (UInt32 run = 0; run < MaskBenchmarkRuns; ++run) {
+			const double fullMs = TimeQuantityRequest(guids, fullMask, true);
+			const double minimalMs = TimeQuantityRequest(guids, minimalMask, false);
+			row.fullMs = (run == 0) ? fullMs : std::min(row.fullMs, fullMs);
+			row.minimalMs = (run == 0) ? minimalMs : std::min(row.minimalMs, minimalMs);
+		}
+
+		LOG_INFO("[SelectionMetrics] маска количеств, %s × %u: полная %.2f мс, минимальная %.2f мс (%.3f / %.3f мс на элемент)",
+			row.typeName.ToCStr(CC_UTF8).Get(), (unsigned)row.elementCount, row.fullMs, row.minimalMs,
+			row.fullMs / row.elementCount, row.minimalMs / row.elementCount);
+		rows.Push(row);
+	}
+	return rows;
+}
+
+GSErrCode SelectionMetricsHelper::CollectAreaVolume(const GS::Array<API_Guid>& guids, const GS::Array<API_ElemTypeID>& types,
+	GS::Array<AreaVolume>& result)
+{
+	API_OPERATION("metrics");
+	TRACE_SPAN("CollectAreaVolume", "metrics");
+	result.Clear();
+	result.SetCapacity(guids.GetSize());
+
+	API_QuantityPar params = {};
+	params.minOpeningSize = 0.0;
+
+	// Только площадь и объём — без поверхностей, которые суммы не используют, и без composites
+	API_QuantitiesMask mask;
+	if (!QuantityDescriptors::BuildMask(types, QuantityDescriptors::TopSurface | QuantityDescriptors::Volume, mask)) {
+		for (UIndex i = 0; i < guids.GetSize(); ++i) {
+			result.Push(AreaVolume());
+		}
+		return NoError;
+	}
+
+	for (UIndex chunkStart = 0; chunkStart < guids.GetSize(); chunkStart += QuantityChunkSize) {
+		const UIndex chunkEnd = (chunkStart + QuantityChunkSize < guids.GetSize()) ? chunkStart + QuantityChunkSize : guids.GetSize();
+		TRACE_SPAN("quantities chunk", "metrics");
+
+		GS::Array<API_Guid>				chunkGuids;
+		GS::Array<API_ElementQuantity>	elementQuantities;
+		GS::Array<API_Quantities>		quantities;
+		chunkGuids.SetCapacity(chunkEnd - chunkStart);
+		for (UIndex i = chunkStart; i < chunkEnd; ++i) {
+			chunkGuids.Push(guids[i]);
+			elementQuantities.Push(API_ElementQuantity());
+		}
+		// указатели берём после заполнения массива, чтобы они не сместились при росте
+		for (UIndex i = 0; i < chunkGuids.GetSize(); ++i) {
+			API_Quantities q = {};
+			q.elements = &elementQuantities[i];
+			quantities.Push(q);
+		}
+
+		GSErrCode err = API_CALL(ACAPI_Element_GetMoreQuantities, &chunkGuids, &params, &quantities, &mask);
+		if (err != NoError) {
+			return err;
+		}
+
+		for (UIndex i = 0; i < chunkGuids.GetSize(); ++i) {
+			const API_ElemTypeID typeID = (chunkStart + i < types.GetSize()) ? types[chunkStart + i] : API_ZombieElemID;
+			result.Push(ToAreaVolume(typeID, elementQuantities[i]));
+		}
+	}
+
+	return NoError;
+}
+
 GS::Array<SelectionMetricsHelper::Metric> SelectionMetricsHelper::CollectForGuid(const API_Guid& guid)
 {
-	GS::Array<Metric> metrics;
+	API_OPERATION("metrics");
+	TRACE_SPAN("CollectForGuid", "metrics");
 
 	if (guid == APINULLGuid) {
-		return metrics;
+		return GS::Array<Metric>();
 	}
 
 	API_Element element = {};
 	element.header.guid = guid;
-	if (ACAPI_Element_Get(&element) != NoError) {
-		return metrics;
+	if (API_CALL(ACAPI_Element_Get, &element) != NoError) {
+		return GS::Array<Metric>();
 	}
 
-	QuantitySnapshot netSnapshot;
-	if (GetQuantities(element, netSnapshot) != NoError) {
+	GS::Array<API_Element> elements;
+	elements.Push(element);
+	SelectionMetrics result = CollectForElements(elements, GrossMode::Batched, true);
+	return result.elements.IsEmpty() ? GS::Array<Metric>() : result.elements[0].metrics;
+}
+
+GS::Array<SelectionMetricsHelper::Metric> SelectionMetricsHelper::CollectNetForGuid(const API_Guid& guid, bool& grossReady)
+{
+	API_OPERATION("metrics");
+	TRACE_SPAN("CollectNetForGuid", "metrics");
+	grossReady = true;
+
+	if (guid == APINULLGuid) {
+		return GS::Array<Metric>();
+	}
+
+	GS::Array<Metric> metrics;
+	MetricsCache::Fingerprint fingerprint;
+	if (MetricsCache::TakeFingerprint(guid, fingerprint) && MetricsCache::Find(guid, fingerprint, metrics)) {
 		return metrics;
 	}
 
-	QuantitySnapshot grossSnapshot = netSnapshot;
-	if (GetGrossQuantitiesViaCopy(element, grossSnapshot) != NoError) {
-		grossSnapshot = netSnapshot;
+	API_Elem_Head head = {};
+	head.guid = guid;
+	if (API_CALL(ACAPI_Element_GetHeader, &head) != NoError) {
+		return GS::Array<Metric>();
 	}
+	// Тип без SEO-метрик: считать нечего, и отложенный расчёт (undo-команда) не нужен
+	if (!QuantityDescriptors::IsSupported(head.type.typeID)) {
+		return GS::Array<Metric>();
+	}
+
+	NameCache::BeginPass();
 
-	if (netSnapshot.hasTotalSurface || grossSnapshot.hasTotalSurface) {
-		AppendMetric(metrics, "totalArea", "Площадь", grossSnapshot.totalSurface, netSnapshot.totalSurface);
+	GS::Array<API_Guid>			guids;
+	GS::Array<API_ElemTypeID>	types;
+	guids.Push(guid);
+	types.Push(head.type.typeID);
+	GS::Array<QuantitySnapshot> netSnapshots;
+	if (GetQuantitiesBatch(guids, types, QuantityDescriptors::AllQuantities, netSnapshots) != NoError || netSnapshots.IsEmpty()) {
+		return GS::Array<Metric>();
 	}
 
-	if (netSnapshot.hasTopSurface || grossSnapshot.hasTopSurface) {
-		AppendMetric(metrics, "topSurface", "Площадь верхней поверхности", grossSnapshot.topSurface, netSnapshot.topSurface);
+	// Только net: gross и разница придут позже, до тех пор они не равны нулю, а неизвестны
+	grossReady = false;
+	metrics = BuildMetrics(netSnapshots[0], netSnapshots[0]);
+	MarkGrossPending(metrics);
+	return metrics;
+}
+
+SelectionMetricsHelper::SelectionMetrics SelectionMetricsHelper::CollectForGuids(const GS::Array<API_Guid>& guids, bool useCache)
+{
+	API_OPERATION("metrics");
+	TRACE_SPAN("CollectForGuids", "metrics");
+
+	GS::Array<API_Element> elements;
+	for (const API_Guid& guid : guids) {
+		API_Element element = {};
+		element.header.guid = guid;
+		if (API_CALL(ACAPI_Element_Get, &element) == NoError && QuantityDescriptors::IsSupported(element.header.type.typeID)) {
+			elements.Push(element);
+		}
 	}
 
-	if (netSnapshot.hasVolume || grossSnapshot.hasVolume) {
-		AppendMetric(metrics, "volume", "Объем", grossSnapshot.volume, netSnapshot.volume);
+	return CollectForElements(elements, GrossMode::Batched, useCache);
+}
+
+bool SelectionMetricsHelper::IsCreatingTemporaryCopies()
+{
+	return s_creatingTemporaryCopies;
+}
+
+GSErrCode SelectionMetricsHelper::RunInOneUndoStep(const GS::UniString& name, const std::function<GSErrCode()>& body)
+{
+	if (s_insideCallerCommand) {
+		return body();
 	}
 
-	// Дополнительно: послойные метрики для многослойных конструкций
-	AppendLayerMetrics(metrics, grossSnapshot, netSnapshot);
+	s_insideCallerCommand = true;
+	const GSErrCode err = ACAPI_CallUndoableCommand(name, body);
+	s_insideCallerCommand = false;
+	return err;
+}
 
-	return metrics;
+API_Guid SelectionMetricsHelper::GetFirstSelected()
+{
+	return GetFirstSelectedGuid();
 }
 
 GS::Array<SelectionMetricsHelper::Metric> SelectionMetricsHelper::CollectForFirstSelected()
@@ -383,4 +866,25 @@ GS::Array<SelectionMetricsHelper::Metric> SelectionMetricsHelper::CollectForFirs
 	return CollectForGuid(guid);
 }
 
+SelectionMetricsHelper::SelectionMetrics SelectionMetricsHelper::CollectForSelection(GrossMode grossMode, bool useCache)
+{
+	API_OPERATION("metrics");
+	TRACE_SPAN("CollectForSelection", "metrics");
 
+	API_SelectionInfo selectionInfo = {};
+	GS::Array<API_Neig> selNeigs;
+	API_CALL(ACAPI_Selection_Get, &selectionInfo, &selNeigs, false, false);
+	BMKillHandle(reinterpret_cast<GSHandle*>(&selectionInfo.marquee.coords));
+
+	// Элементы нужны целиком: по ним создаются временные копии для gross
+	GS::Array<API_Element> elements;
+	for (const API_Neig& neig : selNeigs) {
+		API_Element element = {};
+		element.header.guid = neig.guid;
+		if (API_CALL(ACAPI_Element_Get, &element) == NoError && QuantityDescriptors::IsSupported(element.header.type.typeID)) {
+			elements.Push(element);
+		}
+	}
+
+	return CollectForElements(elements, grossMode, useCache);
+}
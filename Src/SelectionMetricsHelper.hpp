@@ -6,6 +6,8 @@
 #include "APIEnvir.h"
 #include "ACAPinc.h"
 
+#include <functional>
+
 class SelectionMetricsHelper
 {
 public:
@@ -15,10 +17,77 @@ public:
 		double			grossValue = 0.0;	// without SEO
 		double			netValue = 0.0;		// current (with SEO)
 		double			diffValue = 0.0;	// |gross - net|
+		bool			grossPending = false;	// gross ещё считается или снять его не удалось: grossValue и diffValue не заполнены
+	};
+
+	// Площадь и объём элемента для сумм по группам (без расчёта gross через копию)
+	struct AreaVolume {
+		double	area = 0.0;
+		double	volume = 0.0;
+	};
+
+	// Метрики одного элемента выделения
+	struct ElementMetrics {
+		API_Guid			guid = APINULLGuid;
+		API_ElemTypeID		typeID = API_ZombieElemID;
+		GS::Array<Metric>	metrics;
+	};
+
+	// Метрики всего выделения: по элементам и суммы по каждому ключу метрики
+	struct SelectionMetrics {
+		GS::Array<ElementMetrics>	elements;
+		GS::Array<Metric>			totals;
+		double						grossMs = 0.0;	// время расчёта gross по временным копиям (0 — всё из кеша)
+		UInt32						copiedCount = 0;	// элементов, скопированных для gross (остальные — из кеша или без SEO)
+	};
+
+	// Замер запроса количеств по типу элемента: полная маска против минимальной
+	struct MaskBenchmarkRow {
+		GS::UniString	typeName;
+		UInt32			elementCount = 0;
+		double			fullMs = 0.0;		// ACAPI_ELEMENT_QUANTITIES_MASK_SETFULL, как раньше
+		double			minimalMs = 0.0;	// маска из QuantityDescriptors под SEO-метрики
 	};
 
+	// Расчёт gross: все копии в одной undo-команде или команда на элемент (прежний путь, для замеров)
+	enum class GrossMode {
+		Batched,
+		PerElement
+	};
+
+	static API_Guid GetFirstSelected();
 	static GS::Array<Metric> CollectForFirstSelected();
 	static GS::Array<Metric> CollectForGuid(const API_Guid& guid);
+
+	// Быстрый ответ без временных копий: из кеша целиком (grossReady = true) или только net —
+	// тогда gross приравнен к net, а настоящие значения считает GrossMetricsJob.
+	// Для типов без SEO-метрик — пустой список и grossReady = true: досчитывать нечего
+	static GS::Array<Metric> CollectNetForGuid(const API_Guid& guid, bool& grossReady);
+
+	// Полные метрики заданных элементов одним пакетом (порция отложенного расчёта gross);
+	// элементы неподдерживаемых типов пропускаются, как в CollectForSelection.
+	// useCache = false — разовый обход (отчёт по проекту): кеш палитры не читается и не вытесняется
+	static SelectionMetrics CollectForGuids(const GS::Array<API_Guid>& guids, bool useCache = true);
+
+	// Все выделенные перекрытия, крыши, 3D-сетки, оболочки и морфы: net — пакетным запросом
+	// количеств, gross — вторым пакетным запросом по временным копиям в одной undo-команде.
+	// Неизменённые с прошлого расчёта элементы берутся из MetricsCache (useCache = false — для замеров)
+	static SelectionMetrics CollectForSelection(GrossMode grossMode = GrossMode::Batched, bool useCache = true);
+
+	// Выделенные элементы поддерживаемых типов, по типу: лучшее из нескольких повторов каждой маски
+	static GS::Array<MaskBenchmarkRow> BenchmarkQuantityMasks();
+
+	// Идёт расчёт gross по временным копиям: уведомления об изменении элементов в это время
+	// вызваны самим расчётом (связи SEO у копий), а не пользователем
+	static bool IsCreatingTemporaryCopies();
+
+	// Выполнить body одной undo-командой: расчёты gross внутри неё не открывают своих команд,
+	// и в истории отмены остаётся один шаг вместо шага на каждую порцию (отчёт по проекту)
+	static GSErrCode RunInOneUndoStep(const GS::UniString& name, const std::function<GSErrCode()>& body);
+
+	// Пакетный запрос количеств: result[i] соответствует guids[i]
+	static GSErrCode CollectAreaVolume(const GS::Array<API_Guid>& guids, const GS::Array<API_ElemTypeID>& types,
+		GS::Array<AreaVolume>& result);
 };
 
 
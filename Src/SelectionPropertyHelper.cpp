@@ -1,4 +1,5 @@
 #include "SelectionPropertyHelper.hpp"
+#include "ApiProfiler.hpp"
 
 namespace {
 
@@ -6,7 +7,7 @@ API_Guid GetFirstSelectedGuid()
 {
 	API_SelectionInfo selectionInfo = {};
 	GS::Array<API_Neig> selNeigs;
-	if (ACAPI_Selection_Get(&selectionInfo, &selNeigs, false, false) == NoError && !selNeigs.IsEmpty()) {
+	if (API_CALL(ACAPI_Selection_Get, &selectionInfo, &selNeigs, false, false) == NoError && !selNeigs.IsEmpty()) {
 		const API_Guid guid = selNeigs[0].guid;
 		BMKillHandle(reinterpret_cast<GSHandle*>(&selectionInfo.marquee.coords));
 		return guid;
@@ -25,7 +26,7 @@ GS::UniString ToString(const API_Property& property)
 	}
 
 	GS::UniString valueString;
-	if (ACAPI_Property_GetPropertyValueString(property, &valueString) == NoError) {
+	if (API_CALL(ACAPI_Property_GetPropertyValueString, property, &valueString) == NoError) {
 		return valueString;
 	}
 	return GS::UniString();
@@ -42,17 +43,17 @@ GS::Array<SelectionPropertyHelper::PropertyInfo> SelectionPropertyHelper::Collec
 
 	API_Element element = {};
 	element.header.guid = guid;
-	if (ACAPI_Element_Get(&element) != NoError) {
+	if (API_CALL(ACAPI_Element_Get, &element) != NoError) {
 		return results;
 	}
 
 	GS::Array<API_PropertyDefinition> definitions;
-	if (ACAPI_Element_GetPropertyDefinitions(guid, API_PropertyDefinitionFilter_All, definitions) != NoError) {
+	if (API_CALL(ACAPI_Element_GetPropertyDefinitions, guid, API_PropertyDefinitionFilter_All, definitions) != NoError) {
 		return results;
 	}
 
 	GS::Array<API_Property> properties;
-	if (ACAPI_Element_GetPropertyValues(guid, definitions, properties) != NoError) {
+	if (API_CALL(ACAPI_Element_GetPropertyValues, guid, definitions, properties) != NoError) {
 		return results;
 	}
 
@@ -0,0 +1,248 @@
+#include "SelectionSetHelper.hpp"
+#include "ApiProfiler.hpp"
+
+#include <algorithm>
+#include <cstring>
+#include <iterator>
+
+namespace SelectionSetHelper {
+
+// Имена объектов дополнения: префикс + имя набора
+static const char* SetObjectPrefix = "ToLayout.SelectionSet/";
+
+// Заголовок содержимого: сигнатура и число GUID, затем GuidKey[count]
+static const UInt32 SetContentMagic = 0x31535354;  // "TSS1"
+
+struct SetContentHeader {
+    UInt32 magic = SetContentMagic;
+    UInt32 count = 0;
+};
+
+static_assert (sizeof (GuidKey) == sizeof (API_Guid), "GuidKey must match API_Guid layout");
+
+static GuidKey ToKey (const API_Guid& guid)
+{
+    GuidKey key;
+    std::memcpy (&key, &guid, sizeof (key));
+    return key;
+}
+
+static API_Guid ToGuid (const GuidKey& key)
+{
+    API_Guid guid;
+    std::memcpy (&guid, &key, sizeof (guid));
+    return guid;
+}
+
+static GS::UniString ObjectName (const GS::UniString& setName)
+{
+    GS::UniString objectName (SetObjectPrefix);
+    objectName.Append (setName);
+    return objectName;
+}
+
+// ---------------- Построение набора ----------------
+GuidSet MakeSet (const GS::Array<API_Guid>& guids)
+{
+    GuidSet set;
+    set.reserve (guids.GetSize ());
+    for (const API_Guid& guid : guids) {
+        if (guid != APINULLGuid)
+            set.push_back (ToKey (guid));
+    }
+    std::sort (set.begin (), set.end ());
+    set.erase (std::unique (set.begin (), set.end ()), set.end ());
+    return set;
+}
+
+// ---------------- Алгебра наборов ----------------
+GuidSet Combine (const GuidSet& left, const GuidSet& right, SetOperation operation)
+{
+    GuidSet result;
+    switch (operation) {
+        case SetOperation::Union:
+            result.reserve (left.size () + right.size ());
+            std::set_union (left.begin (), left.end (), right.begin (), right.end (), std::back_inserter (result));
+            break;
+        case SetOperation::Intersection:
+            result.reserve (std::min (left.size (), right.size ()));
+            std::set_intersection (left.begin (), left.end (), right.begin (), right.end (), std::back_inserter (result));
+            break;
+        case SetOperation::Difference:
+            result.reserve (left.size ());
+            std::set_difference (left.begin (), left.end (), right.begin (), right.end (), std::back_inserter (result));
+            break;
+    }
+    return result;
+}
+
+// ---------------- Текущее выделение ----------------
+GuidSet GetCurrentSelection ()
+{
+    API_SelectionInfo selectionInfo = {};
+    GS::Array<API_Neig> selNeigs;
+    API_CALL (ACAPI_Selection_Get, &selectionInfo, &selNeigs, false, false);
+    BMKillHandle ((GSHandle*) &selectionInfo.marquee.coords);
+
+    GS::Array<API_Guid> guids;
+    guids.SetCapacity (selNeigs.GetSize ());
+    for (const API_Neig& neig : selNeigs)
+        guids.Push (neig.guid);
+    return MakeSet (guids);
+}
+
+// ---------------- Отбросить несуществующие элементы ----------------
+UInt32 RemoveStale (GuidSet& set)
+{
+    if (set.empty ())
+        return 0;
+
+    GS::Array<API_Guid> allElements;
+    if (API_CALL (ACAPI_Element_GetElemList, API_ZombieElemID, &allElements) != NoError)
+        return 0;
+
+    const GuidSet existing = MakeSet (allElements);
+    GuidSet alive = Combine (set, existing, SetOperation::Intersection);
+    const UInt32 removed = static_cast<UInt32> (set.size () - alive.size ());
+    set.swap (alive);
+    return removed;
+}
+
+// ---------------- Применить набор как выделение ----------------
+ApplyResult ApplyAsSelection (GuidSet set)
+{
+    API_OPERATION ("selection sets");
+    ApplyResult result;
+    result.stale = RemoveStale (set);
+
+    // Снимаем текущее выделение
+    API_SelectionInfo selectionInfo = {};
+    GS::Array<API_Neig> selNeigs;
+    API_CALL (ACAPI_Selection_Get, &selectionInfo, &selNeigs, false, false);
+    BMKillHandle ((GSHandle*) &selectionInfo.marquee.coords);
+    if (!selNeigs.IsEmpty ())
+        API_CALL (ACAPI_Selection_Select, selNeigs, false);
+
+    if (set.empty ())
+        return result;
+
+    GS::Array<API_Neig> neigs;
+    neigs.SetCapacity (static_cast<USize> (set.size ()));
+    for (const GuidKey& key : set)
+        neigs.Push (API_Neig (ToGuid (key)));
+
+    // Все элементы набора — одним батчем
+    if (API_CALL (ACAPI_Selection_Select, neigs, true) == NoError)
+        result.applied = static_cast<UInt32> (neigs.GetSize ());
+    return result;
+}
+
+// ---------------- Список сохранённых наборов ----------------
+GS::Array<SetInfo> GetSavedSets ()
+{
+    GS::Array<SetInfo> result;
+    GS::Array<API_Guid> objects;
+    if (API_CALL (ACAPI_AddOnObject_GetObjectList, &objects) != NoError)
+        return result;
+
+    std::vector<SetInfo> sets;
+
+    const GS::UniString prefix (SetObjectPrefix);
+    for (const API_Guid& objectGuid : objects) {
+        GS::UniString objectName;
+        GSHandle content = nullptr;
+        if (API_CALL (ACAPI_AddOnObject_GetObjectContent, objectGuid, &objectName, &content) != NoError)
+            continue;
+
+        if (objectName.BeginsWith (prefix) && content != nullptr && BMGetHandleSize (content) >= (GSSize) sizeof (SetContentHeader)) {
+            SetContentHeader header;
+            std::memcpy (&header, *content, sizeof (header));
+            if (header.magic == SetContentMagic) {
+                SetInfo info;
+                info.name = objectName.GetSubstring (prefix.GetLength (), objectName.GetLength () - prefix.GetLength ());
+                info.count = header.count;
+                sets.push_back (info);
+            }
+        }
+        BMKillHandle (&content);
+    }
+
+    std::sort (sets.begin (), sets.end (), [] (const SetInfo& a, const SetInfo& b) { return a.name < b.name; });
+    for (const SetInfo& info : sets)
+        result.Push (info);
+    return result;
+}
+
+// ---------------- Загрузка набора ----------------
+bool LoadSet (const GS::UniString& name, GuidSet& set)
+{
+    set.clear ();
+    API_Guid objectGuid = APINULLGuid;
+    if (API_CALL (ACAPI_AddOnObject_GetObjectGuidFromName, ObjectName (name), &objectGuid) != NoError)
+        return false;
+
+    GS::UniString objectName;
+    GSHandle content = nullptr;
+    if (API_CALL (ACAPI_AddOnObject_GetObjectContent, objectGuid, &objectName, &content) != NoError)
+        return false;
+
+    bool ok = false;
+    const GSSize size = (content != nullptr) ? BMGetHandleSize (content) : 0;
+    if (size >= (GSSize) sizeof (SetContentHeader)) {
+        SetContentHeader header;
+        std::memcpy (&header, *content, sizeof (header));
+        if (header.magic == SetContentMagic && size >= (GSSize) (sizeof (header) + header.count * sizeof (GuidKey))) {
+            // Данные уже отсортированы при сохранении — копируем одним блоком
+            set.resize (header.count);
+            if (header.count > 0)
+                std::memcpy (set.data (), *content + sizeof (header), header.count * sizeof (GuidKey));
+            ok = true;
+        }
+    }
+    BMKillHandle (&content);
+    return ok;
+}
+
+// ---------------- Сохранение набора ----------------
+GSErrCode SaveSet (const GS::UniString& name, const GuidSet& set)
+{
+    if (name.IsEmpty ())
+        return APIERR_BADPARS;
+
+    SetContentHeader header;
+    header.count = static_cast<UInt32> (set.size ());
+    const GSSize size = (GSSize) (sizeof (header) + set.size () * sizeof (GuidKey));
+    GSHandle content = BMAllocateHandle (size, ALLOCATE_CLEAR, 0);
+    if (content == nullptr)
+        return APIERR_MEMFULL;
+
+    std::memcpy (*content, &header, sizeof (header));
+    if (!set.empty ())
+        std::memcpy (*content + sizeof (header), set.data (), set.size () * sizeof (GuidKey));
+
+    const GS::UniString objectName = ObjectName (name);
+    GSErrCode err = ACAPI_CallUndoableCommand ("Save Selection Set", [&] () -> GSErrCode {
+        API_Guid objectGuid = APINULLGuid;
+        if (API_CALL (ACAPI_AddOnObject_GetObjectGuidFromName, objectName, &objectGuid) == NoError)
+            return API_CALL (ACAPI_AddOnObject_ModifyObject, objectGuid, nullptr, &content);
+        return API_CALL (ACAPI_AddOnObject_CreateObject, objectName, content, &objectGuid);
+    });
+
+    BMKillHandle (&content);
+    return err;
+}
+
+// ---------------- Удаление набора ----------------
+GSErrCode DeleteSet (const GS::UniString& name)
+{
+    API_Guid objectGuid = APINULLGuid;
+    GSErrCode err = API_CALL (ACAPI_AddOnObject_GetObjectGuidFromName, ObjectName (name), &objectGuid);
+    if (err != NoError)
+        return err;
+
+    return ACAPI_CallUndoableCommand ("Delete Selection Set", [&] () -> GSErrCode {
+        return API_CALL (ACAPI_AddOnObject_DeleteObject, objectGuid);
+    });
+}
+
+} // namespace SelectionSetHelper
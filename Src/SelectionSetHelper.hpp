@@ -0,0 +1,62 @@
+#ifndef SELECTIONSETHELPER_HPP
+#define SELECTIONSETHELPER_HPP
+
+#include "APIEnvir.h"
+#include "ACAPinc.h"
+#include "GSRoot.hpp"
+
+#include <vector>
+
+// Именованные наборы выделения, сохраняемые в проекте (данные дополнения).
+// Набор хранится как отсортированный массив 128-битных GUID, поэтому объединение,
+// пересечение и разность считаются линейным слиянием.
+namespace SelectionSetHelper {
+
+    // GUID как два 64-битных слова: порядок сортировки и сравнение без разбора строк
+    struct GuidKey {
+        UInt64 hi = 0;
+        UInt64 lo = 0;
+
+        bool operator< (const GuidKey& other) const { return hi < other.hi || (hi == other.hi && lo < other.lo); }
+        bool operator== (const GuidKey& other) const { return hi == other.hi && lo == other.lo; }
+    };
+
+    typedef std::vector<GuidKey> GuidSet;  // всегда отсортирован, без повторов
+
+    enum class SetOperation { Union, Intersection, Difference };
+
+    // Построить набор из произвольного массива GUID (сортировка + удаление повторов)
+    GuidSet MakeSet (const GS::Array<API_Guid>& guids);
+
+    // Линейное слияние двух отсортированных наборов
+    GuidSet Combine (const GuidSet& left, const GuidSet& right, SetOperation operation);
+
+    // Текущее выделение в виде набора
+    GuidSet GetCurrentSelection ();
+
+    // Убрать GUID удалённых элементов: одна выборка всех элементов проекта + слияние.
+    // Возвращает число отброшенных GUID
+    UInt32 RemoveStale (GuidSet& set);
+
+    struct ApplyResult {
+        UInt32 applied = 0;   // выделено элементов
+        UInt32 stale = 0;     // отброшено несуществующих GUID
+    };
+
+    // Заменить выделение набором одним вызовом ACAPI_Selection_Select
+    ApplyResult ApplyAsSelection (GuidSet set);
+
+    // ---- Хранение в проекте ----
+    struct SetInfo {
+        GS::UniString name;
+        UInt32        count = 0;
+    };
+
+    GS::Array<SetInfo> GetSavedSets ();
+    bool LoadSet (const GS::UniString& name, GuidSet& set);
+    GSErrCode SaveSet (const GS::UniString& name, const GuidSet& set);
+    GSErrCode DeleteSet (const GS::UniString& name);
+
+} // namespace SelectionSetHelper
+
+#endif // SELECTIONSETHELPER_HPP
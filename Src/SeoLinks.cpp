@@ -0,0 +1,40 @@
+#include "SeoLinks.hpp"
+#include "ApiProfiler.hpp"
+#include "Logger.hpp"
+
+namespace SeoLinks {
+
+// Нет 3D-модели — нет и связей; остальные ошибки вызывающий код обрабатывает сам
+static GSErrCode NormalizeError (GSErrCode err, GS::Array<API_Guid>& guids)
+{
+    if (err == NoError)
+        return NoError;
+    guids.Clear ();
+    return (err == APIERR_NO3D) ? NoError : err;
+}
+
+GSErrCode GetOperators (const API_Guid& target, GS::Array<API_Guid>& operators)
+{
+    operators.Clear ();
+    return NormalizeError (API_CALL (ACAPI_Element_SolidLink_GetOperators, target, &operators), operators);
+}
+
+bool MayHaveOperators (const API_Guid& target)
+{
+    GS::Array<API_Guid> operators;
+    const GSErrCode err = GetOperators (target, operators);
+    if (err != NoError) {
+        LOG_WARN ("[SeoLinks] операторы %s не прочитаны (%d), gross считается по копии",
+            APIGuidToString (target).ToCStr (CC_UTF8).Get (), static_cast<int> (err));
+        return true;
+    }
+    return !operators.IsEmpty ();
+}
+
+GSErrCode GetTargets (const API_Guid& oper, GS::Array<API_Guid>& targets)
+{
+    targets.Clear ();
+    return NormalizeError (API_CALL (ACAPI_Element_SolidLink_GetTargets, oper, &targets), targets);
+}
+
+} // namespace SeoLinks
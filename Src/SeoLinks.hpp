@@ -0,0 +1,29 @@
+#ifndef SEOLINKS_HPP
+#define SEOLINKS_HPP
+
+#include "APIEnvir.h"
+#include "ACAPinc.h"
+#include "GSRoot.hpp"
+
+// Связи операций над телами (SEO) в обе стороны: цель -> операторы и оператор -> цели.
+// Каждый запрос читает связи одного элемента через API, хранимого графа нет: не проверено,
+// что создание или снятие связи меняет modiStamp цели, а по устаревшему графу кеш метрик
+// и пропуск временных копий дали бы неверный gross. Проход по всему проекту не нужен.
+//
+// APIERR_NO3D (у элемента нет 3D-модели) означает «связей нет» и возвращается как NoError
+// с пустым списком. Прочие ошибки возвращаются как есть: «связи неизвестны» — не то же,
+// что «связей нет».
+namespace SeoLinks {
+
+    // Операторы цели
+    GSErrCode GetOperators (const API_Guid& target, GS::Array<API_Guid>& operators);
+
+    // Нужна ли цели временная копия для gross: операторы есть или прочитать их не удалось
+    bool MayHaveOperators (const API_Guid& target);
+
+    // Цели, которые режет оператор
+    GSErrCode GetTargets (const API_Guid& oper, GS::Array<API_Guid>& targets);
+
+} // namespace SeoLinks
+
+#endif // SEOLINKS_HPP
@@ -0,0 +1,247 @@
+#include "SeoLossReport.hpp"
+#include "SelectionMetricsHelper.hpp"
+#include "QuantityDescriptors.hpp"
+#include "NameCache.hpp"
+#include "LicenseManager.hpp"
+#include "ApiProfiler.hpp"
+#include "TraceLog.hpp"
+#include "Logger.hpp"
+
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+
+namespace SeoLossReport {
+
+// ---------------- Файл CSV ----------------
+static std::FILE* OpenForWrite (const GS::UniString& path)
+{
+#ifdef GS_WIN
+    return _wfopen (path.ToUStr ().Get (), L"wb");
+#else
+    return std::fopen (path.ToCStr (CC_UTF8).Get (), "wb");
+#endif
+}
+
+// Поле в кавычках, если в нём есть разделитель, кавычка или перевод строки
+static void AppendField (std::string& line, const GS::UniString& value)
+{
+    const std::string utf8 (value.ToCStr (CC_UTF8).Get ());
+    if (utf8.find_first_of (";\"\r\n") == std::string::npos) {
+        line += utf8;
+        return;
+    }
+    line += '"';
+    for (char c : utf8) {
+        if (c == '"')
+            line += '"';
+        line += c;
+    }
+    line += '"';
+}
+
+static void AppendNumber (std::string& line, double value)
+{
+    char buffer[32];
+    std::snprintf (buffer, sizeof (buffer), "%.6f", value);
+    line += buffer;
+}
+
+// ---------------- Имена этажей по floorInd ----------------
+static GS::HashTable<short, GS::UniString> GetStoryNames ()
+{
+    GS::HashTable<short, GS::UniString> names;
+    API_StoryInfo storyInfo = {};
+    if (API_CALL (ACAPI_ProjectSetting_GetStorySettings, &storyInfo) != NoError || storyInfo.data == nullptr)
+        return names;
+
+    const API_StoryType* stories = reinterpret_cast<API_StoryType*> (*storyInfo.data);
+    for (short i = 0; i <= storyInfo.lastStory - storyInfo.firstStory; ++i)
+        names.Add (stories[i].index, GS::UniString (stories[i].uName));
+    BMKillHandle ((GSHandle*) &storyInfo.data);
+    return names;
+}
+
+// Материал послойной метрики из ключа layer_<индекс>_volume; 0 — метрика всего элемента
+static Int32 MaterialFromKey (const GS::UniString& key)
+{
+    static const char Prefix[] = "layer_";
+    const std::string utf8 (key.ToCStr (CC_UTF8).Get ());
+    if (utf8.compare (0, sizeof (Prefix) - 1, Prefix) != 0)
+        return 0;
+    return static_cast<Int32> (std::strtol (utf8.c_str () + sizeof (Prefix) - 1, nullptr, 10));
+}
+
+// ---------------- Окно процесса ----------------
+class ProcessWindow {
+public:
+    ProcessWindow (const GS::UniString& title, const GS::UniString& phase, Int32 maxValue)
+    {
+        Int32 phaseCount = 1;
+        ACAPI_ProcessWindow_InitProcessWindow (&title, &phaseCount);
+        ACAPI_ProcessWindow_SetNextProcessPhase (&phase, &maxValue);
+    }
+
+    ~ProcessWindow ()
+    {
+        ACAPI_ProcessWindow_CloseProcessWindow ();
+    }
+
+    void SetValue (Int32 value)
+    {
+        ACAPI_ProcessWindow_SetProcessValue (&value);
+    }
+
+    bool IsCanceled () const
+    {
+        return ACAPI_ProcessWindow_IsProcessCanceled ();
+    }
+
+    ProcessWindow (const ProcessWindow&) = delete;
+    ProcessWindow& operator= (const ProcessWindow&) = delete;
+};
+
+// ---------------- Отчёт ----------------
+Result Export (const Options& options)
+{
+    API_OPERATION ("metrics");
+    TRACE_SPAN ("SeoLossReport", "metrics");
+
+    Result result;
+    result.filePath = options.filePath;
+    if (result.filePath.IsEmpty ()) {
+        const GS::UniString logDir = LicenseManager::GetLogDirectory ();
+        if (logDir.IsEmpty ())
+            return result;
+        result.filePath = logDir + "\\seo_loss_report.csv";
+    }
+    const UIndex batchSize = std::max<UIndex> (1, std::min (options.batchSize, MaxBatchSize));
+
+    // Только GUID всех элементов (16 байт на элемент); всё остальное — в пределах порции
+    GS::Array<API_Guid> guids;
+    for (const QuantityDescriptors::TypeDescriptor& descriptor : QuantityDescriptors::TypeTable) {
+        GS::Array<API_Guid> typeGuids;
+        if (API_CALL (ACAPI_Element_GetElemList, descriptor.typeID, &typeGuids) == NoError)
+            guids.Append (typeGuids);
+    }
+
+    std::FILE* file = OpenForWrite (result.filePath);
+    if (file == nullptr) {
+        LOG_ERROR ("[SeoLossReport] не удалось открыть %s", result.filePath.ToCStr (CC_UTF8).Get ());
+        return result;
+    }
+
+    bool writeOk = true;
+    auto write = [&] (const std::string& text) {
+        writeOk = writeOk && std::fwrite (text.data (), 1, text.size (), file) == text.size ();
+    };
+    write ("\xEF\xBB\xBF" "guid;id;layer;story;metric;material;gross;net;diff\n");
+
+    NameCache::BeginPass ();
+    const GS::HashTable<short, GS::UniString> storyNames = GetStoryNames ();
+
+    ProcessWindow progress ("Отчёт о потерях SEO", GS::UniString::Printf ("Элементов: %u", (unsigned) guids.GetSize ()),
+        static_cast<Int32> (guids.GetSize ()));
+
+    // Все порции — одна undo-команда: временные копии gross не забивают историю отмены
+    std::string line;
+    SelectionMetricsHelper::RunInOneUndoStep ("SEO loss report", [&] () -> GSErrCode {
+        for (UIndex batchStart = 0; batchStart < guids.GetSize (); batchStart += batchSize) {
+            if (progress.IsCanceled ()) {
+                result.cancelled = true;
+                break;
+            }
+            TRACE_SPAN ("report batch", "metrics");
+
+            const UIndex batchEnd = std::min (batchStart + batchSize, guids.GetSize ());
+            GS::Array<API_Guid> batch;
+            batch.SetCapacity (batchEnd - batchStart);
+            for (UIndex i = batchStart; i < batchEnd; ++i)
+                batch.Push (guids[i]);
+
+            const SelectionMetricsHelper::SelectionMetrics metrics = SelectionMetricsHelper::CollectForGuids (batch, false);
+            UInt32 writtenCount = 0;
+            for (const SelectionMetricsHelper::ElementMetrics& element : metrics.elements) {
+                API_Elem_Head head = {};
+                head.guid = element.guid;
+                if (API_CALL (ACAPI_Element_GetHeader, &head) != NoError)
+                    continue;
+                ++writtenCount;
+
+                GS::UniString elemID;
+                API_CALL (ACAPI_Element_GetElementInfoString, &head.guid, &elemID);
+                GS::UniString storyName;
+                if (!storyNames.Get (head.floorInd, &storyName))
+                    storyName = GS::UniString::Printf ("%d", (int) head.floorInd);
+                const GS::UniString& layerName = NameCache::GetString (NameCache::GetLayerName (head.layer));
+                const GS::UniString guidString = APIGuidToString (element.guid);
+
+                for (const SelectionMetricsHelper::Metric& metric : element.metrics) {
+                    const Int32 material = MaterialFromKey (metric.key);
+                    line.clear ();
+                    AppendField (line, guidString);
+                    line += ';';
+                    AppendField (line, elemID);
+                    line += ';';
+                    AppendField (line, layerName);
+                    line += ';';
+                    AppendField (line, storyName);
+                    line += ';';
+                    AppendField (line, metric.key);
+                    line += ';';
+                    if (material > 0)
+                        AppendField (line, NameCache::GetString (NameCache::GetBuildingMaterialName (ACAPI_CreateAttributeIndex (material))));
+                    line += ';';
+                    // gross не снят (копия не создалась) — пустые ячейки, а не нулевые потери
+                    if (!metric.grossPending)
+                        AppendNumber (line, metric.grossValue);
+                    line += ';';
+                    AppendNumber (line, metric.netValue);
+                    line += ';';
+                    if (!metric.grossPending)
+                        AppendNumber (line, metric.diffValue);
+                    line += '\n';
+                    write (line);
+                    ++result.rowCount;
+                }
+            }
+
+            // Элементы, не попавшие в файл, не считаются обработанными: отчёт иначе выглядел бы полным
+            const UInt32 unresolvedCount = batch.GetSize () - writtenCount;
+            if (unresolvedCount > 0) {
+                LOG_WARN ("[SeoLossReport] элементы %u-%u: без метрик %u", (unsigned) batchStart + 1, (unsigned) batchEnd,
+                    (unsigned) unresolvedCount);
+            }
+            result.elementCount += writtenCount;
+            result.unresolvedCount += unresolvedCount;
+            std::fflush (file);
+            progress.SetValue (static_cast<Int32> (batchEnd));
+            LOG_DEBUG ("[SeoLossReport] %u / %u элементов", (unsigned) batchEnd, (unsigned) guids.GetSize ());
+        }
+        return NoError;
+    });
+
+    result.ok = writeOk && std::fclose (file) == 0;
+    LOG_INFO ("[SeoLossReport] %s: элементов %u, без метрик %u, строк %u%s", result.filePath.ToCStr (CC_UTF8).Get (),
+        (unsigned) result.elementCount, (unsigned) result.unresolvedCount, (unsigned) result.rowCount,
+        result.cancelled ? " (прервано)" : "");
+    return result;
+}
+
+void RunFromMenu ()
+{
+    const Result result = Export (Options ());
+    if (!result.ok) {
+        ACAPI_WriteReport ("Отчёт о потерях SEO: не удалось записать файл.", true);
+        return;
+    }
+    ACAPI_WriteReport ("Отчёт о потерях SEO%s: элементов %u, строк %u. Файл: ", false,
+        result.cancelled ? " прерван" : "", (unsigned) result.elementCount, (unsigned) result.rowCount);
+    ACAPI_WriteReport (result.filePath.ToCStr ().Get (), false);
+    if (result.unresolvedCount > 0)
+        ACAPI_WriteReport ("Не вошли в отчёт (метрики не получены): %u элементов, подробности в журнале.", false,
+            (unsigned) result.unresolvedCount);
+}
+
+} // namespace SeoLossReport
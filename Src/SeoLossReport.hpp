@@ -0,0 +1,45 @@
+#ifndef SEOLOSSREPORT_HPP
+#define SEOLOSSREPORT_HPP
+
+#include "APIEnvir.h"
+#include "ACAPinc.h"
+#include "GSRoot.hpp"
+
+// Отчёт о потерях объёма и площади от операций над телами (SEO) по всему проекту.
+// Перебираются все элементы типов из QuantityDescriptors::TypeTable; net и gross считаются
+// порциями по batchSize (временные копии всех порций — в одной undo-команде отчёта), строки
+// сразу дописываются в CSV — память не растёт с размером проекта. Окно процесса Archicad
+// показывает ход и позволяет прервать отчёт; уже записанные строки остаются в файле.
+// MetricsCache отчёт не использует: проход по всему проекту вытеснил бы кеш палитры.
+//
+// CSV: UTF-8 с BOM, разделитель «;» (так его открывает Excel с русской локалью):
+//   guid;id;layer;story;metric;material;gross;net;diff
+// metric — ключ метрики (totalArea, topSurface, volume, layer_<материал>_volume),
+// material — строительный материал для послойных объёмов, пусто для элемента целиком.
+namespace SeoLossReport {
+
+    const UInt32 DefaultBatchSize = 500;
+    const UInt32 MaxBatchSize = 5000;
+
+    struct Options {
+        GS::UniString   filePath;                       // пусто — seo_loss_report.csv в каталоге логов
+        UInt32          batchSize = DefaultBatchSize;
+    };
+
+    struct Result {
+        GS::UniString   filePath;
+        UInt32          elementCount = 0;   // элементов в файле
+        UInt32          unresolvedCount = 0; // элементов без метрик (не прочитаны или порция не посчиталась)
+        UInt32          rowCount = 0;       // записано строк
+        bool            cancelled = false;
+        bool            ok = false;         // файл открыт и записан без ошибок
+    };
+
+    Result Export (const Options& options);
+
+    // Команда меню: отчёт с параметрами по умолчанию и итог в окне отчёта
+    void RunFromMenu ();
+
+} // namespace SeoLossReport
+
+#endif // SEOLOSSREPORT_HPP
@@ -0,0 +1,242 @@
+#include "SeoWatch.hpp"
+#include "SelectionDetailsPalette.hpp"
+#include "SeoLinks.hpp"
+#include "SelectionMetricsHelper.hpp"
+#include "ApiProfiler.hpp"
+#include "Logger.hpp"
+#include "HashTable.hpp"
+
+namespace SeoWatch {
+
+// ---------------- Наблюдаемые элементы ----------------
+// Один элемент может быть и целью, и оператором другой цели — наблюдатель снимается,
+// когда счётчик ссылок падает до нуля
+static GS::HashTable<GS::Guid, GS::Array<API_Guid>>    s_targetOperators;  // цель -> её SEO-операторы
+static GS::HashTable<GS::Guid, GS::Array<API_Guid>>    s_operatorTargets;  // оператор -> цели
+static GS::HashTable<GS::Guid, UInt32>                 s_observerRefs;
+static GS::HashTable<GS::Guid, UInt64>                 s_stamps;           // наблюдаемый элемент -> последний modiStamp
+static GS::HashTable<GS::Guid, API_Guid>               s_staleTargets;     // цели, чьи метрики в палитре устарели
+static bool                                            s_handlerInstalled = false;
+
+static UInt64 GetModiStamp (const API_Guid& guid)
+{
+    API_Elem_Head head = {};
+    head.guid = guid;
+    return (API_CALL (ACAPI_Element_GetHeader, &head) == NoError) ? head.modiStamp : 0;
+}
+
+static void Observe (const API_Guid& guid)
+{
+    const GS::Guid key = APIGuid2GSGuid (guid);
+    UInt32* refs = s_observerRefs.GetPtr (key);
+    if (refs != nullptr) {
+        ++*refs;
+        return;
+    }
+    if (API_CALL (ACAPI_Element_AttachObserver, guid, 0) == NoError) {
+        s_observerRefs.Add (key, 1);
+        s_stamps.Put (key, GetModiStamp (guid));
+    }
+}
+
+static void Unobserve (const API_Guid& guid)
+{
+    const GS::Guid key = APIGuid2GSGuid (guid);
+    UInt32* refs = s_observerRefs.GetPtr (key);
+    if (refs == nullptr)
+        return;
+    if (--*refs == 0) {
+        s_observerRefs.Delete (key);
+        s_stamps.Delete (key);
+        API_CALL (ACAPI_Element_DetachObserver, guid);
+    }
+}
+
+static void RemoveFromArray (GS::Array<API_Guid>& guids, const API_Guid& guid)
+{
+    for (UIndex i = guids.GetSize (); i > 0; --i) {
+        if (guids[i - 1] == guid)
+            guids.Delete (i - 1);
+    }
+}
+
+static void Unsubscribe (const API_Guid& target)
+{
+    const GS::Guid key = APIGuid2GSGuid (target);
+    const GS::Array<API_Guid>* operators = s_targetOperators.GetPtr (key);
+    if (operators == nullptr)
+        return;
+
+    for (const API_Guid& oper : *operators) {
+        const GS::Guid operKey = APIGuid2GSGuid (oper);
+        if (GS::Array<API_Guid>* targets = s_operatorTargets.GetPtr (operKey)) {
+            RemoveFromArray (*targets, target);
+            if (targets->IsEmpty ())
+                s_operatorTargets.Delete (operKey);
+        }
+        Unobserve (oper);
+    }
+    s_targetOperators.Delete (key);
+    Unobserve (target);
+}
+
+// Наблюдать цель и её текущих операторов (после изменения набор операторов перечитывается)
+static void Subscribe (const API_Guid& target)
+{
+    Unsubscribe (target);
+
+    // Операторы не прочитаны — наблюдаем хотя бы саму цель; при следующей её правке список перечитается
+    GS::Array<API_Guid> operators;
+    const GSErrCode err = SeoLinks::GetOperators (target, operators);
+    if (err != NoError)
+        LOG_WARN ("[SeoWatch] операторы %s не прочитаны: %d", APIGuidToString (target).ToCStr (CC_UTF8).Get (), static_cast<int> (err));
+
+    Observe (target);
+    for (const API_Guid& oper : operators) {
+        Observe (oper);
+        const GS::Guid operKey = APIGuid2GSGuid (oper);
+        if (!s_operatorTargets.ContainsKey (operKey))
+            s_operatorTargets.Add (operKey, GS::Array<API_Guid> ());
+        s_operatorTargets.GetPtr (operKey)->Push (target);
+    }
+    s_targetOperators.Add (APIGuid2GSGuid (target), operators);
+}
+
+// Уведомление об изменении, после которого modiStamp элемента остался прежним, пересчёта
+// не требует. Так отсекаются и уведомления от собственных правок расчёта gross (связи SEO
+// временных копий), если они доходят уже после выхода из команды
+static bool IsStampUnchanged (const API_Guid& guid)
+{
+    UInt64* known = s_stamps.GetPtr (APIGuid2GSGuid (guid));
+    if (known == nullptr)
+        return false;
+    const UInt64 stamp = GetModiStamp (guid);
+    if (stamp != 0 && stamp == *known)
+        return true;
+    *known = stamp;
+    return false;
+}
+
+// ---------------- Уведомления об элементах ----------------
+static GSErrCode __ACENV_CALL ElementEventHandler (const API_NotifyElementType* elemType)
+{
+    // Копии, которые создаёт и связывает сам расчёт gross, не считаются правкой пользователя
+    if (elemType == nullptr || SelectionMetricsHelper::IsCreatingTemporaryCopies ())
+        return NoError;
+
+    const API_Guid guid = elemType->elemHead.guid;
+    const GS::Guid key = APIGuid2GSGuid (guid);
+    const bool isTarget = s_targetOperators.ContainsKey (key);
+
+    GS::Array<API_Guid> affected;
+    if (const GS::Array<API_Guid>* targets = s_operatorTargets.GetPtr (key))
+        affected = *targets;
+
+    switch (elemType->notifID) {
+        case APINotifyElement_Delete:
+        case APINotifyElement_Undo_Deleted:
+        case APINotifyElement_Redo_Deleted:
+            // Удалённая цель больше не показывается; удалённый оператор меняет метрики целей
+            if (isTarget)
+                Unsubscribe (guid);
+            break;
+        case APINotifyElement_Change:
+        case APINotifyElement_Edit:
+        case APINotifyElement_Undo_Modified:
+        case APINotifyElement_Redo_Modified:
+            if (IsStampUnchanged (guid))
+                return NoError;
+            if (isTarget)
+                affected.Push (guid);
+            break;
+        default:
+            return NoError;
+    }
+    if (affected.IsEmpty ())
+        return NoError;
+
+    // Только пометка: undo-команда пересчёта здесь встала бы в историю сразу за правкой пользователя
+    for (const API_Guid& target : affected) {
+        Subscribe (target);
+        s_staleTargets.Put (APIGuid2GSGuid (target), target);
+    }
+    LOG_DEBUG ("[SeoWatch] изменение %s: устарели метрики %u элементов", APIGuidToString (guid).ToCStr (CC_UTF8).Get (),
+        static_cast<unsigned> (affected.GetSize ()));
+    SelectionDetailsPalette::NotifySeoMetricsStale ();
+    return NoError;
+}
+
+// ---------------- Управление ----------------
+void Watch (const GS::Array<API_Guid>& targets)
+{
+    Stop ();
+    if (targets.IsEmpty ())
+        return;
+
+    if (!s_handlerInstalled) {
+        const GSErrCode err = ACAPI_Notification_InstallElementObserver (ElementEventHandler);
+        if (err != NoError) {
+            LOG_WARN ("[SeoWatch] не удалось установить обработчик уведомлений: %d", static_cast<int> (err));
+            return;
+        }
+        s_handlerInstalled = true;
+    }
+
+    for (const API_Guid& target : targets)
+        Subscribe (target);
+    LOG_DEBUG ("[SeoWatch] слежение за %u элементами, наблюдателей %u", static_cast<unsigned> (targets.GetSize ()),
+        static_cast<unsigned> (s_observerRefs.GetSize ()));
+}
+
+void Stop ()
+{
+    for (auto it = s_observerRefs.EnumeratePairs (); it != nullptr; ++it)
+        API_CALL (ACAPI_Element_DetachObserver, GSGuid2APIGuid (*it->key));
+    s_observerRefs.Clear ();
+    s_stamps.Clear ();
+    s_targetOperators.Clear ();
+    s_operatorTargets.Clear ();
+    s_staleTargets.Clear ();
+}
+
+bool IsActive ()
+{
+    return !s_targetOperators.IsEmpty ();
+}
+
+UInt32 GetTargetCount ()
+{
+    return static_cast<UInt32> (s_targetOperators.GetSize ());
+}
+
+GS::Array<API_Guid> TakeStale ()
+{
+    GS::Array<API_Guid> stale;
+    stale.SetCapacity (s_staleTargets.GetSize ());
+    for (auto it = s_staleTargets.EnumeratePairs (); it != nullptr; ++it)
+        stale.Push (*it->value);
+    s_staleTargets.Clear ();
+    return stale;
+}
+
+void HandleProjectEvent (API_NotifyEventID notifID)
+{
+    switch (notifID) {
+        case APINotify_New:
+        case APINotify_NewAndReset:
+        case APINotify_Open:
+        case APINotify_Close:
+        case APINotify_Quit:
+            // Наблюдатели принадлежат закрытому проекту — снимать их через API уже незачем
+            s_observerRefs.Clear ();
+            s_stamps.Clear ();
+            s_targetOperators.Clear ();
+            s_operatorTargets.Clear ();
+            s_staleTargets.Clear ();
+            break;
+        default:
+            break;
+    }
+}
+
+} // namespace SeoWatch
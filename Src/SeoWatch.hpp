@@ -0,0 +1,34 @@
+#ifndef SEOWATCH_HPP
+#define SEOWATCH_HPP
+
+#include "APIEnvir.h"
+#include "ACAPinc.h"
+#include "GSRoot.hpp"
+
+// Слежение за SEO-метриками элементов, показанных в палитре (включается палитрой).
+// На сами элементы и на их SEO-операторы вешаются наблюдатели Archicad; изменение,
+// удаление, отмена или повтор правки любого из них только помечает затронутые элементы
+// устаревшими и сообщает палитре (OnSeoMetricsStale()). Пересчёт сразу не запускается:
+// расчёт gross — это undo-команда с временными копиями, которая после правки забрала бы
+// первый Ctrl+Z, а после Undo стёрла бы историю повтора. Пересчитывает палитра по запросу
+// пользователя — TakeStale и GrossMetricsJob.
+namespace SeoWatch {
+
+    // Следить за этими элементами (заменяет прежний набор); пустой набор — выключить
+    void Watch (const GS::Array<API_Guid>& targets);
+
+    // Снять всех наблюдателей (выключение режима, закрытие проекта)
+    void Stop ();
+
+    bool IsActive ();
+    UInt32 GetTargetCount ();
+
+    // Элементы, помеченные устаревшими с прошлого вызова; пометка снимается
+    GS::Array<API_Guid> TakeStale ();
+
+    // Реакция на событие проекта (вызывается из общего обработчика BrowserRepl)
+    void HandleProjectEvent (API_NotifyEventID notifID);
+
+} // namespace SeoWatch
+
+#endif // SEOWATCH_HPP
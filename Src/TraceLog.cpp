@@ -0,0 +1,136 @@
+#include "TraceLog.hpp"
+
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <vector>
+
+namespace TraceLog {
+
+// Имя копируется в событие: имена из палитры приходят строками и не живут дольше вызова
+struct Event {
+    char    name[64];
+    char    category[16];
+    UInt64  startUs;
+    UInt64  durationUs;
+    Track   track;
+};
+
+static std::atomic<bool>    s_enabled { false };
+static std::vector<Event>   s_events;
+static std::atomic<UInt64>  s_written { 0 };   // всего записано; позиция = s_written % BufferCapacity
+
+static std::chrono::steady_clock::time_point Origin ()
+{
+    static const std::chrono::steady_clock::time_point origin = std::chrono::steady_clock::now ();
+    return origin;
+}
+
+bool IsEnabled ()
+{
+    return s_enabled.load (std::memory_order_relaxed);
+}
+
+void SetEnabled (bool enabled)
+{
+    if (enabled && s_events.empty ())
+        s_events.resize (BufferCapacity);
+    Origin ();
+    s_enabled.store (enabled, std::memory_order_relaxed);
+}
+
+UInt64 NowUs ()
+{
+    return static_cast<UInt64> (std::chrono::duration_cast<std::chrono::microseconds> (std::chrono::steady_clock::now () - Origin ()).count ());
+}
+
+// Копия с обрезкой, не разрывающей многобайтовый символ UTF-8
+static void CopyName (char* dst, std::size_t capacity, const char* src)
+{
+    std::size_t length = (src != nullptr) ? std::strlen (src) : 0;
+    if (length >= capacity) {
+        length = capacity - 1;
+        while (length > 0 && (static_cast<unsigned char> (src[length]) & 0xC0) == 0x80)
+            --length;
+    }
+    if (length > 0)
+        std::memcpy (dst, src, length);
+    dst[length] = '\0';
+}
+
+// ---------------- Запись события ----------------
+void AddSpan (const char* name, const char* category, UInt64 startUs, UInt64 durationUs, Track track)
+{
+    if (!IsEnabled () || s_events.empty ())
+        return;
+
+    const UInt64 index = s_written.fetch_add (1, std::memory_order_relaxed);
+    Event& event = s_events[static_cast<std::size_t> (index % BufferCapacity)];
+    CopyName (event.name, sizeof (event.name), name);
+    CopyName (event.category, sizeof (event.category), category);
+    event.startUs = startUs;
+    event.durationUs = durationUs;
+    event.track = track;
+}
+
+UInt32 GetEventCount ()
+{
+    const UInt64 written = s_written.load (std::memory_order_relaxed);
+    return static_cast<UInt32> (written < BufferCapacity ? written : BufferCapacity);
+}
+
+void Clear ()
+{
+    s_written.store (0, std::memory_order_relaxed);
+}
+
+// ---------------- Выгрузка ----------------
+static void WriteEscaped (FILE* fp, const char* text)
+{
+    for (const char* p = text; *p != '\0'; ++p) {
+        const unsigned char ch = static_cast<unsigned char> (*p);
+        if (ch == '"' || ch == '\\')
+            std::fprintf (fp, "\\%c", ch);
+        else if (ch < 0x20)
+            std::fprintf (fp, "\\u%04x", ch);
+        else
+            std::fputc (ch, fp);
+    }
+}
+
+bool WriteChromeTrace (const GS::UniString& filePath)
+{
+#ifdef GS_WIN
+    FILE* fp = _wfopen (filePath.ToUStr ().Get (), L"w");
+#else
+    FILE* fp = fopen (filePath.ToCStr ().Get (), "w");
+#endif
+    if (fp == nullptr)
+        return false;
+
+    std::fputs ("{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n", fp);
+    std::fputs ("{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":1,\"args\":{\"name\":\"Add-on (C++)\"}},\n", fp);
+    std::fputs ("{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":2,\"args\":{\"name\":\"Palette (JS)\"}}", fp);
+
+    // От самого старого события к самому новому
+    const UInt64 written = s_written.load (std::memory_order_relaxed);
+    const UInt64 count = GetEventCount ();
+    for (UInt64 i = written - count; i < written; ++i) {
+        const Event& event = s_events[static_cast<std::size_t> (i % BufferCapacity)];
+        std::fputs (",\n{\"name\":\"", fp);
+        WriteEscaped (fp, event.name);
+        std::fputs ("\",\"cat\":\"", fp);
+        WriteEscaped (fp, event.category);
+        std::fprintf (fp, "\",\"ph\":\"X\",\"pid\":1,\"tid\":%u,\"ts\":%llu,\"dur\":%llu}",
+            static_cast<unsigned> (event.track),
+            static_cast<unsigned long long> (event.startUs),
+            static_cast<unsigned long long> (event.durationUs));
+    }
+
+    std::fputs ("\n]}\n", fp);
+    std::fclose (fp);
+    return true;
+}
+
+} // namespace TraceLog
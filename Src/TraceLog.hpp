@@ -0,0 +1,68 @@
+#ifndef TRACELOG_HPP
+#define TRACELOG_HPP
+
+#include "APIEnvir.h"
+#include "ACAPinc.h"
+#include "GSRoot.hpp"
+
+// Трассировка операций во времени: интервалы (span) пишутся в кольцевой буфер и по запросу
+// выгружаются в JSON формата Chrome trace-event (chrome://tracing, ui.perfetto.dev).
+// При выключенной трассировке TRACE_SPAN стоит одной проверки флага.
+//
+//   TRACE_SPAN ("PlaceSelectionOnLayout", "layout");
+namespace TraceLog {
+
+    // Дорожки на временной шкале: сторона C++ и сторона палитры (JS)
+    enum class Track : UInt32 { Native = 1, Palette = 2 };
+
+    const UInt32 BufferCapacity = 1 << 16;  // последние события; старые перезаписываются
+
+    bool IsEnabled ();
+    void SetEnabled (bool enabled);
+
+    // Микросекунды от первого обращения к трассировке
+    UInt64 NowUs ();
+
+    // Записать завершённый интервал
+    void AddSpan (const char* name, const char* category, UInt64 startUs, UInt64 durationUs, Track track = Track::Native);
+
+    class Span {
+    public:
+        Span (const char* name, const char* category) :
+            name (name),
+            category (category),
+            active (IsEnabled ()),
+            startUs (active ? NowUs () : 0)
+        {
+        }
+
+        ~Span ()
+        {
+            if (active)
+                AddSpan (name, category, startUs, NowUs () - startUs);
+        }
+
+        Span (const Span&) = delete;
+        Span& operator= (const Span&) = delete;
+
+    private:
+        const char* name;
+        const char* category;
+        bool        active;
+        UInt64      startUs;
+    };
+
+    // Число событий в буфере и очистка
+    UInt32 GetEventCount ();
+    void Clear ();
+
+    // Выгрузка в файл Chrome trace-event JSON
+    bool WriteChromeTrace (const GS::UniString& filePath);
+
+} // namespace TraceLog
+
+#define TRACE_SPAN_CONCAT_(a, b) a##b
+#define TRACE_SPAN_NAME_(line) TRACE_SPAN_CONCAT_ (traceSpan_, line)
+#define TRACE_SPAN(name, category) TraceLog::Span TRACE_SPAN_NAME_ (__LINE__) (name, category)
+
+#endif // TRACELOG_HPP
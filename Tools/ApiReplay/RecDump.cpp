@@ -0,0 +1,92 @@
+// tolayout_recdump — сводка по записи вызовов ACAPI (tolayout_api.rec).
+//
+//   tolayout_recdump <file.rec> [--calls]
+//
+// Выводит число вызовов, записанное время и объём данных по каждой функции;
+// с --calls дополнительно печатает вызовы по порядку.
+
+#include "ApiRecordFormat.hpp"
+
+#include <algorithm>
+#include <cinttypes>
+#include <cstdio>
+#include <cstring>
+#include <string>
+#include <vector>
+
+namespace {
+
+struct FunctionSummary {
+    std::string     name;
+    std::uint64_t   calls = 0;
+    std::uint64_t   errors = 0;
+    std::uint64_t   totalUs = 0;
+    std::uint64_t   bytes = 0;
+};
+
+std::uint64_t PayloadBytes (const ApiRecordFormat::CallRecord& call)
+{
+    std::uint64_t bytes = 0;
+    for (const ApiRecordFormat::ArgBlob& arg : call.args)
+        bytes += arg.data.size ();
+    return bytes;
+}
+
+const char* FunctionName (const ApiRecordFormat::Recording& recording, std::uint16_t id)
+{
+    return id < recording.functions.size () ? recording.functions[id].c_str () : "?";
+}
+
+} // namespace
+
+int main (int argc, char** argv)
+{
+    if (argc < 2) {
+        std::fprintf (stderr, "usage: %s <file.rec> [--calls]\n", argv[0]);
+        return 2;
+    }
+    const bool printCalls = (argc > 2 && std::strcmp (argv[2], "--calls") == 0);
+
+    ApiRecordFormat::Recording recording;
+    std::string error;
+    if (!ApiRecordFormat::Read (argv[1], recording, &error)) {
+        std::fprintf (stderr, "%s: %s (read %zu calls)\n", argv[1], error.c_str (), recording.calls.size ());
+        if (recording.calls.empty ())
+            return 1;
+    }
+
+    std::vector<FunctionSummary> summary (recording.functions.size ());
+    for (std::size_t i = 0; i < summary.size (); ++i)
+        summary[i].name = recording.functions[i];
+
+    std::uint64_t totalUs = 0;
+    for (std::size_t i = 0; i < recording.calls.size (); ++i) {
+        const ApiRecordFormat::CallRecord& call = recording.calls[i];
+        if (printCalls) {
+            std::printf ("%8zu  %-48s in=%016" PRIx64 " err=%-8d %8" PRIu32 " us  %" PRIu64 " bytes\n",
+                i, FunctionName (recording, call.function), call.inputHash, static_cast<int> (call.result), call.elapsedUs, PayloadBytes (call));
+        }
+        if (call.function >= summary.size ())
+            continue;
+        FunctionSummary& item = summary[call.function];
+        ++item.calls;
+        item.errors += (call.result != 0) ? 1 : 0;
+        item.totalUs += call.elapsedUs;
+        item.bytes += PayloadBytes (call);
+        totalUs += call.elapsedUs;
+    }
+
+    std::sort (summary.begin (), summary.end (), [] (const FunctionSummary& a, const FunctionSummary& b) { return a.totalUs > b.totalUs; });
+
+    std::printf ("%zu calls, %zu functions, %.2f ms recorded inside Archicad\n\n",
+        recording.calls.size (), recording.functions.size (), static_cast<double> (totalUs) / 1000.0);
+    std::printf ("%10s %8s %8s %10s %12s  %s\n", "total ms", "calls", "errors", "us/call", "bytes", "function");
+    for (const FunctionSummary& item : summary) {
+        if (item.calls == 0)
+            continue;
+        std::printf ("%10.2f %8" PRIu64 " %8" PRIu64 " %10.1f %12" PRIu64 "  %s\n",
+            static_cast<double> (item.totalUs) / 1000.0, item.calls, item.errors,
+            static_cast<double> (item.totalUs) / static_cast<double> (item.calls), item.bytes, item.name.c_str ());
+    }
+    return 0;
+}
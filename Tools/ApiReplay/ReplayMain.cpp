@@ -0,0 +1,132 @@
+// tolayout_replay — прогон кода LayoutHelper / LayerHelper / SelectionHelper без Archicad.
+//
+//   tolayout_replay <file.rec> [scenario] [iterations]
+//
+// Все API_CALL отвечают данными из записи (сборка с TOLAYOUT_API_REPLAY), поэтому время
+// прогона — это только время кода дополнения и не зависит от проекта и состояния Archicad.
+// Удобно запускать под perf / valgrind --tool=callgrind.
+//
+// Ответ ищется по функции и хэшу входных аргументов. Если код дополнения вызвал функцию
+// с аргументами, которых нет в записи, прогон завершается с кодом 3: замер на чужих данных
+// ничего не стоит, запись нужно снять заново.
+//
+// Сценарии: layouts, selection, layers, place, layer-move, all (по умолчанию).
+
+#include "APIEnvir.h"
+#include "ACAPinc.h"
+#include "ApiRecorder.hpp"
+#include "LayoutHelper.hpp"
+#include "LayerHelper.hpp"
+#include "SelectionHelper.hpp"
+#include "NameCache.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+
+namespace {
+
+struct Scenario {
+    const char* name;
+    void        (*run) ();
+};
+
+void RunLayouts ()
+{
+    LayoutHelper::RequestCacheScope cacheScope;
+    LayoutHelper::GetLayoutList ();
+    LayoutHelper::GetLayoutFolders ();
+    LayoutHelper::GetMasterLayoutList ();
+    LayoutHelper::GetPlaceableViews ();
+}
+
+void RunSelection ()
+{
+    NameCache::BeginPass ();
+    SelectionHelper::GetSelectedElements ();
+}
+
+void RunLayers ()
+{
+    LayerHelper::GetLayersList ();
+}
+
+void RunPlace ()
+{
+    LayoutHelper::PlaceSelectionOnLayoutByIndex (0);
+}
+
+void RunLayerMove ()
+{
+    LayerHelper::LayerCreationParams params;
+    params.folderPath = "Replay/Folder";
+    params.layerName = "Replay layer";
+    params.baseID = "R";
+    LayerHelper::CreateLayerAndMoveElements (params);
+}
+
+const Scenario Scenarios[] = {
+    { "layouts",    RunLayouts },
+    { "selection",  RunSelection },
+    { "layers",     RunLayers },
+    { "place",      RunPlace },
+    { "layer-move", RunLayerMove },
+};
+
+bool RunScenario (const Scenario& scenario, int iterations)
+{
+    const std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now ();
+    for (int i = 0; i < iterations; ++i) {
+        ApiRecorder::RewindReplay ();
+        scenario.run ();
+        if (ApiRecorder::GetReplayStats ().mismatches > 0) {
+            std::fprintf (stderr, "%s: API call with arguments missing from the recording (see log), stopped at iteration %d\n",
+                scenario.name, i + 1);
+            return false;
+        }
+    }
+    const double totalMs = std::chrono::duration<double, std::milli> (std::chrono::steady_clock::now () - start).count ();
+    std::printf ("%-12s %6d iterations  %10.3f ms total  %10.4f ms/iteration\n",
+        scenario.name, iterations, totalMs, totalMs / iterations);
+    return true;
+}
+
+} // namespace
+
+int main (int argc, char** argv)
+{
+    if (argc < 2) {
+        std::fprintf (stderr, "usage: %s <file.rec> [layouts|selection|layers|place|layer-move|all] [iterations]\n", argv[0]);
+        return 2;
+    }
+    const std::string scenarioName = (argc > 2) ? argv[2] : "all";
+    const int iterations = (argc > 3) ? std::max (1, std::atoi (argv[3])) : 100;
+
+    std::string error;
+    if (!ApiRecorder::LoadReplay (argv[1], &error)) {
+        std::fprintf (stderr, "%s: %s\n", argv[1], error.c_str ());
+        return 1;
+    }
+
+    bool found = false;
+    for (const Scenario& scenario : Scenarios) {
+        if (scenarioName == "all" || scenarioName == scenario.name) {
+            found = true;
+            if (!RunScenario (scenario, iterations))
+                break;
+        }
+    }
+    if (!found) {
+        std::fprintf (stderr, "unknown scenario: %s\n", scenarioName.c_str ());
+        return 2;
+    }
+
+    const ApiRecorder::ReplayStats stats = ApiRecorder::GetReplayStats ();
+    std::printf ("replayed %llu API calls, %llu calls to functions missing from the recording, %llu input mismatches\n",
+        static_cast<unsigned long long> (stats.calls), static_cast<unsigned long long> (stats.misses),
+        static_cast<unsigned long long> (stats.mismatches));
+    return (stats.mismatches > 0) ? 3 : 0;
+}
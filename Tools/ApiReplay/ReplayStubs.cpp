@@ -0,0 +1,37 @@
+// Заглушки функций ACAPI, которые вызываются не через API_CALL.
+// Сигнатуры повторяют объявления ACAPinc.h (DevKit 27).
+
+#include "APIEnvir.h"
+#include "ACAPinc.h"
+
+#include <cstdarg>
+#include <cstdio>
+#include <cstdlib>
+#include <functional>
+
+// Отчёты печатаются только при TOLAYOUT_REPLAY_VERBOSE=1, чтобы не искажать замеры
+GSErrCode ACAPI_WriteReport (const GS::UniString& format, bool withDial, ...)
+{
+    static const bool verbose = (std::getenv ("TOLAYOUT_REPLAY_VERBOSE") != nullptr);
+    if (!verbose)
+        return NoError;
+
+    va_list args;
+    va_start (args, withDial);
+    std::vfprintf (stderr, format.ToCStr (CC_UTF8).Get (), args);
+    va_end (args);
+    std::fputc ('\n', stderr);
+    return NoError;
+}
+
+// Undo-группы в воспроизведении не нужны — команда выполняется сразу
+GSErrCode ACAPI_CallUndoableCommand (const GS::UniString& /*undoString*/, const std::function<GSErrCode ()>& command)
+{
+    return command ();
+}
+
+// Определения атрибутов в запись не попадают (ApiRecorder::Detail::Codec), освобождать нечего
+GSErrCode ACAPI_DisposeAttrDefsHdls (API_AttributeDefExt* /*defs*/)
+{
+    return NoError;
+}
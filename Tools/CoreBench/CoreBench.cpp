@@ -0,0 +1,316 @@
+// tolayout_corebench — микробенчмарки чистой логики дополнения (Src/Core).
+//
+//   tolayout_corebench [--seed N] [--repetitions N] [--filter substring] [--out file.json]
+//
+// Входные данные генерируются из фиксированного seed, поэтому два прогона одной сборки
+// считают одно и то же (поле checksum совпадает). Результат — JSON, время — медиана повторов:
+//
+//   { "seed": 1, "repetitions": 5, "benchmarks": [
+//       { "name": "grid_region_rect", "items": 4096, "iterations": 200, "ns_per_item": 3.1, "checksum": 123.4 }, ... ] }
+
+#include "PlacementMath.hpp"
+#include "FolderPath.hpp"
+#include "LayoutGrouping.hpp"
+#include "LayerVolumes.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <functional>
+#include <memory>
+#include <random>
+#include <string>
+#include <vector>
+
+namespace {
+
+using Random = std::mt19937;
+
+struct Benchmark {
+    const char*                 name;
+    std::size_t                 items;          // элементов входных данных на итерацию
+    int                         iterations;
+    std::function<double ()>    run;            // одна итерация; возвращает контрольную сумму
+};
+
+struct Result {
+    std::string name;
+    std::size_t items = 0;
+    int         iterations = 0;
+    double      nsPerItem = 0.0;
+    double      checksum = 0.0;
+};
+
+// ---- Входные данные ----
+
+PlacementMath::Sheet RandomSheet (Random& random)
+{
+    static const double sizes[][2] = { { 210, 297 }, { 297, 420 }, { 420, 594 }, { 594, 841 }, { 841, 1189 } };
+    const auto& size = sizes[std::uniform_int_distribution<int> (0, 4) (random)];
+    const bool landscape = std::bernoulli_distribution (0.5) (random);
+    std::uniform_real_distribution<double> margin (5.0, 25.0);
+
+    PlacementMath::Sheet sheet;
+    sheet.sizeX = landscape ? size[1] : size[0];
+    sheet.sizeY = landscape ? size[0] : size[1];
+    sheet.leftMargin = margin (random);
+    sheet.rightMargin = margin (random);
+    sheet.topMargin = margin (random);
+    sheet.bottomMargin = margin (random);
+    return sheet;
+}
+
+struct GridInput {
+    PlacementMath::Sheet    sheet;
+    int                     rows, cols, startRow, startCol, spanRows, spanCols;
+    double                  gap;
+};
+
+struct PlacementInput {
+    PlacementMath::Sheet    sheet;
+    PlacementMath::Anchor   anchor;
+    double                  extentW, extentH;
+};
+
+std::vector<GridInput> MakeGridInputs (Random& random, std::size_t count)
+{
+    std::vector<GridInput> inputs (count);
+    std::uniform_int_distribution<int> cells (1, 4);
+    for (GridInput& input : inputs) {
+        input.sheet = RandomSheet (random);
+        input.rows = cells (random);
+        input.cols = cells (random);
+        input.startRow = std::uniform_int_distribution<int> (0, input.rows - 1) (random);
+        input.startCol = std::uniform_int_distribution<int> (0, input.cols - 1) (random);
+        input.spanRows = std::uniform_int_distribution<int> (1, input.rows - input.startRow) (random);
+        input.spanCols = std::uniform_int_distribution<int> (1, input.cols - input.startCol) (random);
+        input.gap = std::uniform_real_distribution<double> (0.0, 10.0) (random);
+    }
+    return inputs;
+}
+
+std::vector<PlacementInput> MakePlacementInputs (Random& random, std::size_t count)
+{
+    std::vector<PlacementInput> inputs (count);
+    std::uniform_real_distribution<double> extent (0.5, 200.0);
+    for (PlacementInput& input : inputs) {
+        input.sheet = RandomSheet (random);
+        input.anchor = static_cast<PlacementMath::Anchor> (std::uniform_int_distribution<int> (0, 4) (random));
+        input.extentW = extent (random);
+        input.extentH = extent (random);
+    }
+    return inputs;
+}
+
+std::string RandomFolderPath (Random& random)
+{
+    static const char* const roots[] = { "", "Слои/", "Layers/" };
+    static const char* const words[] = { "АР", "КР", "Стены", "Перекрытия", "Отделка", "Mechanical", "Site", "Annotation" };
+    std::string path = roots[std::uniform_int_distribution<int> (0, 2) (random)];
+    const int depth = std::uniform_int_distribution<int> (1, 8) (random);
+    for (int i = 0; i < depth; ++i) {
+        if (i > 0)
+            path += '/';
+        path += words[std::uniform_int_distribution<int> (0, 7) (random)];
+        path += std::to_string (std::uniform_int_distribution<int> (1, 99) (random));
+    }
+    return path;
+}
+
+std::vector<std::string> MakeLayoutNames (Random& random, std::size_t count)
+{
+    std::vector<std::string> names (count);
+    std::uniform_int_distribution<int> folder (1, 400);
+    std::bernoulli_distribution inFolder (0.85);
+    for (std::size_t i = 0; i < count; ++i) {
+        const std::string sheet = "Лист " + std::to_string (i + 1);
+        names[i] = inFolder (random) ? "Раздел " + std::to_string (folder (random)) + "/" + sheet : sheet;
+    }
+    return names;
+}
+
+struct CompositeInput {
+    std::vector<LayerVolumes::Component>    gross;
+    std::vector<LayerVolumes::Component>    net;
+    double                                  grossVolume, netVolume;
+};
+
+std::vector<CompositeInput> MakeCompositeInputs (Random& random, std::size_t count)
+{
+    std::vector<CompositeInput> inputs (count);
+    std::uniform_int_distribution<int> layers (1, 12);
+    std::uniform_int_distribution<int> material (0, 200);
+    std::uniform_real_distribution<double> volume (0.0, 5.0);
+    std::uniform_real_distribution<double> seoLoss (0.6, 1.0);
+    for (CompositeInput& input : inputs) {
+        const int layerCount = layers (random);
+        double total = 0.0;
+        for (int i = 0; i < layerCount; ++i) {
+            LayerVolumes::Component component;
+            component.material = material (random);
+            component.volume = volume (random);
+            total += component.volume;
+            input.gross.push_back (component);
+            component.volume *= seoLoss (random);
+            input.net.push_back (component);
+        }
+        input.grossVolume = total * 1.02;
+        input.netVolume = total * 0.9;
+    }
+    return inputs;
+}
+
+// ---- Набор ----
+
+std::vector<Benchmark> MakeBenchmarks (std::uint32_t seed)
+{
+    Random random (seed);
+    const auto grid = std::make_shared<std::vector<GridInput>> (MakeGridInputs (random, 4096));
+    const auto placement = std::make_shared<std::vector<PlacementInput>> (MakePlacementInputs (random, 4096));
+    auto paths = std::make_shared<std::vector<std::string>> ();
+    for (int i = 0; i < 2048; ++i)
+        paths->push_back (RandomFolderPath (random));
+    const auto layoutNames = std::make_shared<std::vector<std::string>> (MakeLayoutNames (random, 6000));
+    const auto composites = std::make_shared<std::vector<CompositeInput>> (MakeCompositeInputs (random, 2048));
+
+    std::vector<Benchmark> benchmarks;
+    benchmarks.push_back ({ "grid_region_rect", grid->size (), 2000, [grid] () {
+        double sum = 0.0;
+        for (const GridInput& in : *grid) {
+            const PlacementMath::Rect rect = PlacementMath::GridRegionRect (in.sheet, in.rows, in.cols, in.gap,
+                in.startRow, in.startCol, in.spanRows, in.spanCols);
+            sum += rect.left + rect.bottom + rect.width + rect.height;
+        }
+        return sum;
+    } });
+    benchmarks.push_back ({ "drawing_origin", placement->size (), 2000, [placement] () {
+        double sum = 0.0;
+        for (const PlacementInput& in : *placement) {
+            const PlacementMath::Point origin = PlacementMath::DrawingOrigin (in.sheet, in.anchor, in.extentW * 0.01, in.extentH * 0.01);
+            sum += origin.x + origin.y;
+        }
+        return sum;
+    } });
+    benchmarks.push_back ({ "fit_scale", placement->size (), 2000, [placement] () {
+        double sum = 0.0;
+        for (const PlacementInput& in : *placement) {
+            PlacementMath::Sheet sheet = in.sheet;
+            PlacementMath::NormalizeToMillimeters (sheet);
+            PlacementMath::FitResult fit;
+            if (PlacementMath::FitScale (in.extentW, in.extentH,
+                    sheet.sizeX - sheet.leftMargin - sheet.rightMargin, sheet.sizeY - sheet.topMargin - sheet.bottomMargin, fit))
+                sum += fit.scale;
+        }
+        return sum;
+    } });
+    benchmarks.push_back ({ "layer_volumes", composites->size (), 200, [composites] () {
+        double sum = 0.0;
+        for (const CompositeInput& in : *composites) {
+            for (const LayerVolumes::MaterialVolume& value : LayerVolumes::Distribute (in.gross, in.grossVolume, in.net, in.netVolume))
+                sum += value.grossVolume - value.netVolume;
+        }
+        return sum;
+    } });
+    // Суммы по материалам для всего выделения: один накопитель на все элементы
+    benchmarks.push_back ({ "layer_volumes_aggregate", composites->size (), 200, [composites] () {
+        static LayerVolumes::Aggregator aggregator;
+        aggregator.Reset ();
+        for (const CompositeInput& in : *composites)
+            aggregator.Add (in.gross, in.grossVolume, in.net, in.netVolume);
+        double sum = 0.0;
+        aggregator.ForEach ([&] (const LayerVolumes::MaterialVolume& value) { sum += value.grossVolume - value.netVolume; });
+        return sum;
+    } });
+    benchmarks.push_back ({ "folder_path_parse", paths->size (), 100, [paths] () {
+        double sum = 0.0;
+        for (const std::string& path : *paths) {
+            const std::vector<std::string> parts = FolderPath::RemoveRootFolder (FolderPath::Split (FolderPath::RemoveRootPrefix (path)));
+            sum += static_cast<double> (parts.size ());
+        }
+        return sum;
+    } });
+    benchmarks.push_back ({ "layout_grouping", layoutNames->size (), 50, [layoutNames] () {
+        const std::vector<LayoutGrouping::Group> groups = LayoutGrouping::GroupByFolder (*layoutNames);
+        double sum = static_cast<double> (groups.size ());
+        for (const LayoutGrouping::Group& group : groups)
+            sum += static_cast<double> (group.indices.back ());
+        return sum;
+    } });
+    return benchmarks;
+}
+
+Result Measure (const Benchmark& benchmark, int repetitions)
+{
+    Result result;
+    result.name = benchmark.name;
+    result.items = benchmark.items;
+    result.iterations = benchmark.iterations;
+
+    std::vector<double> samples;
+    for (int r = 0; r < repetitions; ++r) {
+        double checksum = 0.0;
+        const std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now ();
+        for (int i = 0; i < benchmark.iterations; ++i)
+            checksum += benchmark.run ();
+        const double ns = std::chrono::duration<double, std::nano> (std::chrono::steady_clock::now () - start).count ();
+        samples.push_back (ns / (static_cast<double> (benchmark.iterations) * benchmark.items));
+        result.checksum = checksum / benchmark.iterations;
+    }
+    std::sort (samples.begin (), samples.end ());
+    result.nsPerItem = samples[samples.size () / 2];
+    return result;
+}
+
+void WriteJson (std::FILE* out, std::uint32_t seed, int repetitions, const std::vector<Result>& results)
+{
+    std::fprintf (out, "{\n  \"seed\": %u,\n  \"repetitions\": %d,\n  \"benchmarks\": [\n", seed, repetitions);
+    for (std::size_t i = 0; i < results.size (); ++i) {
+        const Result& r = results[i];
+        std::fprintf (out, "    { \"name\": \"%s\", \"items\": %zu, \"iterations\": %d, \"ns_per_item\": %.3f, \"checksum\": %.6f }%s\n",
+            r.name.c_str (), r.items, r.iterations, r.nsPerItem, r.checksum, (i + 1 < results.size ()) ? "," : "");
+    }
+    std::fprintf (out, "  ]\n}\n");
+}
+
+} // namespace
+
+int main (int argc, char** argv)
+{
+    std::uint32_t seed = 1;
+    int repetitions = 5;
+    std::string filter;
+    std::string outPath;
+    for (int i = 1; i < argc; i += 2) {
+        const bool hasValue = (i + 1 < argc);
+        if (hasValue && std::strcmp (argv[i], "--seed") == 0) {
+            seed = static_cast<std::uint32_t> (std::strtoul (argv[i + 1], nullptr, 10));
+        } else if (hasValue && std::strcmp (argv[i], "--repetitions") == 0) {
+            repetitions = std::max (1, std::atoi (argv[i + 1]));
+        } else if (hasValue && std::strcmp (argv[i], "--filter") == 0) {
+            filter = argv[i + 1];
+        } else if (hasValue && std::strcmp (argv[i], "--out") == 0) {
+            outPath = argv[i + 1];
+        } else {
+            std::fprintf (stderr, "usage: %s [--seed N] [--repetitions N] [--filter substring] [--out file.json]\n", argv[0]);
+            return 2;
+        }
+    }
+
+    std::vector<Result> results;
+    for (const Benchmark& benchmark : MakeBenchmarks (seed)) {
+        if (filter.empty () || std::strstr (benchmark.name, filter.c_str ()) != nullptr)
+            results.push_back (Measure (benchmark, repetitions));
+    }
+
+    std::FILE* out = outPath.empty () ? stdout : std::fopen (outPath.c_str (), "w");
+    if (out == nullptr) {
+        std::fprintf (stderr, "cannot write %s\n", outPath.c_str ());
+        return 1;
+    }
+    WriteJson (out, seed, repetitions, results);
+    if (out != stdout)
+        std::fclose (out);
+    return 0;
+}
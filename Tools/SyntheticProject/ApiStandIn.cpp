@@ -0,0 +1,401 @@
+#include "ApiStandIn.hpp"
+#include "SyntheticProject.hpp"
+#include "SelectionMetricsHelper.hpp"
+#include "PropertyUtils.hpp"
+#include "uchar_t.hpp"
+
+#include <cstring>
+#include <string>
+#include <unordered_map>
+
+namespace ApiStandIn {
+
+namespace {
+
+// Какой объект проекта закодирован в GUID: байты 0-3 — индекс, 4-7 — вид объекта
+enum class ObjectKind : UInt32 {
+    View = 1, LayoutDatabase, MasterDatabase, LayerFolder, Layer, Element
+};
+
+const SyntheticProject::Project*            s_project = nullptr;
+std::unordered_map<std::string, UInt32>     s_layerFolderByPath;   // "Группа 1/Группа 5" -> индекс папки
+
+API_Guid MakeGuid (ObjectKind kind, UInt32 index)
+{
+    API_Guid guid = APINULLGuid;
+    const UInt32 tag = static_cast<UInt32> (kind);
+    std::memcpy (reinterpret_cast<char*> (&guid), &index, sizeof (index));
+    std::memcpy (reinterpret_cast<char*> (&guid) + sizeof (index), &tag, sizeof (tag));
+    return guid;
+}
+
+bool DecodeGuid (const API_Guid& guid, ObjectKind kind, UInt32& index)
+{
+    UInt32 tag = 0;
+    std::memcpy (&index, reinterpret_cast<const char*> (&guid), sizeof (index));
+    std::memcpy (&tag, reinterpret_cast<const char*> (&guid) + sizeof (index), sizeof (tag));
+    return tag == static_cast<UInt32> (kind);
+}
+
+API_DatabaseUnId MakeDatabaseId (ObjectKind kind, UInt32 index)
+{
+    API_DatabaseUnId id = {};
+    id.elemSetId = MakeGuid (kind, index);
+    return id;
+}
+
+// Индекс атрибута 1..N <-> номер в массиве проекта
+Int32 ToProjectIndex (const API_AttributeIndex& index)
+{
+    return index.ToInt32_Deprecated () - 1;
+}
+
+template <std::size_t N>
+void SetName (char (&dest)[N], const std::string& utf8)
+{
+    const std::size_t length = (utf8.size () < N - 1) ? utf8.size () : N - 1;
+    std::memcpy (dest, utf8.data (), length);
+    dest[length] = '\0';
+}
+
+template <std::size_t N>
+void SetName (GS::uchar_t (&dest)[N], const std::string& utf8)
+{
+    const GS::UniString name (utf8.c_str (), CC_UTF8);
+    std::memset (dest, 0, sizeof (dest));
+    GS::ucsncpy (dest, name.ToUStr ().Get (), N - 1);
+}
+
+std::string JoinPath (const GS::Array<GS::UniString>& path)
+{
+    std::string joined;
+    for (UIndex i = 0; i < path.GetSize (); ++i) {
+        if (i > 0)
+            joined += '/';
+        joined += path[i].ToCStr (CC_UTF8).Get ();
+    }
+    return joined;
+}
+
+GS::Array<GS::UniString> ToUniPath (const std::vector<std::string>& path)
+{
+    GS::Array<GS::UniString> result;
+    for (const std::string& part : path)
+        result.Push (GS::UniString (part.c_str (), CC_UTF8));
+    return result;
+}
+
+API_NavigatorItemTypeID ToNavigatorType (SyntheticProject::ViewKind kind)
+{
+    using SyntheticProject::ViewKind;
+    switch (kind) {
+        case ViewKind::Root:              return API_ProjectNavItem;
+        case ViewKind::Folder:            return API_FolderNavItem;
+        case ViewKind::Story:             return API_StoryNavItem;
+        case ViewKind::Section:           return API_SectionNavItem;
+        case ViewKind::Elevation:         return API_ElevationNavItem;
+        case ViewKind::InteriorElevation: return API_InteriorElevationNavItem;
+        case ViewKind::Detail:            return API_DetailDrawingNavItem;
+        case ViewKind::Worksheet:         return API_WorksheetDrawingNavItem;
+        case ViewKind::Document3D:        return API_DocumentFrom3DNavItem;
+        default:                          return API_UndefinedNavItem;
+    }
+}
+
+// Типы элементов по убыванию частоты (индекс Element::type)
+const API_ElemTypeID ElementTypes[] = {
+    API_WallID, API_SlabID, API_ObjectID, API_ColumnID, API_BeamID, API_WindowID, API_DoorID,
+    API_ZoneID, API_LineID, API_HatchID, API_DimensionID, API_TextID, API_LabelID, API_PolyLineID,
+    API_RoofID, API_MeshID, API_CurtainWallID, API_StairID, API_RailingID, API_MorphID
+};
+
+API_ElemTypeID ToElemTypeID (std::uint16_t type)
+{
+    return ElementTypes[type % (sizeof (ElementTypes) / sizeof (ElementTypes[0]))];
+}
+
+const SyntheticProject::Element* FindElement (const API_Guid& guid)
+{
+    UInt32 index = 0;
+    if (s_project == nullptr || !DecodeGuid (guid, ObjectKind::Element, index) || index >= s_project->elements.size ())
+        return nullptr;
+    return &s_project->elements[index];
+}
+
+GSErrCode GetDatabases (ObjectKind kind, std::size_t count, GS::Array<API_DatabaseUnId>* databases)
+{
+    if (s_project == nullptr || databases == nullptr)
+        return APIERR_BADPARS;
+    databases->Clear ();
+    for (UInt32 i = 0; i < count; ++i)
+        databases->Push (MakeDatabaseId (kind, i));
+    return NoError;
+}
+
+} // namespace
+
+void SetProject (const SyntheticProject::Project& project)
+{
+    s_project = &project;
+    s_layerFolderByPath.clear ();
+    for (UInt32 i = 0; i < project.layerFolders.size (); ++i) {
+        std::string joined;
+        for (const std::string& part : project.layerFolders[i].path)
+            joined += (joined.empty () ? "" : "/") + part;
+        s_layerFolderByPath.emplace (joined, i);
+    }
+}
+
+// ---- View Map ----
+
+GSErrCode ACAPI_Navigator_GetNavigatorSet (API_NavigatorSet* navigatorSet, Int32* /*index*/)
+{
+    if (s_project == nullptr || navigatorSet == nullptr)
+        return APIERR_BADPARS;
+    navigatorSet->rootGuid = MakeGuid (ObjectKind::View, 0);
+    SetName (navigatorSet->name, s_project->views[0].name);
+    return NoError;
+}
+
+GSErrCode ACAPI_Navigator_GetNavigatorChildrenItems (API_NavigatorItem* parent, GS::Array<API_NavigatorItem>* items)
+{
+    UInt32 index = 0;
+    if (s_project == nullptr || parent == nullptr || items == nullptr || !DecodeGuid (parent->guid, ObjectKind::View, index) || index >= s_project->views.size ())
+        return APIERR_BADPARS;
+
+    items->Clear ();
+    for (UInt32 childIndex : s_project->views[index].children) {
+        const SyntheticProject::ViewNode& child = s_project->views[childIndex];
+        API_NavigatorItem item = {};
+        item.guid = MakeGuid (ObjectKind::View, childIndex);
+        item.mapId = parent->mapId;
+        item.itemType = ToNavigatorType (child.kind);
+        SetName (item.uName, child.name);
+        items->Push (item);
+    }
+    return NoError;
+}
+
+// ---- Макеты ----
+
+GSErrCode ACAPI_Database_GetLayoutDatabases (const API_DatabaseUnId* /*databaseUnId*/, GS::Array<API_DatabaseUnId>* databases)
+{
+    return GetDatabases (ObjectKind::LayoutDatabase, s_project != nullptr ? s_project->layouts.size () : 0, databases);
+}
+
+GSErrCode ACAPI_Database_GetMasterLayoutDatabases (const API_DatabaseUnId* /*databaseUnId*/, GS::Array<API_DatabaseUnId>* databases)
+{
+    return GetDatabases (ObjectKind::MasterDatabase, s_project != nullptr ? s_project->masterLayouts.size () : 0, databases);
+}
+
+GSErrCode ACAPI_Window_GetDatabaseInfo (API_DatabaseInfo* databaseInfo)
+{
+    if (s_project == nullptr || databaseInfo == nullptr)
+        return APIERR_BADPARS;
+
+    UInt32 index = 0;
+    if (DecodeGuid (databaseInfo->databaseUnId.elemSetId, ObjectKind::LayoutDatabase, index) && index < s_project->layouts.size ())
+        SetName (databaseInfo->name, s_project->layouts[index]);
+    else if (DecodeGuid (databaseInfo->databaseUnId.elemSetId, ObjectKind::MasterDatabase, index) && index < s_project->masterLayouts.size ())
+        SetName (databaseInfo->name, s_project->masterLayouts[index]);
+    else
+        return APIERR_BADDATABASE;
+    return NoError;
+}
+
+// ---- Слои ----
+
+GSErrCode ACAPI_Attribute_GetFolder (API_AttributeFolder& folder)
+{
+    if (s_project == nullptr || folder.typeID != API_LayerID)
+        return APIERR_BADPARS;
+    const auto it = s_layerFolderByPath.find (JoinPath (folder.path));
+    if (it == s_layerFolderByPath.end ())
+        return APIERR_BADNAME;
+    folder.guid = MakeGuid (ObjectKind::LayerFolder, it->second);
+    return NoError;
+}
+
+GSErrCode ACAPI_Attribute_GetFolderContent (const API_AttributeFolder& folder, API_AttributeFolderContent& content)
+{
+    if (s_project == nullptr || folder.typeID != API_LayerID)
+        return APIERR_BADPARS;
+
+    // Корень — папка без пути и GUID, как в Archicad
+    UInt32 index = 0;
+    if (folder.guid != APINULLGuid) {
+        if (!DecodeGuid (folder.guid, ObjectKind::LayerFolder, index) || index >= s_project->layerFolders.size ())
+            return APIERR_BADID;
+    } else if (!folder.path.IsEmpty ()) {
+        const auto it = s_layerFolderByPath.find (JoinPath (folder.path));
+        if (it == s_layerFolderByPath.end ())
+            return APIERR_BADNAME;
+        index = it->second;
+    }
+
+    const SyntheticProject::LayerFolder& source = s_project->layerFolders[index];
+    content.subFolders.Clear ();
+    content.attributeIds.Clear ();
+    for (UInt32 subIndex : source.subFolders) {
+        API_AttributeFolder subFolder = {};
+        subFolder.typeID = API_LayerID;
+        subFolder.guid = MakeGuid (ObjectKind::LayerFolder, subIndex);
+        subFolder.path = ToUniPath (s_project->layerFolders[subIndex].path);
+        content.subFolders.Push (subFolder);
+    }
+    for (UInt32 layerIndex : source.layers)
+        content.attributeIds.Push (APIGuid2GSGuid (MakeGuid (ObjectKind::Layer, layerIndex)));
+    return NoError;
+}
+
+GSErrCode ACAPI_Attribute_Get (API_Attribute* attribute)
+{
+    if (s_project == nullptr || attribute == nullptr || attribute->header.typeID != API_LayerID)
+        return APIERR_BADPARS;
+
+    UInt32 layerIndex = 0;
+    if (attribute->header.guid != APINULLGuid) {
+        if (!DecodeGuid (attribute->header.guid, ObjectKind::Layer, layerIndex))
+            return APIERR_BADID;
+    } else {
+        const Int32 index = ToProjectIndex (attribute->header.index);
+        if (index < 0)
+            return APIERR_BADINDEX;
+        layerIndex = static_cast<UInt32> (index);
+    }
+    if (layerIndex >= s_project->layers.size ())
+        return APIERR_DELETED;
+
+    attribute->header.index = ACAPI_CreateAttributeIndex (static_cast<Int32> (layerIndex + 1));
+    attribute->header.guid = MakeGuid (ObjectKind::Layer, layerIndex);
+    SetName (attribute->header.name, s_project->layers[layerIndex].name);
+    return NoError;
+}
+
+GSErrCode ACAPI_Attribute_GetNum (API_AttrTypeID typeID, GS::UInt32& count)
+{
+    if (s_project == nullptr || typeID != API_LayerID)
+        return APIERR_BADPARS;
+    count = static_cast<GS::UInt32> (s_project->layers.size ());
+    return NoError;
+}
+
+// ---- Выделение и элементы ----
+
+// Выделен весь проект — худший случай для палитр выделения
+GSErrCode ACAPI_Selection_Get (API_SelectionInfo* selectionInfo, GS::Array<API_Neig>* selNeigs, bool /*onlyEditable*/, bool /*ignorePartialSelection*/)
+{
+    if (s_project == nullptr || selectionInfo == nullptr || selNeigs == nullptr)
+        return APIERR_BADPARS;
+
+    const UInt32 count = static_cast<UInt32> (s_project->elements.size ());
+    *selectionInfo = {};
+    selectionInfo->typeID = API_SelElems;
+    selectionInfo->sel_nElem = static_cast<Int32> (count);
+    selectionInfo->sel_nElemEdit = static_cast<Int32> (count);
+
+    selNeigs->Clear ();
+    selNeigs->SetCapacity (count);
+    for (UInt32 i = 0; i < count; ++i) {
+        API_Neig neig = {};
+        neig.guid = MakeGuid (ObjectKind::Element, i);
+        selNeigs->Push (neig);
+    }
+    return NoError;
+}
+
+GSErrCode ACAPI_Element_GetHeader (API_Elem_Head* elementHead, UInt32 /*mask*/)
+{
+    if (elementHead == nullptr)
+        return APIERR_BADPARS;
+    const SyntheticProject::Element* element = FindElement (elementHead->guid);
+    if (element == nullptr)
+        return APIERR_BADID;
+
+    elementHead->type = API_ElemType (ToElemTypeID (element->type));
+    elementHead->layer = ACAPI_CreateAttributeIndex (static_cast<Int32> (element->layer + 1));
+    elementHead->floorInd = element->story;
+    return NoError;
+}
+
+GSErrCode ACAPI_Element_GetElementInfoString (const API_Guid* guid, GS::UniString* infoString, GS::UniString* /*infoStringChanged*/)
+{
+    if (guid == nullptr || infoString == nullptr)
+        return APIERR_BADPARS;
+    const SyntheticProject::Element* element = FindElement (*guid);
+    if (element == nullptr)
+        return APIERR_BADID;
+    *infoString = (element->id != 0) ? GS::UniString::Printf ("ID-%05u", static_cast<unsigned> (element->id)) : GS::UniString ();
+    return NoError;
+}
+
+GSErrCode ACAPI_Element_GetElemTypeName (const API_ElemType& type, GS::UniString& typeName)
+{
+    typeName = GS::UniString::Printf ("Type %d", static_cast<int> (type.typeID));
+    return NoError;
+}
+
+GSErrCode ACAPI_ProjectSetting_GetStorySettings (API_StoryInfo* storyInfo, UInt32 /*mask*/)
+{
+    if (s_project == nullptr || storyInfo == nullptr || s_project->stories.empty ())
+        return APIERR_BADPARS;
+
+    const Int32 count = static_cast<Int32> (s_project->stories.size ());
+    *storyInfo = {};
+    storyInfo->firstStory = 0;
+    storyInfo->lastStory = static_cast<short> (count - 1);
+    storyInfo->data = reinterpret_cast<API_StoryType**> (BMAllocateHandle (count * sizeof (API_StoryType), ALLOCATE_CLEAR, 0));
+    if (storyInfo->data == nullptr)
+        return APIERR_MEMFULL;
+
+    API_StoryType* stories = *storyInfo->data;
+    for (Int32 i = 0; i < count; ++i) {
+        stories[i].index = static_cast<short> (i);
+        stories[i].level = 3.0 * i;
+        SetName (stories[i].uName, s_project->stories[i]);
+    }
+    return NoError;
+}
+
+bool GetElementQuantities (const API_Guid& guid, double& area, double& volume)
+{
+    const SyntheticProject::Element* element = FindElement (guid);
+    if (element == nullptr)
+        return false;
+    area = element->area;
+    volume = element->volume;
+    return true;
+}
+
+} // namespace ApiStandIn
+
+// ---- Функции Archicad и единиц дополнения, не входящих в сборку замеров ----
+
+API_AttributeIndex ACAPI_CreateAttributeIndex (Int32 index)
+{
+    API_AttributeIndex result;
+    static_assert (sizeof (result) >= sizeof (index), "API_AttributeIndex layout");
+    std::memcpy (&result, &index, sizeof (index));
+    return result;
+}
+
+// Количества без временных копий и GetMoreQuantities — прямо из модели
+GSErrCode SelectionMetricsHelper::CollectAreaVolume (const GS::Array<API_Guid>& guids, const GS::Array<API_ElemTypeID>& /*types*/,
+    GS::Array<AreaVolume>& result)
+{
+    result.Clear ();
+    result.SetCapacity (guids.GetSize ());
+    for (const API_Guid& guid : guids) {
+        AreaVolume value;
+        ApiStandIn::GetElementQuantities (guid, value.area, value.volume);
+        result.Push (value);
+    }
+    return NoError;
+}
+
+// Свойства в синтетическом проекте не заданы (GetPropertyValuesByGuid отказывает)
+GSErrCode PropertyUtils::PropertyToString (const API_Property& /*property*/, GS::UniString& propertyValue)
+{
+    propertyValue.Clear ();
+    return APIERR_GENERAL;
+}
@@ -0,0 +1,97 @@
+#ifndef APISTANDIN_HPP
+#define APISTANDIN_HPP
+
+#include "APIEnvir.h"
+#include "ACAPinc.h"
+#include "GSRoot.hpp"
+
+namespace SyntheticProject { struct Project; }
+
+// Подмена вызовов Archicad API синтетическим проектом (сборка с TOLAYOUT_API_STANDIN,
+// см. ApiProfiler.hpp): API_CALL (ACAPI_X, ...) раскрывается в ApiStandIn::ACAPI_X (...).
+//
+// Функции, нужные замерам (View Map, макеты, слои, выделение), отвечают данными проекта;
+// остальные возвращают APIERR_GENERAL — код дополнения обрабатывает это как отказ API.
+namespace ApiStandIn {
+
+    // Проект, которым отвечают функции; должен жить до конца замеров
+    void SetProject (const SyntheticProject::Project& project);
+
+    // ---- View Map ----
+    GSErrCode ACAPI_Navigator_GetNavigatorSet (API_NavigatorSet* navigatorSet, Int32* index = nullptr);
+    GSErrCode ACAPI_Navigator_GetNavigatorChildrenItems (API_NavigatorItem* parent, GS::Array<API_NavigatorItem>* items);
+
+    // ---- Макеты ----
+    GSErrCode ACAPI_Database_GetLayoutDatabases (const API_DatabaseUnId* databaseUnId, GS::Array<API_DatabaseUnId>* databases);
+    GSErrCode ACAPI_Database_GetMasterLayoutDatabases (const API_DatabaseUnId* databaseUnId, GS::Array<API_DatabaseUnId>* databases);
+    GSErrCode ACAPI_Window_GetDatabaseInfo (API_DatabaseInfo* databaseInfo);
+
+    // ---- Слои ----
+    GSErrCode ACAPI_Attribute_GetFolder (API_AttributeFolder& folder);
+    GSErrCode ACAPI_Attribute_GetFolderContent (const API_AttributeFolder& folder, API_AttributeFolderContent& content);
+    GSErrCode ACAPI_Attribute_Get (API_Attribute* attribute);
+    GSErrCode ACAPI_Attribute_GetNum (API_AttrTypeID typeID, GS::UInt32& count);
+
+    // ---- Выделение и элементы ----
+    GSErrCode ACAPI_Selection_Get (API_SelectionInfo* selectionInfo, GS::Array<API_Neig>* selNeigs, bool onlyEditable, bool ignorePartialSelection = true);
+    GSErrCode ACAPI_Element_GetHeader (API_Elem_Head* elementHead, UInt32 mask = 0);
+    GSErrCode ACAPI_Element_GetElementInfoString (const API_Guid* guid, GS::UniString* infoString, GS::UniString* infoStringChanged = nullptr);
+    GSErrCode ACAPI_Element_GetElemTypeName (const API_ElemType& type, GS::UniString& typeName);
+    GSErrCode ACAPI_ProjectSetting_GetStorySettings (API_StoryInfo* storyInfo, UInt32 mask = 0);
+
+    // Площадь и объём элемента синтетического проекта (для SelectionMetricsHelper::CollectAreaVolume)
+    bool GetElementQuantities (const API_Guid& guid, double& area, double& volume);
+
+    // ---- Остальные функции API_CALL: синтетический проект их не поддерживает ----
+#define TOLAYOUT_STANDIN_UNSUPPORTED(fn) \
+    template <typename... Args> \
+    GSErrCode fn (Args&&...) { return APIERR_GENERAL; }
+
+    TOLAYOUT_STANDIN_UNSUPPORTED (ACAPI_AddOnObject_CreateObject)
+    TOLAYOUT_STANDIN_UNSUPPORTED (ACAPI_AddOnObject_DeleteObject)
+    TOLAYOUT_STANDIN_UNSUPPORTED (ACAPI_AddOnObject_GetObjectContent)
+    TOLAYOUT_STANDIN_UNSUPPORTED (ACAPI_AddOnObject_GetObjectGuidFromName)
+    TOLAYOUT_STANDIN_UNSUPPORTED (ACAPI_AddOnObject_GetObjectList)
+    TOLAYOUT_STANDIN_UNSUPPORTED (ACAPI_AddOnObject_ModifyObject)
+    TOLAYOUT_STANDIN_UNSUPPORTED (ACAPI_Attribute_Create)
+    TOLAYOUT_STANDIN_UNSUPPORTED (ACAPI_Attribute_CreateFolder)
+    TOLAYOUT_STANDIN_UNSUPPORTED (ACAPI_Attribute_Delete)
+    TOLAYOUT_STANDIN_UNSUPPORTED (ACAPI_Attribute_GetAttributesByType)
+    TOLAYOUT_STANDIN_UNSUPPORTED (ACAPI_Attribute_GetDef)
+    TOLAYOUT_STANDIN_UNSUPPORTED (ACAPI_Attribute_Modify)
+    TOLAYOUT_STANDIN_UNSUPPORTED (ACAPI_Attribute_Move)
+    TOLAYOUT_STANDIN_UNSUPPORTED (ACAPI_Attribute_Search)
+    TOLAYOUT_STANDIN_UNSUPPORTED (ACAPI_Database_ChangeCurrentDatabase)
+    TOLAYOUT_STANDIN_UNSUPPORTED (ACAPI_Database_GetCurrentDatabase)
+    TOLAYOUT_STANDIN_UNSUPPORTED (ACAPI_Drawing_GetDrawingScale)
+    TOLAYOUT_STANDIN_UNSUPPORTED (ACAPI_Element_CalcBounds)
+    TOLAYOUT_STANDIN_UNSUPPORTED (ACAPI_Element_Change)
+    TOLAYOUT_STANDIN_UNSUPPORTED (ACAPI_Element_ChangeElementInfoString)
+    TOLAYOUT_STANDIN_UNSUPPORTED (ACAPI_Element_Create)
+    TOLAYOUT_STANDIN_UNSUPPORTED (ACAPI_Element_Delete)
+    TOLAYOUT_STANDIN_UNSUPPORTED (ACAPI_Element_Get)
+    TOLAYOUT_STANDIN_UNSUPPORTED (ACAPI_Element_GetDefaults)
+    TOLAYOUT_STANDIN_UNSUPPORTED (ACAPI_Element_GetElemList)
+    TOLAYOUT_STANDIN_UNSUPPORTED (ACAPI_Element_GetMemo)
+    TOLAYOUT_STANDIN_UNSUPPORTED (ACAPI_Element_GetMoreQuantities)
+    TOLAYOUT_STANDIN_UNSUPPORTED (ACAPI_Element_GetPropertyDefinitions)
+    TOLAYOUT_STANDIN_UNSUPPORTED (ACAPI_Element_GetPropertyValues)
+    TOLAYOUT_STANDIN_UNSUPPORTED (ACAPI_Element_GetPropertyValuesByGuid)
+    TOLAYOUT_STANDIN_UNSUPPORTED (ACAPI_Element_SolidLink_GetOperators)
+    TOLAYOUT_STANDIN_UNSUPPORTED (ACAPI_Element_SolidLink_Remove)
+    TOLAYOUT_STANDIN_UNSUPPORTED (ACAPI_Navigator_ChangeNavigatorItem)
+    TOLAYOUT_STANDIN_UNSUPPORTED (ACAPI_Navigator_ChangeNavigatorView)
+    TOLAYOUT_STANDIN_UNSUPPORTED (ACAPI_Navigator_CloneProjectMapItemToViewMap)
+    TOLAYOUT_STANDIN_UNSUPPORTED (ACAPI_Navigator_CreateLayout)
+    TOLAYOUT_STANDIN_UNSUPPORTED (ACAPI_Navigator_GetLayoutSets)
+    TOLAYOUT_STANDIN_UNSUPPORTED (ACAPI_Navigator_GetNavigatorItem)
+    TOLAYOUT_STANDIN_UNSUPPORTED (ACAPI_Navigator_GetNavigatorView)
+    TOLAYOUT_STANDIN_UNSUPPORTED (ACAPI_Navigator_SearchNavigatorItem)
+    TOLAYOUT_STANDIN_UNSUPPORTED (ACAPI_Property_GetPropertyValueString)
+    TOLAYOUT_STANDIN_UNSUPPORTED (ACAPI_Selection_Select)
+
+#undef TOLAYOUT_STANDIN_UNSUPPORTED
+
+} // namespace ApiStandIn
+
+#endif // APISTANDIN_HPP
@@ -0,0 +1,139 @@
+// tolayout_synth_bench — замеры кода дополнения на синтетическом проекте.
+//
+//   tolayout_synth_bench [--scale N] [--seed N] [--iterations N] [--scenario name]
+//
+// Все API_CALL отвечают из сгенерированного проекта (сборка с TOLAYOUT_API_STANDIN), поэтому
+// можно мерить размеры, которых нет ни в одном реальном проекте: --scale 10 — десятикратный
+// наш самый крупный проект. Группировка работает по всему проекту как по выделению.
+//
+// Сценарии: views, layers, layouts, grouping, grouping-summary, all (по умолчанию).
+
+#include "APIEnvir.h"
+#include "ACAPinc.h"
+#include "ApiStandIn.hpp"
+#include "SyntheticProject.hpp"
+#include "LayoutHelper.hpp"
+#include "LayerHelper.hpp"
+#include "SelectionGroupHelper.hpp"
+#include "NameCache.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <initializer_list>
+#include <string>
+
+namespace {
+
+struct Scenario {
+    const char* name;
+    UInt32      (*run) ();  // возвращает размер результата — для контроля и против выбрасывания кода
+};
+
+UInt32 RunViews ()
+{
+    return LayoutHelper::GetPlaceableViews ().GetSize ();
+}
+
+UInt32 RunLayers ()
+{
+    return LayerHelper::GetLayersList ().GetSize ();
+}
+
+UInt32 RunLayouts ()
+{
+    return LayoutHelper::GetLayoutGroups (LayoutHelper::GetLayoutList ()).GetSize ();
+}
+
+GS::Array<SelectionGroupHelper::KeySpec> MakeKeys (std::initializer_list<SelectionGroupHelper::KeyKind> kinds)
+{
+    GS::Array<SelectionGroupHelper::KeySpec> keys;
+    for (SelectionGroupHelper::KeyKind kind : kinds) {
+        SelectionGroupHelper::KeySpec spec;
+        spec.kind = kind;
+        keys.Push (spec);
+    }
+    return keys;
+}
+
+// Полная группировка с суммами, без порога сводного режима
+UInt32 RunGrouping ()
+{
+    using SelectionGroupHelper::KeyKind;
+    const SelectionGroupHelper::GroupsResult result = SelectionGroupHelper::GetSelectionGroups (
+        MakeKeys ({ KeyKind::Type, KeyKind::ID, KeyKind::Layer, KeyKind::Story }), SelectionGroupHelper::SortSpec (), true, 0);
+    return result.rows.GetSize ();
+}
+
+// Та же группировка с порогом по умолчанию — большой проект уходит в сводный режим
+UInt32 RunGroupingSummary ()
+{
+    using SelectionGroupHelper::KeyKind;
+    const SelectionGroupHelper::GroupsResult result = SelectionGroupHelper::GetSelectionGroups (
+        MakeKeys ({ KeyKind::Type, KeyKind::ID, KeyKind::Layer, KeyKind::Story }), SelectionGroupHelper::SortSpec (), true);
+    return result.rows.GetSize ();
+}
+
+const Scenario Scenarios[] = {
+    { "views",            RunViews },
+    { "layers",           RunLayers },
+    { "layouts",          RunLayouts },
+    { "grouping",         RunGrouping },
+    { "grouping-summary", RunGroupingSummary },
+};
+
+void RunScenario (const Scenario& scenario, int iterations)
+{
+    UInt32 resultSize = 0;
+    const std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now ();
+    for (int i = 0; i < iterations; ++i) {
+        NameCache::BeginPass ();
+        resultSize = scenario.run ();
+    }
+    const double totalMs = std::chrono::duration<double, std::milli> (std::chrono::steady_clock::now () - start).count ();
+    std::printf ("%-18s %5d iterations  %10.3f ms/iteration  %8u items\n",
+        scenario.name, iterations, totalMs / iterations, static_cast<unsigned> (resultSize));
+}
+
+} // namespace
+
+int main (int argc, char** argv)
+{
+    SyntheticProject::Config config;
+    int iterations = 10;
+    std::string scenarioName = "all";
+    for (int i = 1; i < argc; i += 2) {
+        const bool hasValue = (i + 1 < argc);
+        if (hasValue && std::strcmp (argv[i], "--scale") == 0) {
+            config.scale = std::atof (argv[i + 1]);
+        } else if (hasValue && std::strcmp (argv[i], "--seed") == 0) {
+            config.seed = static_cast<std::uint32_t> (std::strtoul (argv[i + 1], nullptr, 10));
+        } else if (hasValue && std::strcmp (argv[i], "--iterations") == 0) {
+            iterations = std::max (1, std::atoi (argv[i + 1]));
+        } else if (hasValue && std::strcmp (argv[i], "--scenario") == 0) {
+            scenarioName = argv[i + 1];
+        } else {
+            std::fprintf (stderr, "usage: %s [--scale N] [--seed N] [--iterations N] [--scenario views|layers|layouts|grouping|grouping-summary|all]\n", argv[0]);
+            return 2;
+        }
+    }
+
+    const SyntheticProject::Project project = SyntheticProject::Generate (config);
+    ApiStandIn::SetProject (project);
+    std::printf ("scale %.2f, seed %u: %s\n", config.scale, config.seed, SyntheticProject::Describe (project).c_str ());
+
+    bool found = false;
+    for (const Scenario& scenario : Scenarios) {
+        if (scenarioName == "all" || scenarioName == scenario.name) {
+            RunScenario (scenario, iterations);
+            found = true;
+        }
+    }
+    if (!found) {
+        std::fprintf (stderr, "unknown scenario: %s\n", scenarioName.c_str ());
+        return 2;
+    }
+    return 0;
+}
@@ -0,0 +1,36 @@
+// tolayout_synth — генерация синтетического проекта и сводка по нему (без DevKit).
+//
+//   tolayout_synth [--scale N] [--seed N]
+//
+// Показывает размеры проекта, который получат замеры tolayout_synth_bench с теми же
+// параметрами, и время генерации.
+
+#include "SyntheticProject.hpp"
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+
+int main (int argc, char** argv)
+{
+    SyntheticProject::Config config;
+    for (int i = 1; i < argc; i += 2) {
+        if (i + 1 < argc && std::strcmp (argv[i], "--scale") == 0) {
+            config.scale = std::atof (argv[i + 1]);
+        } else if (i + 1 < argc && std::strcmp (argv[i], "--seed") == 0) {
+            config.seed = static_cast<std::uint32_t> (std::strtoul (argv[i + 1], nullptr, 10));
+        } else {
+            std::fprintf (stderr, "usage: %s [--scale N] [--seed N]\n", argv[0]);
+            return 2;
+        }
+    }
+
+    const std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now ();
+    const SyntheticProject::Project project = SyntheticProject::Generate (config);
+    const double ms = std::chrono::duration<double, std::milli> (std::chrono::steady_clock::now () - start).count ();
+
+    std::printf ("scale %.2f, seed %u: %s\n", config.scale, config.seed, SyntheticProject::Describe (project).c_str ());
+    std::printf ("generated in %.1f ms\n", ms);
+    return 0;
+}
@@ -0,0 +1,227 @@
+#include "SyntheticProject.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <numeric>
+#include <random>
+
+namespace SyntheticProject {
+
+namespace {
+
+using Random = std::mt19937;
+
+std::uint32_t Scaled (std::uint32_t count, double scale)
+{
+    return std::max<std::uint32_t> (1, static_cast<std::uint32_t> (std::lround (count * scale)));
+}
+
+// Распределение Ципфа на [0, n): вероятность k пропорциональна 1 / (k + 1)^s
+class Zipf {
+public:
+    Zipf (std::uint32_t n, double s) : cdf (n)
+    {
+        double sum = 0.0;
+        for (std::uint32_t k = 0; k < n; ++k) {
+            sum += 1.0 / std::pow (static_cast<double> (k + 1), s);
+            cdf[k] = sum;
+        }
+        for (double& value : cdf)
+            value /= sum;
+    }
+
+    std::uint32_t operator() (Random& random) const
+    {
+        const double u = std::uniform_real_distribution<double> (0.0, 1.0) (random);
+        const auto it = std::lower_bound (cdf.begin (), cdf.end (), u);
+        return static_cast<std::uint32_t> (std::min<std::size_t> (it - cdf.begin (), cdf.size () - 1));
+    }
+
+private:
+    std::vector<double> cdf;
+};
+
+// Дерево папок: родитель каждой папки (у корня — сам корень) и глубина.
+// Половина новых папок вкладывается в предыдущую, остальные — в случайную: получаются
+// и глубокие ветки, и широкие уровни, как в реальных проектах
+struct FolderTree {
+    std::vector<std::uint32_t> parent;
+    std::vector<std::uint32_t> depth;
+};
+
+FolderTree BuildFolderTree (std::uint32_t count, std::uint32_t maxDepth, Random& random)
+{
+    FolderTree tree;
+    tree.parent.push_back (0);
+    tree.depth.push_back (0);
+    std::bernoulli_distribution nestInLast (0.5);
+
+    for (std::uint32_t i = 1; i < count; ++i) {
+        std::uint32_t parent = i - 1;
+        if (!nestInLast (random) || tree.depth[parent] >= maxDepth)
+            parent = std::uniform_int_distribution<std::uint32_t> (0, i - 1) (random);
+        while (tree.depth[parent] >= maxDepth)
+            parent = tree.parent[parent];
+        tree.parent.push_back (parent);
+        tree.depth.push_back (tree.depth[parent] + 1);
+    }
+    return tree;
+}
+
+ViewKind RandomViewKind (Random& random)
+{
+    // Доли типов видов в наших проектах: планы, разрезы и детали преобладают
+    static const ViewKind kinds[] = {
+        ViewKind::Story, ViewKind::Section, ViewKind::Elevation, ViewKind::InteriorElevation,
+        ViewKind::Detail, ViewKind::Worksheet, ViewKind::Document3D
+    };
+    static const double weights[] = { 25, 20, 10, 10, 20, 10, 5 };
+    std::discrete_distribution<int> pick (std::begin (weights), std::end (weights));
+    return kinds[pick (random)];
+}
+
+const char* ViewKindName (ViewKind kind)
+{
+    switch (kind) {
+        case ViewKind::Story:             return "План";
+        case ViewKind::Section:           return "Разрез";
+        case ViewKind::Elevation:         return "Фасад";
+        case ViewKind::InteriorElevation: return "Развертка";
+        case ViewKind::Detail:            return "Узел";
+        case ViewKind::Worksheet:         return "Рабочий лист";
+        case ViewKind::Document3D:        return "Документ 3D";
+        default:                          return "Вид";
+    }
+}
+
+void GenerateViews (const Config& config, Project& project, Random& random)
+{
+    const std::uint32_t viewCount = Scaled (config.views, config.scale);
+    const std::uint32_t folderCount = std::max<std::uint32_t> (1, viewCount / std::max<std::uint32_t> (1, config.viewsPerFolder));
+    const FolderTree tree = BuildFolderTree (folderCount + 1, config.viewFolderDepth, random);
+
+    project.views.resize (tree.parent.size ());
+    project.views[0].kind = ViewKind::Root;
+    project.views[0].name = "View Map";
+    for (std::uint32_t i = 1; i < tree.parent.size (); ++i) {
+        project.views[i].kind = ViewKind::Folder;
+        project.views[i].name = "Папка " + std::to_string (i);
+        project.views[tree.parent[i]].children.push_back (i);
+    }
+
+    std::uniform_int_distribution<std::uint32_t> pickFolder (1, folderCount);
+    for (std::uint32_t i = 0; i < viewCount; ++i) {
+        ViewNode view;
+        view.kind = RandomViewKind (random);
+        view.name = std::string (ViewKindName (view.kind)) + " " + std::to_string (i + 1);
+        const std::uint32_t folder = pickFolder (random);
+        project.views[folder].children.push_back (static_cast<std::uint32_t> (project.views.size ()));
+        project.views.push_back (std::move (view));
+    }
+}
+
+void GenerateLayouts (const Config& config, Project& project, Random& random)
+{
+    const std::uint32_t layoutCount = Scaled (config.layouts, config.scale);
+    const std::uint32_t folderCount = Scaled (config.layoutFolders, config.scale);
+    std::bernoulli_distribution inFolder (config.layoutsInFolders);
+    std::uniform_int_distribution<std::uint32_t> pickFolder (1, folderCount);
+
+    for (std::uint32_t i = 0; i < layoutCount; ++i) {
+        const std::string sheet = "Лист " + std::to_string (i + 1);
+        project.layouts.push_back (inFolder (random) ? "Раздел " + std::to_string (pickFolder (random)) + "/" + sheet : sheet);
+    }
+    for (std::uint32_t i = 0; i < config.masterLayouts; ++i)
+        project.masterLayouts.push_back ("Шаблон " + std::to_string (i + 1));
+}
+
+void GenerateLayers (const Config& config, Project& project, Random& random)
+{
+    const std::uint32_t layerCount = Scaled (config.layers, config.scale);
+    const std::uint32_t folderCount = std::max<std::uint32_t> (1, layerCount / std::max<std::uint32_t> (1, config.layersPerFolder));
+    const FolderTree tree = BuildFolderTree (folderCount + 1, config.layerFolderDepth, random);
+
+    project.layerFolders.resize (tree.parent.size ());
+    for (std::uint32_t i = 1; i < tree.parent.size (); ++i) {
+        LayerFolder& folder = project.layerFolders[i];
+        folder.path = project.layerFolders[tree.parent[i]].path;
+        folder.path.push_back ("Группа " + std::to_string (i));
+        project.layerFolders[tree.parent[i]].subFolders.push_back (i);
+    }
+
+    // Часть слоёв лежит в корне, как «Слой архитектора» в реальных шаблонах
+    std::uniform_int_distribution<std::uint32_t> pickFolder (0, folderCount);
+    for (std::uint32_t i = 0; i < layerCount; ++i) {
+        Layer layer;
+        layer.name = "Слой " + std::to_string (i + 1);
+        layer.folder = pickFolder (random);
+        project.layerFolders[layer.folder].layers.push_back (i);
+        project.layers.push_back (std::move (layer));
+    }
+}
+
+void GenerateElements (const Config& config, Project& project, Random& random)
+{
+    const std::uint32_t elementCount = Scaled (config.elements, config.scale);
+    const std::uint32_t layerCount = static_cast<std::uint32_t> (project.layers.size ());
+
+    for (std::uint32_t i = 0; i < config.stories; ++i)
+        project.stories.push_back (std::to_string (i + 1) + "-й этаж");
+
+    // Популярные слои разбросаны по списку, а не идут первыми
+    std::vector<std::uint32_t> layerOrder (layerCount);
+    std::iota (layerOrder.begin (), layerOrder.end (), 0);
+    std::shuffle (layerOrder.begin (), layerOrder.end (), random);
+
+    const Zipf typeDistribution (std::max<std::uint32_t> (1, config.elementTypes), config.typeSkew);
+    const Zipf layerDistribution (layerCount, config.layerSkew);
+    std::uniform_int_distribution<int> pickStory (0, static_cast<int> (config.stories) - 1);
+    std::uniform_int_distribution<std::uint32_t> pickId (1, std::max<std::uint32_t> (1, config.distinctIds));
+    std::bernoulli_distribution hasId (config.elementsWithId);
+    std::uniform_real_distribution<double> area (0.5, 50.0);
+    std::uniform_real_distribution<double> thickness (0.1, 0.5);
+
+    project.elements.reserve (elementCount);
+    for (std::uint32_t i = 0; i < elementCount; ++i) {
+        Element element;
+        element.type = static_cast<std::uint16_t> (typeDistribution (random));
+        element.layer = layerOrder[layerDistribution (random)];
+        element.story = static_cast<std::int16_t> (pickStory (random));
+        element.id = hasId (random) ? pickId (random) : 0;
+        element.area = area (random);
+        element.volume = element.area * thickness (random);
+        project.elements.push_back (element);
+    }
+}
+
+} // namespace
+
+std::uint32_t Project::CountViews () const
+{
+    std::uint32_t count = 0;
+    for (const ViewNode& node : views)
+        count += (node.kind != ViewKind::Root && node.kind != ViewKind::Folder) ? 1 : 0;
+    return count;
+}
+
+Project Generate (const Config& config)
+{
+    Random random (config.seed);
+    Project project;
+    GenerateViews (config, project, random);
+    GenerateLayouts (config, project, random);
+    GenerateLayers (config, project, random);
+    GenerateElements (config, project, random);
+    return project;
+}
+
+std::string Describe (const Project& project)
+{
+    const std::uint32_t viewCount = project.CountViews ();
+    return std::to_string (viewCount) + " views (" + std::to_string (project.views.size () - viewCount - 1) + " folders), "
+        + std::to_string (project.layouts.size ()) + " layouts, "
+        + std::to_string (project.layers.size ()) + " layers (" + std::to_string (project.layerFolders.size () - 1) + " folders), "
+        + std::to_string (project.elements.size ()) + " elements";
+}
+
+} // namespace SyntheticProject
@@ -0,0 +1,95 @@
+#ifndef SYNTHETICPROJECT_HPP
+#define SYNTHETICPROJECT_HPP
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+// Синтетический проект Archicad для нагрузочных замеров: дерево View Map, макеты,
+// иерархия папок слоёв и элементы. Без зависимостей от DevKit — описание проекта
+// переводится в структуры API в ApiStandIn.cpp.
+//
+// Размеры по умолчанию — наш самый крупный рабочий проект; scale умножает все количества.
+namespace SyntheticProject {
+
+    struct Config {
+        double          scale = 1.0;
+        std::uint32_t   seed = 1;
+
+        // View Map
+        std::uint32_t   views = 8000;
+        std::uint32_t   viewsPerFolder = 20;        // среднее; число папок = views / viewsPerFolder
+        std::uint32_t   viewFolderDepth = 6;
+
+        // Макеты
+        std::uint32_t   layouts = 600;
+        std::uint32_t   layoutFolders = 40;
+        double          layoutsInFolders = 0.85;    // доля макетов с именем "Папка/Макет"
+        std::uint32_t   masterLayouts = 12;
+
+        // Слои
+        std::uint32_t   layers = 3000;
+        std::uint32_t   layersPerFolder = 12;
+        std::uint32_t   layerFolderDepth = 7;
+
+        // Элементы
+        std::uint32_t   elements = 200000;
+        std::uint32_t   stories = 12;
+        std::uint32_t   elementTypes = 20;
+        double          typeSkew = 1.2;             // показатель Ципфа для типов элементов
+        double          layerSkew = 1.0;            // показатель Ципфа для слоёв
+        std::uint32_t   distinctIds = 5000;         // число разных ID элементов
+        double          elementsWithId = 0.7;
+    };
+
+    // Типы узлов View Map (переводятся в API_NavigatorItemTypeID)
+    enum class ViewKind : std::uint8_t {
+        Root, Folder, Story, Section, Elevation, InteriorElevation, Detail, Worksheet, Document3D
+    };
+
+    struct ViewNode {
+        ViewKind                    kind = ViewKind::Folder;
+        std::string                 name;
+        std::vector<std::uint32_t>  children;
+    };
+
+    struct LayerFolder {
+        std::vector<std::string>    path;           // без корневой папки
+        std::vector<std::uint32_t>  subFolders;
+        std::vector<std::uint32_t>  layers;         // индексы в Project::layers
+    };
+
+    struct Layer {
+        std::string     name;
+        std::uint32_t   folder = 0;
+    };
+
+    struct Element {
+        std::uint16_t   type = 0;       // индекс типа (0 .. elementTypes-1)
+        std::uint32_t   layer = 0;      // индекс в Project::layers
+        std::int16_t    story = 0;
+        std::uint32_t   id = 0;         // 0 — без ID, иначе номер в distinctIds
+        double          area = 0.0;
+        double          volume = 0.0;
+    };
+
+    struct Project {
+        std::vector<ViewNode>       views;          // [0] — корень View Map
+        std::vector<std::string>    layouts;
+        std::vector<std::string>    masterLayouts;
+        std::vector<LayerFolder>    layerFolders;   // [0] — корневая папка слоёв
+        std::vector<Layer>          layers;
+        std::vector<std::string>    stories;
+        std::vector<Element>        elements;
+
+        std::uint32_t CountViews () const;
+    };
+
+    Project Generate (const Config& config);
+
+    // Строка вида "8000 views (400 folders), 600 layouts, ..." для вывода в консоль
+    std::string Describe (const Project& project);
+
+} // namespace SyntheticProject
+
+#endif // SYNTHETICPROJECT_HPP